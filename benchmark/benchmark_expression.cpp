@@ -0,0 +1,413 @@
+/***************************************************************************
+ *            benchmark_expression.cpp
+ *
+ *  Copyright  2023  Luca Geretti
+ *
+ ****************************************************************************/
+
+/*
+ * This file is part of SymboliCore, under the MIT license.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+/*! \file benchmark_expression.cpp
+ *  \brief Performance measurements of the expression subsystem, written as JSON.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <sstream>
+
+#if defined(_WIN32)
+#else
+#include <sys/resource.h>
+#endif
+
+#include "helper/container.hpp"
+#include "helper/string.hpp"
+#include "real.hpp"
+#include "vector.hpp"
+#include "expression.hpp"
+#include "assignment.hpp"
+#include "valuation.hpp"
+#include "space.hpp"
+#include "program.hpp"
+#include "allocation_counter.hpp"
+#include "indexed_name.hpp"
+
+using namespace SymboliCore;
+using namespace Helper;
+
+namespace {
+
+//! \brief The peak resident set size of the process in kilobytes, or zero if not available.
+size_t peak_rss_kb() {
+#if defined(_WIN32)
+    return 0u;
+#else
+    struct rusage usage;
+    getrusage(RUSAGE_SELF,&usage);
+#if defined(__APPLE__)
+    return static_cast<size_t>(usage.ru_maxrss)/1024u;
+#else
+    return static_cast<size_t>(usage.ru_maxrss);
+#endif
+#endif
+}
+
+/************ Generators ************************************************/
+
+//! \brief A benchmark input: an expression in the variables of a space, with the parameters used to generate it.
+struct Input {
+    String generator;
+    List<std::pair<String,size_t>> parameters;
+    RealSpace space;
+    RealExpression expression;
+};
+
+//! \brief A parametrised generator of expressions, which are reproducible for a given seed.
+struct Generator {
+    String name;
+    List<List<std::pair<String,size_t>>> sizes;
+    std::function<RealExpression(List<std::pair<String,size_t>> const&, RealSpace const&)> generate;
+};
+
+RealSpace make_space(size_t n) {
+    List<RealVariable> vars;
+    for (size_t i=0; i!=n; ++i) { vars.push_back(RealVariable(indexed_name("x",i))); }
+    return RealSpace(vars);
+}
+
+size_t parameter(List<std::pair<String,size_t>> const& parameters, String const& name) {
+    for (auto const& p : parameters) { if (p.first==name) { return p.second; } }
+    HELPER_FAIL_MSG("Missing benchmark parameter "<<name);
+}
+
+RealExpression variable(RealSpace const& spc, size_t i) { return RealExpression(spc.variable(i%spc.dimension())); }
+
+// A balanced sum, so that the depth is logarithmic in the number of terms
+RealExpression balanced_sum(List<RealExpression> const& terms, size_t begin, size_t end) {
+    if (end-begin==1u) { return terms[begin]; }
+    size_t const middle=begin+(end-begin)/2;
+    return balanced_sum(terms,begin,middle)+balanced_sum(terms,middle,end);
+}
+
+//! \brief A chain of mixed operations of the given \a depth, each using the previous one once.
+RealExpression deep_chain(List<std::pair<String,size_t>> const& parameters, RealSpace const& spc) {
+    size_t const depth=parameter(parameters,"depth");
+    RealExpression e=variable(spc,0u);
+    for (size_t i=0; i!=depth; ++i) {
+        switch (i%4u) {
+            case 0u: e=sin(e)*variable(spc,i+1u); break;
+            case 1u: e=e+variable(spc,i); break;
+            case 2u: e=hlf(e)-Real(0.25); break;
+            default: e=atan(e); break;
+        }
+    }
+    return e;
+}
+
+//! \brief A sum of \a width weighted variables.
+RealExpression wide_sum(List<std::pair<String,size_t>> const& parameters, RealSpace const& spc) {
+    size_t const width=parameter(parameters,"width");
+    List<RealExpression> terms;
+    for (size_t i=0; i!=width; ++i) { terms.push_back(Real(1.0+static_cast<double>(i%7u))*variable(spc,i)); }
+    return balanced_sum(terms,0u,terms.size());
+}
+
+//! \brief The sum of all the monomials in the variables up to the total \a degree, with integer powers.
+RealExpression polynomial(List<std::pair<String,size_t>> const& parameters, RealSpace const& spc) {
+    size_t const degree=parameter(parameters,"degree");
+    List<RealExpression> terms;
+    std::vector<size_t> exponents(spc.dimension(),0u);
+    // Enumerate the exponents in lexicographic order, skipping those above the total degree
+    while (true) {
+        size_t total=0u;
+        for (auto k : exponents) { total+=k; }
+        if (total<=degree) {
+            RealExpression term=Real(1.0+static_cast<double>(terms.size()%5u));
+            for (size_t j=0; j!=exponents.size(); ++j) {
+                if (exponents[j]==1u) { term=term*variable(spc,j); }
+                else if (exponents[j]>1u) { term=term*pow(variable(spc,j),static_cast<int>(exponents[j])); }
+            }
+            terms.push_back(term);
+        }
+        size_t j=0u;
+        while (j!=exponents.size() && exponents[j]==degree) { exponents[j]=0u; ++j; }
+        if (j==exponents.size()) { break; }
+        ++exponents[j];
+    }
+    return balanced_sum(terms,0u,terms.size());
+}
+
+//! \brief A random tree with \a leaves variables and constants, combined by arithmetic and transcendental operations.
+RealExpression transcendental_mix(List<std::pair<String,size_t>> const& parameters, RealSpace const& spc) {
+    size_t const leaves=parameter(parameters,"leaves");
+    std::mt19937 rng(static_cast<std::mt19937::result_type>(parameter(parameters,"seed")));
+    std::function<RealExpression(size_t)> tree=[&](size_t n) -> RealExpression {
+        if (n==1u) { return (rng()%4u==0u) ? RealExpression(Real(0.5+static_cast<double>(rng()%8u)/8)) : variable(spc,rng()); }
+        size_t const left=1u+rng()%(n-1u);
+        RealExpression e1=tree(left);
+        RealExpression e2=tree(n-left);
+        RealExpression e;
+        switch (rng()%4u) {
+            case 0u: e=e1+e2; break;
+            case 1u: e=e1*e2; break;
+            case 2u: e=e1-e2; break;
+            default: e=e1/(Real(2.0)+sqr(e2)); break;
+        }
+        switch (rng()%6u) {
+            case 0u: return sin(e);
+            case 1u: return cos(e);
+            case 2u: return exp(-sqr(e));
+            case 3u: return atan(e);
+            case 4u: return log(Real(1.0)+sqr(e));
+            default: return e;
+        }
+    };
+    return tree(leaves);
+}
+
+//! \brief A random directed acyclic graph of \a nodes operations, each using earlier nodes,
+//! whose expansion into a tree has at most \a expansion times the number of nodes.
+RealExpression random_dag(List<std::pair<String,size_t>> const& parameters, RealSpace const& spc) {
+    size_t const nodes=parameter(parameters,"nodes");
+    size_t const limit=nodes*parameter(parameters,"expansion");
+    std::mt19937 rng(static_cast<std::mt19937::result_type>(parameter(parameters,"seed")));
+    List<RealExpression> dag;
+    List<size_t> tree_sizes;
+    for (size_t i=0; i!=spc.dimension(); ++i) { dag.push_back(variable(spc,i)); tree_sizes.push_back(1u); }
+    auto pick=[&](size_t budget) {
+        for (size_t attempt=0; attempt!=8u; ++attempt) {
+            size_t const k=rng()%dag.size();
+            if (tree_sizes[k]<=budget) { return k; }
+        }
+        return static_cast<size_t>(rng()%spc.dimension());
+    };
+    for (size_t i=0; i!=nodes; ++i) {
+        size_t const budget=limit/2u;
+        size_t const k1=pick(budget);
+        size_t const k2=pick(budget);
+        RealExpression e;
+        switch (rng()%5u) {
+            case 0u: e=dag[k1]+dag[k2]; break;
+            case 1u: e=dag[k1]*dag[k2]; break;
+            case 2u: e=dag[k1]-dag[k2]; break;
+            case 3u: e=sin(dag[k1])+dag[k2]; break;
+            default: e=hlf(dag[k1]*dag[k2]); break;
+        }
+        dag.push_back(e);
+        tree_sizes.push_back(std::min(limit,tree_sizes[k1]+tree_sizes[k2]+2u));
+    }
+    return dag.back();
+}
+
+List<Generator> generators() {
+    return {
+        {"deep_chain",{{{"depth",100u}},{{"depth",1000u}},{{"depth",4000u}}},deep_chain},
+        {"wide_sum",{{{"width",100u}},{{"width",1000u}},{{"width",10000u}}},wide_sum},
+        {"polynomial",{{{"degree",4u}},{{"degree",8u}},{{"degree",12u}}},polynomial},
+        {"transcendental_mix",{{{"leaves",32u},{"seed",1u}},{{"leaves",256u},{"seed",2u}},{{"leaves",2048u},{"seed",3u}}},transcendental_mix},
+        {"random_dag",{{{"nodes",100u},{"expansion",16u},{"seed",1u}},{{"nodes",1000u},{"expansion",16u},{"seed",2u}},{{"nodes",5000u},{"expansion",16u},{"seed",3u}}},random_dag}
+    };
+}
+
+/************ Operations ************************************************/
+
+//! \brief An operation on an input, returning a value depending on its result so that it is not optimised away.
+struct Operation {
+    String name;
+    std::function<size_t(Input const&)> run;
+};
+
+size_t pointer_value(void const* p) { return reinterpret_cast<uintptr_t>(p)&0xFFu; }
+
+List<Operation> operations(Generator const& generator) {
+    return {
+        {"make_expression",[generator](Input const& in){ return pointer_value(generator.generate(in.parameters,in.space).node_raw_ptr()); }},
+        {"evaluate",[](Input const& in){
+            Valuation<Real> val;
+            for (size_t i=0; i!=in.space.dimension(); ++i) { val.insert(in.space.variable(i),Real(0.5+0.125*static_cast<double>(i))); }
+            return static_cast<size_t>(evaluate(in.expression,val).value()!=0.0); }},
+        {"derivative",[](Input const& in){ return pointer_value(derivative(in.expression,in.space.variable(0)).node_raw_ptr()); }},
+        {"substitute",[](Input const& in){
+            List<RealAssignment> asg={let(in.space.variable(0))=variable(in.space,1u)+Real(1.0)};
+            return pointer_value(substitute(in.expression,asg).node_raw_ptr()); }},
+        {"simplify",[](Input const& in){ return pointer_value(simplify(in.expression).node_raw_ptr()); }},
+        {"eliminate_common_subexpressions",[](Input const& in){
+            RealExpression e=in.expression;
+            eliminate_common_subexpressions(e);
+            return pointer_value(e.node_raw_ptr()); }},
+        {"write_prefix",[](Input const& in){
+            Expression<Real>::set_default_writer(Writer<Expression<Real>>(new PrefixExpressionWriter<Real>()));
+            std::ostringstream ss; ss << in.expression; return ss.str().size(); }},
+        {"write_infix",[](Input const& in){
+            Expression<Real>::set_default_writer(Writer<Expression<Real>>(new InfixExpressionWriter<Real>()));
+            std::ostringstream ss; ss << in.expression;
+            Expression<Real>::set_default_writer(Writer<Expression<Real>>(new PrefixExpressionWriter<Real>()));
+            return ss.str().size(); }},
+        {"register_program",[](Input const& in){
+            RegisterProgram p(Vector<RealExpression>({in.expression}),List<RealAssignment>(),in.space);
+            return p.number_of_instructions(); }}
+    };
+}
+
+/************ Measurement ************************************************/
+
+struct Settings {
+    double min_time=0.2;
+    double max_time=10.0;
+    bool quick=false;
+    String filter;
+    String output;
+};
+
+struct Measurement {
+    size_t repetitions;
+    double ns_per_operation;
+    double allocations_per_operation;
+    double bytes_per_operation;
+};
+
+//! \brief Repeat the operation, doubling the repetitions until the total time is at least \a min_time seconds.
+Measurement measure(Operation const& op, Input const& in, double min_time, size_t& sink) {
+    sink+=op.run(in);
+    size_t repetitions=1u;
+    while (true) {
+        size_t const count0=allocation_count(), bytes0=allocated_bytes();
+        auto const start=std::chrono::steady_clock::now();
+        for (size_t r=0; r!=repetitions; ++r) { sink+=op.run(in); }
+        auto const stop=std::chrono::steady_clock::now();
+        size_t const count1=allocation_count(), bytes1=allocated_bytes();
+        double const seconds=std::chrono::duration<double>(stop-start).count();
+        if (seconds>=min_time || repetitions>=(size_t(1u)<<30)) {
+            double const reps=static_cast<double>(repetitions);
+            return Measurement{repetitions,seconds*1e9/reps,static_cast<double>(count1-count0)/reps,static_cast<double>(bytes1-bytes0)/reps};
+        }
+        repetitions*=2u;
+    }
+}
+
+String json_string(String const& s) {
+    std::ostringstream ss;
+    ss << '"';
+    for (char c : s) {
+        if (c=='"' || c=='\\') { ss << '\\' << c; }
+        else if (static_cast<unsigned char>(c)<0x20u) { ss << "\\u00" << "0123456789abcdef"[(c>>4)&0xF] << "0123456789abcdef"[c&0xF]; }
+        else { ss << c; }
+    }
+    ss << '"';
+    return ss.str();
+}
+
+void print_usage(std::ostream& os) {
+    os << "Usage: benchmark_expression [--output FILE] [--min-time SECONDS] [--max-time SECONDS] [--quick] [--filter TEXT]\n"
+       << "  --output FILE       write the JSON results into FILE instead of the standard output\n"
+       << "  --min-time SECONDS  the minimum measured time of each case (default 0.2)\n"
+       << "  --max-time SECONDS  skip an operation on a larger size if one run is expected to take longer (default 10)\n"
+       << "  --quick             only use the smallest size of each generator\n"
+       << "  --filter TEXT       only run the cases whose generator or operation name contains TEXT\n";
+}
+
+} // namespace
+
+int main(int argc, const char* argv[]) {
+    Settings settings;
+    for (int i=1; i<argc; ++i) {
+        String arg=argv[i];
+        if (arg=="--output" && i+1<argc) { settings.output=argv[++i]; }
+        else if (arg=="--min-time" && i+1<argc) { settings.min_time=std::atof(argv[++i]); }
+        else if (arg=="--max-time" && i+1<argc) { settings.max_time=std::atof(argv[++i]); }
+        else if (arg=="--quick") { settings.quick=true; }
+        else if (arg=="--filter" && i+1<argc) { settings.filter=argv[++i]; }
+        else if (arg=="--help") { print_usage(std::cout); return 0; }
+        else { print_usage(std::cerr); return 1; }
+    }
+
+    std::ostringstream json;
+    json << "{\n  \"library\": \"SymboliCore\",\n  \"version\": " << json_string(SYMBOLICORE_VERSION)
+         << ",\n  \"timestamp\": " << static_cast<long long>(std::time(nullptr))
+         << ",\n  \"settings\": {\"min_time\": " << settings.min_time << ", \"max_time\": " << settings.max_time << ", \"quick\": " << (settings.quick ? "true" : "false")
+         << ", \"filter\": " << json_string(settings.filter) << "},\n  \"results\": [";
+
+    size_t sink=0u;
+    bool first=true;
+    for (auto const& generator : generators()) {
+        // The operations expected to be too slow on the next size, which are not run on it nor on larger ones.
+        // The expectation scales the time on the previous size by the square of the growth of the number of nodes,
+        // so that operations with superlinear complexity do not stall the suite.
+        std::vector<String> too_slow;
+        std::vector<std::pair<String,double>> previous_ns;
+        size_t previous_nodes=0u;
+        size_t const num_sizes=settings.quick ? 1u : generator.sizes.size();
+        for (size_t s=0; s!=num_sizes; ++s) {
+            auto const& parameters=generator.sizes[s];
+            RealSpace spc=make_space(3u);
+            Input in{generator.name,parameters,spc,generator.generate(parameters,spc)};
+            size_t const nodes=count_nodes(in.expression);
+            size_t const distinct_nodes=count_distinct_node_pointers(in.expression);
+            if (previous_nodes!=0u) {
+                double const growth=static_cast<double>(nodes)/static_cast<double>(previous_nodes);
+                for (auto const& [name,ns] : previous_ns) {
+                    if (ns*growth*growth>settings.max_time*1e9) { too_slow.push_back(name); }
+                }
+            }
+            previous_ns.clear();
+            previous_nodes=nodes;
+            for (auto const& op : operations(generator)) {
+                if (not settings.filter.empty() && generator.name.find(settings.filter)==String::npos && op.name.find(settings.filter)==String::npos) { continue; }
+                json << (first ? "\n" : ",\n") << "    {\"generator\": " << json_string(generator.name) << ", \"parameters\": {";
+                for (size_t k=0; k!=parameters.size(); ++k) { json << (k==0?"":", ") << json_string(parameters[k].first) << ": " << parameters[k].second; }
+                json << "}, \"operation\": " << json_string(op.name)
+                     << ", \"nodes\": " << nodes << ", \"distinct_nodes\": " << distinct_nodes;
+                first=false;
+                if (std::find(too_slow.begin(),too_slow.end(),op.name)!=too_slow.end()) {
+                    std::clog << generator.name << " " << parameters << " " << op.name << ": skipped" << std::endl;
+                    json << ", \"skipped\": true}";
+                    continue;
+                }
+                Measurement m=measure(op,in,settings.min_time,sink);
+                std::clog << generator.name << " " << parameters << " " << op.name << ": " << m.ns_per_operation << " ns" << std::endl;
+                previous_ns.emplace_back(op.name,m.ns_per_operation);
+                json << ", \"skipped\": false"
+                     << ", \"repetitions\": " << m.repetitions
+                     << ", \"ns_per_operation\": " << m.ns_per_operation
+                     << ", \"ns_per_node\": " << m.ns_per_operation/static_cast<double>(nodes)
+                     << ", \"allocations_per_operation\": " << m.allocations_per_operation
+                     << ", \"bytes_per_operation\": " << m.bytes_per_operation
+                     << ", \"peak_rss_kb\": " << peak_rss_kb() << "}";
+            }
+        }
+    }
+    json << "\n  ],\n  \"checksum\": " << sink << "\n}\n";
+
+    if (settings.output.empty()) {
+        std::cout << json.str();
+    } else {
+        std::ofstream file(settings.output);
+        file << json.str();
+        if (not file) { std::cerr << "Cannot write to " << settings.output << std::endl; return 1; }
+    }
+    return 0;
+}
@@ -139,7 +139,19 @@ template<class T> inline List<Assignment<DottedVariable<T>,Expression<T>>> Dotte
 
 //! \relates Assignment
 //! \brief Sort a list of assignments so that an assigned-to variable is only used after it is assigned.
+//! \details Takes time linear in the number of assignments and of the arguments of their right-hand sides.
+//! The relative order of the assignments is kept where the dependencies allow, so a sorted list is unchanged.
+//! Throws a \c std::runtime_error listing the algebraic loops, if there are any.
 List<RealAssignment> algebraic_sort(const List<RealAssignment>& assignments);
+//! \relates Assignment
+//! \brief The algebraic loops of a list of assignments, as the lists of variables forming the strongly connected
+//! components of the dependency graph which contain a cycle.
+List<List<RealVariable>> algebraic_loops(const List<RealAssignment>& assignments);
+//! \relates Assignment
+//! \brief Group the assignments into levels, each only using variables assigned in earlier levels,
+//! so that the assignments of a level can be evaluated in parallel.
+//! Throws a \c std::runtime_error listing the algebraic loops, if there are any.
+List<List<RealAssignment>> algebraic_levels(const List<RealAssignment>& assignments);
 
 }
 
@@ -0,0 +1,111 @@
+/***************************************************************************
+ *            codegen.hpp
+ *
+ *  Copyright  2023  Luca Geretti
+ *
+ ****************************************************************************/
+
+/*
+ * This file is part of SymboliCore, under the MIT license.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*! \file codegen.hpp
+ *  \brief Generation of native code for expressions.
+ */
+
+#ifndef SYMBOLICORE_CODEGEN_HPP
+#define SYMBOLICORE_CODEGEN_HPP
+
+#include <memory>
+
+#include "helper/string.hpp"
+#include "real.hpp"
+#include "vector.hpp"
+#include "expression.hpp"
+#include "space.hpp"
+#include "valuation.hpp"
+
+namespace SymboliCore {
+
+using Helper::String;
+using std::shared_ptr;
+
+//! \brief Write C source code for a function <tt>void name(const double* x, double* y)</tt> computing \a y=\a e(\a x),
+//! where the entries of \a x are the values of the variables of \a spc in order.
+//! \details Subexpressions which are identical are computed only once, and stored in temporary variables.
+String c_source(Vector<Expression<Real>> const& e, RealSpace const& spc, String const& name="f");
+//! \brief Write C source code for a function <tt>void name(const double* x, double* y)</tt> computing \a y[0]=\a e(\a x).
+String c_source(Expression<Real> const& e, RealSpace const& spc, String const& name="f");
+
+//! \brief Settings for compiling generated source code into a shared library.
+struct CompilerSettings {
+    //! \brief The compiler command; defaults to the value of the \c CC environment variable, or \c cc if not set.
+    String compiler;
+    //! \brief The flags passed to the compiler; floating-point contraction is disabled so that results match library evaluation.
+    String flags;
+    //! \brief The directory holding generated sources and libraries, which are reused if already present.
+    //! Defaults to the value of the \c SYMBOLICORE_CODEGEN_CACHE environment variable, or else to a \c symbolicore-codegen
+    //! directory under \c XDG_CACHE_HOME, under \c HOME/.cache, or suffixed with the user id in the system temporary path.
+    //! It is created accessible by the current user only, and must be owned by that user and not writable by others.
+    String cache_directory;
+    //! \brief The default settings.
+    static CompilerSettings default_settings();
+};
+
+//! \brief A function \f$\R^n\to\R^m\f$ compiled to native code and loaded at runtime.
+//! \see compile
+class CompiledFunction {
+  public:
+    //! \brief The type of the native kernel.
+    typedef void (*KernelType)(const double*, double*);
+  public:
+    CompiledFunction(shared_ptr<void> lib, KernelType knl, RealSpace const& spc, size_t rs);
+    //! \brief The space of the arguments.
+    RealSpace const& argument_space() const { return _argument_space; }
+    //! \brief The number of arguments.
+    size_t argument_size() const { return _argument_space.dimension(); }
+    //! \brief The number of results.
+    size_t result_size() const { return _result_size; }
+    //! \brief The native kernel.
+    KernelType kernel() const { return _kernel; }
+    //! \brief Evaluate on the raw array \a x, writing the results into \a y.
+    void operator()(const double* x, double* y) const { _kernel(x,y); }
+    //! \brief Evaluate on the vector \a x of values ordered as the argument space.
+    Vector<Real> operator()(Vector<Real> const& x) const;
+    //! \brief Evaluate the function \a f on the valuation \a x.
+    friend Vector<Real> evaluate(CompiledFunction const& f, Valuation<Real> const& x);
+  private:
+    shared_ptr<void> _library;
+    KernelType _kernel;
+    RealSpace _argument_space;
+    size_t _result_size;
+};
+
+//! \brief Compile the expressions \a e in the variables \a spc to native code and load the result.
+//! \details The generated library is cached under a hash of the source and of the compiler command, next to
+//! the source itself, so that compiling the same expressions again only loads the existing library. The stored
+//! source is compared before reuse: on a mismatch the library is compiled again and loaded privately.
+CompiledFunction compile(Vector<Expression<Real>> const& e, RealSpace const& spc, CompilerSettings const& settings=CompilerSettings::default_settings());
+//! \brief Compile the expression \a e in the variables \a spc to native code and load the result.
+CompiledFunction compile(Expression<Real> const& e, RealSpace const& spc, CompilerSettings const& settings=CompilerSettings::default_settings());
+
+} // namespace SymboliCore
+
+#endif /* SYMBOLICORE_CODEGEN_HPP */
@@ -0,0 +1,98 @@
+/***************************************************************************
+ *            contractor.hpp
+ *
+ *  Copyright  2023  Luca Geretti
+ *
+ ****************************************************************************/
+
+/*
+ * This file is part of SymboliCore, under the MIT license.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*! \file contractor.hpp
+ *  \brief Contraction of boxes by constraints.
+ */
+
+#ifndef SYMBOLICORE_CONTRACTOR_HPP
+#define SYMBOLICORE_CONTRACTOR_HPP
+
+#include <map>
+
+#include "helper/container.hpp"
+#include "interval.hpp"
+#include "variables_box.hpp"
+#include "expression.hpp"
+
+namespace SymboliCore {
+
+using Helper::List;
+
+//! \brief A forward/backward contractor for a conjunction of comparisons of real expressions.
+//! \details The constraints are the comparisons \a e1≤e2, \a e1<e2, \a e1=e2 (and their reverses) and \a sgn(e),
+//! possibly negated, found by splitting the predicate over its conjunctions.
+//! Other subpredicates, such as disjunctions, are not used for contraction.
+//!
+//! Contracting a box first evaluates each constraint forward over its expression DAG,
+//! then restricts the result by the comparison and propagates it backward to the variables.
+//! A constraint is revised again whenever one of its variables has been reduced by at least a given ratio,
+//! until no more reductions occur. The strict comparisons are contracted as the corresponding non-strict ones.
+//! \see evaluate(Expression<Kleenean> const&, RealVariablesBox const&)
+class Contractor {
+  public:
+    //! \brief Construct a contractor for the predicate \a p.
+    //! \details A constraint is revised again when the width of one of its variables reduces by at least \a ratio,
+    //! which must be positive.
+    Contractor(Expression<Kleenean> const& p, double ratio=0.01);
+    //! \brief Construct a contractor for the conjunction of the predicates \a ps.
+    Contractor(List<Expression<Kleenean>> const& ps, double ratio=0.01);
+
+    //! \brief The number of comparisons used for contraction.
+    size_t number_of_constraints() const { return _constraints.size(); }
+    //! \brief The variables occurring in the constraints.
+    List<Identifier> const& variables() const { return _variables; }
+
+    //! \brief Contract the box \a bx, keeping all its points which can satisfy the constraints.
+    //! \details All intervals of the result are empty if no point of \a bx can satisfy the constraints.
+    //! Every variable of the constraints must be in the box; variables not in the constraints are unchanged.
+    RealVariablesBox contract(RealVariablesBox const& bx) const;
+    //! \brief Shorthand for contract().
+    RealVariablesBox operator()(RealVariablesBox const& bx) const { return this->contract(bx); }
+  private:
+    struct Node { OperatorCode code; OperatorKind kind; size_t arg1; size_t arg2; int num; RealInterval value; };
+    struct Constraint { OperatorCode code; size_t arg1; size_t arg2; List<size_t> nodes; List<size_t> variables; };
+    void _adjoin(Expression<Kleenean> const& p, bool negated);
+    size_t _record(Expression<Real> const& e, Constraint& c, std::map<void const*,size_t>& recorded);
+    bool _revise(Constraint const& c, List<RealInterval>& domains, List<RealInterval>& values) const;
+  private:
+    double _ratio;
+    List<Node> _nodes;
+    List<Constraint> _constraints;
+    List<Identifier> _variables;
+    List<List<size_t>> _variable_constraints;
+    std::map<void const*,size_t> _node_indices;
+};
+
+//! \brief Contract the box \a bx by the constraints in the predicate \a p.
+//! \see Contractor
+RealVariablesBox contract(Expression<Kleenean> const& p, RealVariablesBox const& bx);
+
+} // namespace SymboliCore
+
+#endif /* SYMBOLICORE_CONTRACTOR_HPP */
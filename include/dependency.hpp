@@ -0,0 +1,105 @@
+/***************************************************************************
+ *            dependency.hpp
+ *
+ *  Copyright  2023  Luca Geretti
+ *
+ ****************************************************************************/
+
+/*
+ * This file is part of SymboliCore, under the MIT license.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*! \file dependency.hpp
+ *  \brief Sparsity patterns of the dependencies of expressions on variables.
+ */
+
+#ifndef SYMBOLICORE_DEPENDENCY_HPP
+#define SYMBOLICORE_DEPENDENCY_HPP
+
+#include <iosfwd>
+#include <span>
+#include <vector>
+
+#include "helper/macros.hpp"
+#include "helper/container.hpp"
+#include "real.hpp"
+#include "expression.decl.hpp"
+
+namespace SymboliCore {
+
+using Helper::List;
+
+//! \ingroup SymbolicModule
+//! \brief A sparse boolean matrix in compressed row storage, whose entry \a (i,j) is \a true
+//! if output \a i depends on the variable \a j of a space.
+//! \details The columns of the nonzero entries of each row are held in increasing order.
+//! \see dependency_pattern
+class DependencyPattern
+{
+    size_t _cs;
+    std::vector<size_t> _offsets;
+    std::vector<size_t> _columns;
+  public:
+    //! \brief Construct a pattern with \a rs rows and \a cs columns and no nonzero entries.
+    DependencyPattern(size_t rs, size_t cs);
+    //! \brief Construct from the compressed row storage: row \a i has nonzero entries in the columns
+    //! <c>columns[offsets[i]:offsets[i+1]]</c>, which must be increasing.
+    DependencyPattern(size_t cs, std::vector<size_t> offsets, std::vector<size_t> columns);
+
+    //! \brief The number of rows, i.e. of outputs.
+    size_t row_size() const { return _offsets.size()-1u; }
+    //! \brief The number of columns, i.e. of variables.
+    size_t column_size() const { return _cs; }
+    //! \brief The number of nonzero entries.
+    size_t number_of_nonzeros() const { return _columns.size(); }
+    //! \brief Whether output \a i depends on variable \a j, in logarithmic time.
+    bool get(size_t i, size_t j) const;
+    //! \brief The columns of the nonzero entries of row \a i, in increasing order.
+    std::span<const size_t> row(size_t i) const {
+        return std::span<const size_t>(_columns.data()+_offsets[i],_offsets[i+1]-_offsets[i]); }
+    //! \brief The offsets of the rows into the columns; has one more element than the number of rows.
+    std::vector<size_t> const& offsets() const { return _offsets; }
+    //! \brief The columns of the nonzero entries, row by row.
+    std::vector<size_t> const& columns() const { return _columns; }
+    //! \brief The transpose pattern, giving for each variable the outputs depending on it.
+    DependencyPattern transpose() const;
+
+    friend bool operator==(DependencyPattern const& p1, DependencyPattern const& p2);
+    friend ostream& operator<<(ostream& os, DependencyPattern const& p);
+};
+
+//! \relates DependencyPattern
+//! \brief The dependencies of the components of \a f on the variables of \a spc.
+//! \details Built from the arguments cached in the expression nodes, in time linear in the size of the pattern.
+//! Variables not in \a spc are ignored.
+DependencyPattern dependency_pattern(Vector<Expression<Real>> const& f, RealSpace const& spc);
+//! \relates DependencyPattern
+//! \brief The dependencies of the variables assigned by \a asg on the variables of \a spc, taken transitively
+//! through the assignments, with one row for each assignment.
+//! \details The assignments need not be sorted. A variable assigned to in \a asg is substituted by its assignment
+//! even if it is also a variable of \a spc. Throws a \c std::runtime_error if the assignments contain an algebraic loop.
+DependencyPattern dependency_pattern(List<RealAssignment> const& asg, RealSpace const& spc);
+//! \relates DependencyPattern
+//! \brief The dependencies of the components of \a f on the variables of \a spc, taken transitively through the assignments \a asg.
+DependencyPattern dependency_pattern(Vector<Expression<Real>> const& f, List<RealAssignment> const& asg, RealSpace const& spc);
+
+} // namespace SymboliCore
+
+#endif // SYMBOLICORE_DEPENDENCY_HPP
@@ -139,6 +139,7 @@ using RealConstantAssignment = Assignment<RealVariable,Real>; //!< <p/>
 typedef Space<Real> RealSpace;
 
 template<class T, class X=T> class Valuation;
+template<class T, class X=T> class ValuationView;
 //!@{
 //! \relates Valuation
 //! \name Type synonyms
@@ -125,6 +125,7 @@ class Expression
     const Expression<T>& arg2() const;
     template<class A> const Expression<A>& cmp1(A* dummy=0) const;
     template<class A> const Expression<A>& cmp2(A* dummy=0) const;
+    template<class A> const Expression<A>& cmp(A* dummy=0) const;
     //! \brief Write to an output stream.
     friend ostream& operator<<(ostream& os, Expression<T> const& e) { return e._write(os); }
     //! \brief A writer for Expression objects using prefix notation.
@@ -134,6 +135,8 @@ class Expression
   public:
     //! \brief The variables needed to compute the expression.
     Set<UntypedVariable> arguments() const;
+    //! \brief The variables needed to compute the expression, as cached in the root node.
+    ArgumentSet const& argument_set() const;
   public:
     shared_ptr<const ExpressionNode<T>> node_ptr() const { return _root; }
     const ExpressionNode<T>* node_raw_ptr() const { return _root.operator->(); }
@@ -160,6 +163,20 @@ Boolean evaluate(const Expression<Boolean>& e, const DiscreteValuation& q);
 template<class X> X evaluate(const Expression<Real>& e, const ContinuousValuation<X>&);
 template<class X> Kleenean evaluate(const Expression<Kleenean>&, const ContinuousValuation<X>&);
 
+//! \brief Check the predicate \a p on the valuation \a x, computing the logical value directly.
+//! \details Unlike evaluate(), no intermediate Kleenean objects are built, so that no memory is allocated.
+//! Conjunctions and disjunctions are short-circuited.
+LogicalValue check(const Expression<Kleenean>& p, const Valuation<Real>& x);
+//! \brief Check the predicate \a p on the values \a x of the variables of the space \a spc, in order.
+LogicalValue check(const Expression<Kleenean>& p, const Vector<Real>& x, const RealSpace& spc);
+//! \brief Check the predicate \a p on the values viewed by \a x, without copying them.
+LogicalValue check(const Expression<Kleenean>& p, const ValuationView<Real>& x);
+
+//! \brief Evaluate the expression \a e on the values viewed by \a x, without copying them.
+Real evaluate(const Expression<Real>& e, const ValuationView<Real>& x);
+//! \brief Evaluate the expression \a e on the raw values viewed by \a x, without copying them.
+Real evaluate(const Expression<Real>& e, const ValuationView<Real,double>& x);
+
 //! \brief Extract the arguments of expression \a e.
 template<class T> Set<Identifier> arguments(const Expression<T>& e);
 
@@ -198,6 +215,15 @@ template<class T> bool is_variable(const Expression<T>& e, const Variable<T>& v)
 
 //! \brief Returns \a true if the expression \a e is syntactically constant in the variables \a vs.
 template<class T> bool is_constant_in(const Expression<T>& e, const Set<Variable<T>>& vs);
+//! \brief Returns \a true if the variable \a v occurs in the expression \a e, using the arguments cached in its nodes.
+template<class T> bool depends_on(const Expression<T>& e, const UntypedVariable& v) {
+    return e.argument_set().contains(v); }
+//! \brief Returns \a true if any of the variables \a vs occurs in the expression \a e.
+template<class T, class Y> bool depends_on(const Expression<T>& e, const Set<Variable<Y>>& vs) {
+    ArgumentSet const& as=e.argument_set();
+    if(as.empty()) { return false; }
+    for(auto const& v : vs) { if(as.contains(v)) { return true; } }
+    return false; }
 //! \brief Returns \a true if the expression \a e is syntactically affine in the variables \a vs.
 bool is_affine_in(const Expression<Real>& e, const Set<Variable<Real>>& vs);
 //! \brief Returns \a true if the vector expression \a e is syntactically affine in the variables \a vs.
@@ -132,9 +132,12 @@ template<class T, class VAR> constexpr decltype(auto) variant_index_of() { retur
 template<class T> struct ExpressionNode : public ExpressionVariantType<T> {
   public:
     template<class... AS> requires Constructible<ExpressionVariantType<T>,AS...>
-        ExpressionNode(AS... as) : ExpressionVariantType<T>(as...) { }
+        ExpressionNode(AS... as) : ExpressionVariantType<T>(as...)
+        , _arguments(this->accept([](auto const& s){return _argument_set(s);})) { }
 
     ExpressionVariantType<T> const& base() const { return *this; }
+    //! \brief The variables of the expression, computed once when the node is constructed.
+    ArgumentSet const& arguments() const { return _arguments; }
 
     template<class VIS> decltype(auto) accept(VIS&& vis) const {
         return std::visit(std::forward<VIS>(vis),static_cast<ExpressionVariantType<T>const&>(*this)); }
@@ -142,6 +145,8 @@ template<class T> struct ExpressionNode : public ExpressionVariantType<T> {
     template<class EN> static constexpr decltype(auto) index_of() {
         return variant_index_of<EN,ExpressionVariantType<T>>(); }
     Operator op() const { return this->accept([](auto s){return Operator(_op_impl(s));}); }
+  private:
+    ArgumentSet _arguments;
 };
 
 template<class T> inline ostream& operator<<(ostream& os, const ExpressionNode<T>* e) {
@@ -172,11 +177,11 @@ template<class T> Expression<T> Expression<T>::variable(const Identifier& v) {
     return Expression<T>(Variable<T>(v)); }
 
 template<class T> Operator Expression<T>::op() const {
-    return this->node_ptr()->op(); }
+    return this->node_ref().op(); }
 template<class T> OperatorCode Expression<T>::code() const {
-    return node_ptr()->op().code(); }
+    return node_ref().op().code(); }
 template<class T> OperatorKind Expression<T>::kind() const {
-    return node_ptr()->op().kind(); }
+    return node_ref().op().kind(); }
 template<class T> const T& Expression<T>::val() const {
     return std::get<Constant<T>>(node_ref()).value(); }
 template<class T> const Identifier& Expression<T>::var() const {
@@ -194,10 +199,16 @@ template<class R> template<class A> const Expression<A>& Expression<R>::cmp1(A*)
     return std::get<Symbolic<OperatorType<R(A,A)>,Expression<A>,Expression<A>>>(node_ref())._arg1; }
 template<class R> template<class A> const Expression<A>& Expression<R>::cmp2(A*) const {
     return std::get<Symbolic<OperatorType<R(A,A)>,Expression<A>,Expression<A>>>(node_ref())._arg2; }
+template<class R> template<class A> const Expression<A>& Expression<R>::cmp(A*) const {
+    return std::get<Symbolic<OperatorType<R(A)>,Expression<A>>>(node_ref())._arg; }
 
 
 template<class T> Set<UntypedVariable> Expression<T>::arguments() const {
-    return this->node_ref().accept([](auto s){return _arguments(s);});
+    return this->node_ref().arguments().variables();
+}
+
+template<class T> ArgumentSet const& Expression<T>::argument_set() const {
+    return this->node_ref().arguments();
 }
 
 template<class T> ostream& Expression<T>::_write(ostream& os) const {
@@ -279,6 +290,7 @@ template<class T> Set<Identifier> arguments(const Expression<T>& e) {
 
 
 template<class T> bool is_constant_in(const Expression<T>& e, const Set<Variable<T>>& spc) {
+    if(not depends_on(e,spc)) { return true; }
     return e.node_ref().accept([&spc](auto en){return is_constant_in(en,spc);});
 }
 
@@ -297,6 +309,7 @@ template<class X, class Y, class OP, class E> Expression<X> _substitute(const Sy
 }
 
 template<class X, class Y> Expression<X> substitute(const Expression<X>& e, const Variable<Y>& v, const Expression<Y>& s) {
+    if(not depends_on(e,v)) { return e; }
     return e.node_ref().accept([&v,&s](auto en){return _substitute<X>(en,v,s);});
 }
 
@@ -484,12 +497,12 @@ template<class T, class CMP, bool distinct> class NodeCounter {
 };
 
 template<class T, class CMP, bool distinct> auto NodeCounter<T,CMP,distinct>::count_nodes(Expression<T> const& e) -> size_t {
-    auto iter=cache.find(e);
-    if (!distinct || iter==cache.end()) {
-        cache.insert(e);
-        e.node_ref().accept(*this);
-        count++;
+    // Counting all the nodes needs no cache, whose structural comparisons would dominate the cost
+    if constexpr (distinct) {
+        if (not cache.insert(e).second) { return count; }
     }
+    e.node_ref().accept(*this);
+    count++;
     return count;
 }
 
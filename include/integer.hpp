@@ -33,7 +33,10 @@
 #ifndef SYMBOLICORE_INTEGER_HPP
 #define SYMBOLICORE_INTEGER_HPP
 
+#include <utility>
+
 #include "helper/metaprogramming.hpp"
+#include "helper/macros.hpp"
 #include "sign.hpp"
 #include "logical.hpp"
 
@@ -54,25 +57,40 @@ template<> struct IsNumber<Integer> : True { };
 template<> struct IsNumber<unsigned int> : True { };
 template<> struct IsNumber<int> : True { };
 
+namespace Detail { struct IntegerLimbs; }
+
+//! \brief An arbitrary-precision integer.
+//! \details Values fitting in a <code>long int</code> are held inline, and arithmetic on them checks for overflow
+//! with the builtin overflow intrinsics. Only values outside this range allocate a sign-magnitude array of limbs.
 class Integer
 {
+    friend struct Detail::IntegerLimbs;
   private:
     long int _value;
+    Detail::IntegerLimbs* _limbs;
+    void _set(unsigned long long int val);
+    bool _get_unsigned(unsigned long long int& val) const;
+    static Detail::IntegerLimbs* _copy(Detail::IntegerLimbs const* limbs);
+    static void _destroy(Detail::IntegerLimbs* limbs);
   public:
     typedef ExactTag Paradigm; //!< <p/>
   public:
     Integer(); //!< Default constructor yielding \c 0
     explicit Integer(String const&); //!< Construct from a string literal
-    Integer(unsigned int val) : _value(static_cast<long int>(val)) { }
-    Integer(int val) : _value(static_cast<long int>(val)) { }
-    Integer(unsigned long int val) : _value(static_cast<long int>(val)) { }
-    Integer(long int val) : _value(static_cast<long int>(val)) { }
-    Integer(long long int val) : _value(static_cast<long int>(val)) { }
-    Integer(unsigned long long int val) : _value(static_cast<long int>(val)) { }
-    Integer(const Integer&); //!< Copy constructor
+    Integer(unsigned int val) : _value(static_cast<long int>(val)), _limbs(nullptr) { }
+    Integer(int val) : _value(static_cast<long int>(val)), _limbs(nullptr) { }
+    Integer(unsigned long int val) : _value(0), _limbs(nullptr) { _set(val); }
+    Integer(long int val) : _value(static_cast<long int>(val)), _limbs(nullptr) { }
+    Integer(long long int val) : _value(static_cast<long int>(val)), _limbs(nullptr) { }
+    Integer(unsigned long long int val) : _value(0), _limbs(nullptr) { _set(val); }
+    Integer(const Integer& z) : _value(z._value), _limbs(z._limbs ? _copy(z._limbs) : nullptr) { } //!< Copy constructor
+    Integer(Integer&& z) noexcept : _value(z._value), _limbs(z._limbs) { z._limbs=nullptr; } //!< Move constructor
+    ~Integer() { if (_limbs) { _destroy(_limbs); } }
     Integer& operator=(const Integer&); //!< %Assignment
+    Integer& operator=(Integer&& z) noexcept { std::swap(_value,z._value); std::swap(_limbs,z._limbs); return *this; } //!< Move assignment
     String literal() const; //!< A string literal
-    long int const& value() const; //!< Builtin value
+    long int const& value() const; //!< Builtin value. Throws if the value does not fit in a <code>long int</code>.
+    double get_d() const; //!< The nearest double-precision value.
 
     //!@{
     //! \name Arithmetic operators
@@ -152,6 +170,15 @@ class Integer
 };
 
 template<BuiltinIntegral N> inline N Integer::get() const {
+    if (_limbs) {
+        unsigned long long int m=0u;
+        bool const fits=_get_unsigned(m);
+        N n=static_cast<N>(m);
+        if (not fits or not (n>0 and static_cast<unsigned long long int>(n)==m)) {
+            HELPER_THROW(std::runtime_error,"Integer::get<N>()","Integer "<<*this<<" does not fit in the requested builtin integral type");
+        }
+        return n;
+    }
     N n=static_cast<N>(_value); HELPER_ASSERT(Integer(n)==*this); return n; }
 
 template<class R, class A> R integer_cast(const A& a) {
@@ -0,0 +1,184 @@
+/***************************************************************************
+ *            integrator.hpp
+ *
+ *  Copyright  2023  Luca Geretti
+ *
+ ****************************************************************************/
+
+/*
+ * This file is part of SymboliCore, under the MIT license.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+/*! \file integrator.hpp
+ *  \brief Explicit Runge-Kutta integrators for ordinary differential equations.
+ */
+
+#ifndef SYMBOLICORE_INTEGRATOR_HPP
+#define SYMBOLICORE_INTEGRATOR_HPP
+
+#include <functional>
+#include <limits>
+#include <vector>
+
+#include "real.hpp"
+#include "vector.hpp"
+#include "assignment.hpp"
+#include "space.hpp"
+#include "vector_field.hpp"
+
+namespace SymboliCore {
+
+//! \brief The outcome of a single step of an integrator.
+struct StepStatistics {
+    double time; //!< \brief The time at the start of the step.
+    double step_size; //!< \brief The size of the step attempted.
+    double error; //!< \brief The scaled error estimate, which is at most one for an accepted step; zero for fixed-step methods.
+    bool accepted; //!< \brief Whether the step was accepted.
+};
+ostream& operator<<(ostream& os, StepStatistics const& s);
+
+//! \brief The statistics accumulated by an integrator since construction or the last reset.
+struct IntegrationStatistics {
+    size_t accepted_steps=0u; //!< \brief The number of accepted steps.
+    size_t rejected_steps=0u; //!< \brief The number of rejected steps.
+    size_t function_evaluations=0u; //!< \brief The number of evaluations of the vector field, where a batch evaluation counts once.
+    double minimum_step_size=std::numeric_limits<double>::infinity(); //!< \brief The smallest accepted step size.
+    double maximum_step_size=0.0; //!< \brief The largest accepted step size.
+};
+ostream& operator<<(ostream& os, IntegrationStatistics const& s);
+
+//! \brief A function called after each step attempted by an integration.
+typedef std::function<void(StepStatistics const&)> StepObserver;
+
+//! \brief Settings for the step size control of an adaptive integrator.
+struct IntegratorSettings {
+    double relative_tolerance; //!< \brief The tolerance on the local error relative to the size of the state.
+    double absolute_tolerance; //!< \brief The tolerance on the local error of a state component close to zero.
+    double initial_step_size; //!< \brief The size of the first step; if zero, it is estimated from the vector field.
+    double minimum_step_size; //!< \brief The size below which integration fails; it also fails if a step does not advance the time.
+    double maximum_step_size; //!< \brief The largest step size allowed.
+    size_t maximum_steps; //!< \brief The number of attempted steps after which an integration fails.
+    //! \brief The default settings.
+    static IntegratorSettings default_settings();
+};
+
+//! \brief The classical fourth-order Runge-Kutta method with fixed step size.
+//! \details The stage buffers are held by the integrator and grow only when a larger batch is seen,
+//! so that steps do not allocate. An integrator must hence not be shared between threads.
+//! The batch functions advance the states stored consecutively, evaluating the stages on blocks of states at a time.
+class RungeKutta4Integrator {
+  public:
+    //! \brief Integrate the vector field \a vf.
+    RungeKutta4Integrator(VectorField const& vf);
+    //! \brief Integrate the differential equations \a dynamics over the state space \a spc.
+    RungeKutta4Integrator(DottedRealAssignments const& dynamics, RealSpace const& spc);
+
+    //! \brief The vector field.
+    VectorField const& vector_field() const { return _vf; }
+    //! \brief The dimension of the state space.
+    size_t dimension() const { return _vf.dimension(); }
+    //! \brief The statistics since construction or the last reset.
+    IntegrationStatistics const& statistics() const { return _statistics; }
+    //! \brief Reset the statistics.
+    void reset_statistics() { _statistics=IntegrationStatistics(); }
+
+    //! \brief Advance the state \a x at time \a t by a step of size \a h.
+    StepStatistics step(double t, double* x, double h);
+    //! \brief Advance the state \a x from time \a t0 to \a t1, using equal steps of size at most \a h.
+    void integrate(double* x, double t0, double t1, double h, StepObserver const& observer=StepObserver());
+    //! \brief The state at time \a t1 of the solution starting at \a x0 at time \a t0, using steps of size at most \a h.
+    Vector<Real> integrate(Vector<Real> const& x0, double t0, double t1, double h);
+
+    //! \brief Advance the \a count states in \a x by a step of size \a h.
+    StepStatistics step(size_t count, double t, double* x, double h);
+    //! \brief Advance the \a count states in \a x from time \a t0 to \a t1, using equal steps of size at most \a h.
+    void integrate(size_t count, double* x, double t0, double t1, double h, StepObserver const& observer=StepObserver());
+  private:
+    void _evaluate(size_t count, const double* x, double* f);
+  private:
+    VectorField _vf;
+    IntegrationStatistics _statistics;
+    std::vector<double> _k1, _k2, _k3, _k4, _y, _w;
+};
+
+//! \brief The Dormand-Prince method of order 5(4) with adaptive step size and dense output of order 4.
+//! \details The last stage of an accepted step is reused as the first stage of the next one.
+//! The error is measured in the root-mean-square norm scaled by the tolerances. In batch mode, all the states
+//! share the step size, which is controlled by the largest scaled error among them.
+//! As for RungeKutta4Integrator, the stage buffers are held by the integrator, so that steps do not allocate.
+class DormandPrinceIntegrator {
+  public:
+    //! \brief Integrate the vector field \a vf.
+    DormandPrinceIntegrator(VectorField const& vf, IntegratorSettings const& settings=IntegratorSettings::default_settings());
+    //! \brief Integrate the differential equations \a dynamics over the state space \a spc.
+    DormandPrinceIntegrator(DottedRealAssignments const& dynamics, RealSpace const& spc, IntegratorSettings const& settings=IntegratorSettings::default_settings());
+
+    //! \brief The vector field.
+    VectorField const& vector_field() const { return _vf; }
+    //! \brief The dimension of the state space.
+    size_t dimension() const { return _vf.dimension(); }
+    //! \brief The settings.
+    IntegratorSettings const& settings() const { return _settings; }
+    //! \brief The statistics since construction or the last reset.
+    IntegrationStatistics const& statistics() const { return _statistics; }
+    //! \brief Reset the statistics.
+    void reset_statistics() { _statistics=IntegrationStatistics(); }
+
+    //! \brief Attempt a step of size \a h from the state \a x at time \a t.
+    //! \details If the step is accepted, \a x and \a t are advanced. In both cases \a h is set to the proposed size of the next step.
+    StepStatistics step(double& t, double* x, double& h);
+    //! \brief Advance the state \a x from time \a t0 to \a t1.
+    //! \details Throws a \c std::runtime_error if the step size falls below the minimum or the number of steps exceeds the maximum.
+    void integrate(double* x, double t0, double t1, StepObserver const& observer=StepObserver());
+    //! \brief Advance the state \a x from time \a t0 through the increasing \a times, writing the state at each of them consecutively into \a y by dense output.
+    void integrate(double* x, double t0, List<double> const& times, double* y);
+    //! \brief The state at time \a t1 of the solution starting at \a x0 at time \a t0.
+    Vector<Real> integrate(Vector<Real> const& x0, double t0, double t1);
+
+    //! \brief The start time of the last accepted step.
+    double dense_output_begin() const { return _t_old; }
+    //! \brief The end time of the last accepted step.
+    double dense_output_end() const { return _t_old+_h_old; }
+    //! \brief Write the interpolated values at time \a t within the last accepted step of each of the states advanced by it into \a y.
+    void dense_output(double t, double* y) const;
+
+    //! \brief Attempt a common step of size \a h from the \a count states in \a x at time \a t, as for a single state.
+    StepStatistics step(size_t count, double& t, double* x, double& h);
+    //! \brief Advance the \a count states in \a x from time \a t0 to \a t1 with common steps.
+    void integrate(size_t count, double* x, double t0, double t1, StepObserver const& observer=StepObserver());
+  private:
+    void _evaluate(size_t count, const double* x, double* f);
+    void _reserve(size_t size);
+    double _initial_step_size(size_t count, double t0, double t1, const double* x);
+    void _start(size_t count, double t0, const double* x);
+  private:
+    VectorField _vf;
+    IntegratorSettings _settings;
+    IntegrationStatistics _statistics;
+    std::vector<double> _k1, _k2, _k3, _k4, _k5, _k6, _k7, _y, _w;
+    std::vector<double> _r1, _r2, _r3, _r4, _r5;
+    size_t _count;
+    double _t_old, _h_old;
+    bool _first_same_as_last;
+    double _facmax;
+};
+
+} // namespace SymboliCore
+
+#endif /* SYMBOLICORE_INTEGRATOR_HPP */
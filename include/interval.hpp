@@ -0,0 +1,153 @@
+/***************************************************************************
+ *            interval.hpp
+ *
+ *  Copyright  2023  Luca Geretti
+ *
+ ****************************************************************************/
+
+/*
+ * This file is part of SymboliCore, under the MIT license.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*! \file interval.hpp
+ *  \brief Intervals with outward-rounded arithmetic.
+ */
+
+#ifndef SYMBOLICORE_INTERVAL_HPP
+#define SYMBOLICORE_INTERVAL_HPP
+
+#include <iosfwd>
+
+#include "helper/macros.hpp"
+#include "helper/container.hpp"
+#include "real.hpp"
+#include "expression.decl.hpp"
+
+namespace SymboliCore {
+
+using std::ostream;
+
+//! \brief An interval of values with lower and upper bounds of type \a UB.
+//! \details An interval whose lower bound is greater than its upper bound is empty.
+//! For \ref RealInterval, the bounds are double-precision values and all operations are rounded outward,
+//! so that the result of an operation on intervals contains the result of the operation on any of their elements.
+template<class UB> class Interval
+{
+  public:
+    typedef UB LowerBoundType; //!< <p/>
+    typedef UB UpperBoundType; //!< <p/>
+  public:
+    //! \brief Default constructor yielding the singleton \a {0}.
+    Interval() : _l(0), _u(0) { }
+    //! \brief Construct the singleton interval \a {x}.
+    explicit Interval(UB const& x) : _l(x), _u(x) { }
+    //! \brief Construct the interval \a [l,u].
+    Interval(LowerBoundType const& l, UpperBoundType const& u) : _l(l), _u(u) { }
+
+    LowerBoundType const& lower_bound() const { return _l; } //!< <p/>
+    UpperBoundType const& upper_bound() const { return _u; } //!< <p/>
+
+    //! \brief Tests whether the interval has no elements.
+    bool is_empty() const { return _u < _l; }
+    //! \brief Tests whether the interval has exactly one element.
+    bool is_singleton() const { return _l == _u; }
+    //! \brief Tests whether \a x is an element of the interval.
+    bool contains(UB const& x) const { return _l <= x && x <= _u; }
+
+    //! \brief Tests equality of the bounds.
+    friend bool operator==(Interval<UB> const& ivl1, Interval<UB> const& ivl2) {
+        return (ivl1.is_empty() && ivl2.is_empty()) || (ivl1._l == ivl2._l && ivl1._u == ivl2._u); }
+    friend bool operator!=(Interval<UB> const& ivl1, Interval<UB> const& ivl2) { return !(ivl1 == ivl2); } //!< <p/>
+    //! \brief Write as \a {l:u}.
+    friend ostream& operator<<(ostream& os, Interval<UB> const& ivl) {
+        return os << "{" << ivl._l << ":" << ivl._u << "}"; }
+  private:
+    LowerBoundType _l;
+    UpperBoundType _u;
+};
+
+//!@{
+//! \name Geometric operations
+//! \related Interval
+
+Real midpoint(RealInterval const& ivl); //!< \brief An approximation to the midpoint.
+Real radius(RealInterval const& ivl); //!< \brief An upper bound of the distance from the midpoint to the bounds.
+Real width(RealInterval const& ivl); //!< \brief An upper bound of the difference of the bounds.
+Real mag(RealInterval const& ivl); //!< \brief The largest absolute value of an element.
+RealInterval intersection(RealInterval const& ivl1, RealInterval const& ivl2); //!< \brief The common elements.
+RealInterval hull(RealInterval const& ivl1, RealInterval const& ivl2); //!< \brief The smallest interval containing both.
+bool subset(RealInterval const& ivl1, RealInterval const& ivl2); //!< \brief Tests if \a ivl1 is a subset of \a ivl2.
+bool disjoint(RealInterval const& ivl1, RealInterval const& ivl2); //!< \brief Tests if there are no common elements.
+//!@}
+
+//!@{
+//! \name Arithmetic operations, rounded outward
+//! \related Interval
+//! \details The algebraic operations are rounded to the nearest enclosing double.
+//! The transcendental operations rely on the C library, whose results are within one unit in the last place
+//! on the supported platforms; their bounds are therefore widened by two units in the last place.
+
+RealInterval nul(RealInterval const& ivl); //!< <p/>
+RealInterval pos(RealInterval const& ivl); //!< <p/>
+RealInterval neg(RealInterval const& ivl); //!< <p/>
+RealInterval hlf(RealInterval const& ivl); //!< <p/>
+RealInterval sqr(RealInterval const& ivl); //!< <p/>
+RealInterval rec(RealInterval const& ivl); //!< <p/>
+RealInterval add(RealInterval const& ivl1, RealInterval const& ivl2); //!< <p/>
+RealInterval sub(RealInterval const& ivl1, RealInterval const& ivl2); //!< <p/>
+RealInterval mul(RealInterval const& ivl1, RealInterval const& ivl2); //!< <p/>
+RealInterval div(RealInterval const& ivl1, RealInterval const& ivl2); //!< <p/>
+RealInterval pow(RealInterval const& ivl, int n); //!< <p/>
+RealInterval sqrt(RealInterval const& ivl); //!< <p/>
+RealInterval exp(RealInterval const& ivl); //!< <p/>
+RealInterval log(RealInterval const& ivl); //!< <p/>
+RealInterval sin(RealInterval const& ivl); //!< <p/>
+RealInterval cos(RealInterval const& ivl); //!< <p/>
+RealInterval tan(RealInterval const& ivl); //!< <p/>
+RealInterval asin(RealInterval const& ivl); //!< <p/>
+RealInterval acos(RealInterval const& ivl); //!< <p/>
+RealInterval atan(RealInterval const& ivl); //!< <p/>
+RealInterval abs(RealInterval const& ivl); //!< <p/>
+RealInterval max(RealInterval const& ivl1, RealInterval const& ivl2); //!< <p/>
+RealInterval min(RealInterval const& ivl1, RealInterval const& ivl2); //!< <p/>
+
+inline RealInterval operator+(RealInterval const& ivl) { return pos(ivl); } //!< <p/>
+inline RealInterval operator-(RealInterval const& ivl) { return neg(ivl); } //!< <p/>
+inline RealInterval operator+(RealInterval const& ivl1, RealInterval const& ivl2) { return add(ivl1,ivl2); } //!< <p/>
+inline RealInterval operator-(RealInterval const& ivl1, RealInterval const& ivl2) { return sub(ivl1,ivl2); } //!< <p/>
+inline RealInterval operator*(RealInterval const& ivl1, RealInterval const& ivl2) { return mul(ivl1,ivl2); } //!< <p/>
+inline RealInterval operator/(RealInterval const& ivl1, RealInterval const& ivl2) { return div(ivl1,ivl2); } //!< <p/>
+//!@}
+
+//!@{
+//! \name Comparison operations
+//! \related Interval
+//! \details The result is \a TRUE or \a FALSE if the comparison holds for all or no elements respectively,
+//! and \a INDETERMINATE otherwise, including when either interval is empty.
+
+ValidatedKleenean leq(RealInterval const& ivl1, RealInterval const& ivl2); //!< \brief Tests whether \a ivl1 ≤ \a ivl2.
+ValidatedKleenean lt(RealInterval const& ivl1, RealInterval const& ivl2); //!< \brief Tests whether \a ivl1 < \a ivl2.
+ValidatedKleenean eq(RealInterval const& ivl1, RealInterval const& ivl2); //!< \brief Tests whether \a ivl1 = \a ivl2.
+ValidatedKleenean sgn(RealInterval const& ivl); //!< \brief Tests whether \a ivl is positive, being \a INDETERMINATE if it contains zero.
+//!@}
+
+} // namespace SymboliCore
+
+#endif /* SYMBOLICORE_INTERVAL_HPP */
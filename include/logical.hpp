@@ -32,7 +32,12 @@
 #ifndef SYMBOLICORE_LOGICAL_HPP
 #define SYMBOLICORE_LOGICAL_HPP
 
+#include <atomic>
+#include <chrono>
+#include <memory>
+
 #include "helper/stdlib.hpp"
+#include "helper/macros.hpp"
 #include "helper/handle.hpp"
 #include "helper/string.hpp"
 #include "helper/array.hpp"
@@ -79,6 +84,37 @@ class Effort {
 };
 inline Effort operator""_eff(unsigned long long int e) { unsigned int m=static_cast<unsigned int>(e); assert(m==e); return Effort(m); }
 
+//! \ingroup LogicalModule
+//! \brief A wall-clock time after which no further Effort is spent on checking a quasidecidable predicate.
+//! \details Checking is cooperative: the effort level being computed when the deadline passes is completed,
+//! so a deadline bounds latency up to the cost of a single effort level.
+//! \sa Effort.
+class Deadline {
+  public:
+    typedef std::chrono::steady_clock ClockType;
+  private:
+    ClockType::time_point _t;
+  public:
+    //! \brief Construct from a time point of the steady clock.
+    explicit Deadline(ClockType::time_point t) : _t(t) { }
+    //! \brief The deadline at a time \a budget from now.
+    template<class R, class P> static Deadline after(std::chrono::duration<R,P> budget) {
+        return Deadline(ClockType::now()+std::chrono::duration_cast<ClockType::duration>(budget)); }
+    //! \brief The time point of the deadline.
+    ClockType::time_point time() const { return _t; }
+    //! \brief Whether the deadline has passed.
+    bool expired() const { return ClockType::now()>=_t; }
+    friend ostream& operator<<(ostream& os, Deadline d) {
+        return os << "Deadline(" << std::chrono::duration_cast<std::chrono::microseconds>(d._t-ClockType::now()).count() << "us)"; }
+};
+
+//! \ingroup LogicalModule
+//! \brief The value of a predicate checked against a Deadline, together with the Effort reached.
+template<class VL> struct CheckResult {
+    VL value;
+    Effort effort;
+};
+
 namespace Detail {
 
     //! \ingroup LogicalTypes
@@ -104,28 +140,85 @@ namespace Detail {
     inline LogicalValue operator^(LogicalValue lv1, LogicalValue lv2) { return not (lv1==lv2); }
     ostream& operator<<(ostream& os, LogicalValue l);
 
+    //! \brief Interface for refining a logical value one effort level at a time, resuming from the previous state.
+    class LogicalStepperInterface {
+      public:
+        virtual ~LogicalStepperInterface() = default;
+        //! \brief Raise the effort by one and return the value; the first call yields the value at effort 0.
+        virtual LogicalValue _step() = 0;
+    };
+
     class LogicalInterface {
       public:
         virtual ~LogicalInterface() = default;
         virtual LogicalInterface* clone() const = 0;
         virtual LogicalValue _check(Effort) const = 0;
         virtual ostream& _write(ostream&) const = 0;
+        virtual bool _is_constant() const { return false; }
+        //! \brief A new stepper for the value; by default re-checks at each effort level.
+        //! The node must outlive the stepper.
+        virtual LogicalStepperInterface* _new_stepper() const;
     };
 
+    //! \brief A handle to a lazily-checked logical value.
+    //! \details Constant values are stored inline with a null pointer, so that only genuinely lazy values allocate.
     class LogicalHandle : public Handle<LogicalInterface> {
+        static std::atomic<bool> _memoisation;
+        LogicalValue _v = LogicalValue::INDETERMINATE;
+        explicit LogicalHandle(LogicalValue v) : Handle<LogicalInterface>(shared_ptr<LogicalInterface>()), _v(v) { }
        public:
         using Handle<LogicalInterface>::Handle;
-        static LogicalHandle constant(LogicalValue v);
-        LogicalValue check(Effort eff) const { return this->pointer()->_check(eff); }
-        friend ostream& operator<<(ostream& os, LogicalHandle l) {
-            return l.pointer()->_write(os); }
+        static LogicalHandle constant(LogicalValue v) { return LogicalHandle(v); }
+        //! \brief Whether lazy nodes cache the value found at the last effort checked. Initially \c true.
+        //! \details The flag may be read by worker threads while being set, but orders no other memory access.
+        static bool memoisation() { return _memoisation.load(std::memory_order_relaxed); }
+        //! \brief Enable or disable caching of checked values in lazy nodes.
+        static void set_memoisation(bool b) { _memoisation.store(b,std::memory_order_relaxed); }
+        //! \brief Whether the value is a constant held inline.
+        bool is_constant() const { return this->pointer()==nullptr; }
+        //! \brief The inline constant value; only meaningful if is_constant().
+        LogicalValue value() const { return this->_v; }
+        LogicalValue check(Effort eff) const { return this->is_constant() ? this->_v : this->pointer()->_check(eff); }
+        //! \brief The lazy node; only meaningful if not is_constant().
+        operator LogicalInterface const& () const { return this->reference(); }
+        //! \brief The lazy node; only meaningful if not is_constant().
+        LogicalInterface const& reference() const {
+            HELPER_PRECONDITION_MSG(not this->is_constant(),"The constant logical value "<<this->_v<<" has no lazy node");
+            return *this->pointer(); }
+        friend ostream& operator<<(ostream& os, LogicalHandle const& l) {
+            return l.is_constant() ? os << l._v : l.pointer()->_write(os); }
+    };
+
+    //! \brief Cooperative incremental checking of a logical value.
+    //! \details Each call to step() raises the effort by one, resuming from the work done at lower effort,
+    //! so that an effort-escalation loop costs the total work rather than the sum over all effort levels.
+    //! The value after reaching effort \a e is that of <code>check(e)</code>.
+    class LogicalStepper {
+        LogicalHandle _handle;
+        std::unique_ptr<LogicalStepperInterface> _ptr;
+        unsigned int _effort;
+        LogicalValue _value;
+      public:
+        //! \brief Start checking \a l, computing its value at effort 0.
+        explicit LogicalStepper(LogicalHandle const& l);
+        //! \brief The effort reached.
+        Effort effort() const { return Effort(_effort); }
+        //! \brief The value at the effort reached.
+        LogicalValue value() const { return _value; }
+        //! \brief Raise the effort by one and return the new value.
+        LogicalValue step();
+        //! \brief Raise the effort up to \a e and return the new value. Does nothing if \a e has already been reached.
+        LogicalValue step_to(Effort e) { while (_effort<e.work()) { this->step(); } return _value; }
     };
 
-    inline LogicalValue check(LogicalHandle l, Effort e) { return l.check(e); }
-    inline bool definitely(LogicalHandle l, Effort e) { return definitely(check(l,e)); }
-    inline bool probably(LogicalHandle l, Effort e) { return probably(check(l,e)); }
-    inline bool decide(LogicalHandle l, Effort e) { return decide(check(l,e)); }
-    inline bool possibly(LogicalHandle l, Effort e) { return possibly(check(l,e)); }
+    inline LogicalValue check(LogicalHandle const& l, Effort e) { return l.check(e); }
+    //! \brief Raise the effort of checking \a l until its value is determinate or deadline \a d has passed,
+    //! setting \a reached to the effort of the value returned.
+    LogicalValue check(LogicalHandle const& l, Deadline d, Effort& reached);
+    inline bool definitely(LogicalHandle const& l, Effort e) { return definitely(check(l,e)); }
+    inline bool probably(LogicalHandle const& l, Effort e) { return probably(check(l,e)); }
+    inline bool decide(LogicalHandle const& l, Effort e) { return decide(check(l,e)); }
+    inline bool possibly(LogicalHandle const& l, Effort e) { return possibly(check(l,e)); }
     LogicalHandle operator&&(LogicalHandle v1, LogicalHandle v2);
     LogicalHandle operator||(LogicalHandle v1, LogicalHandle v2);
     LogicalHandle operator==(LogicalHandle v1, LogicalHandle v2);
@@ -139,25 +232,34 @@ namespace Detail {
     LogicalHandle exclusive(LogicalHandle l1, LogicalHandle l2);
 
     LogicalValue logical_value_from_pointer(LogicalInterface* ptr);
+    LogicalValue logical_value_from_handle(LogicalHandle const& l);
     LogicalInterface* new_logical_pointer_from_value(LogicalValue);
 
     template<class P> LogicalType<P> logical_type_from_pointer(LogicalInterface* ptr) {
         if constexpr (ConstructibleFrom<LogicalType<P>,LogicalHandle>) {
-            auto elptr=dynamic_cast<LogicalInterface*>(ptr);
-            if (elptr) {
-                return LogicalType<P>(LogicalHandle(shared_ptr<LogicalInterface>(elptr)));
+            if (ptr) {
+                return LogicalType<P>(LogicalHandle(shared_ptr<LogicalInterface>(ptr)));
             }
         }
         static_assert (ConstructibleFrom<LogicalType<P>,LogicalValue>);
         return LogicalType<P>(logical_value_from_pointer(ptr));
     }
 
+    template<class P> LogicalType<P> logical_type_from_handle(LogicalHandle const& l) {
+        if constexpr (ConstructibleFrom<LogicalType<P>,LogicalHandle>) {
+            return LogicalType<P>(l);
+        } else {
+            return LogicalType<P>(logical_value_from_handle(l));
+        }
+    }
+
 
 }
 
 using Detail::LogicalValue;
 using Detail::LogicalHandle;
 using Detail::LogicalInterface;
+using Detail::LogicalStepper;
 
 
 
@@ -193,6 +295,15 @@ template<class L> class LogicalBase<L,LogicalHandle> {
     friend bool probably(L const& l) { return probably(l,Effort::get_default()); }
     friend bool decide(L const& l) { return decide(l,Effort::get_default()); }
     friend bool possibly(L const& l) { return possibly(l,Effort::get_default()); }
+    //! \brief Check the value of \a l, raising the effort until the value is determinate or the deadline \a d has passed.
+    friend auto check(L const& l, Deadline d) {
+        Effort eff(0u); LogicalValue v=Detail::check(l._v,d,eff);
+        typedef decltype(l.check(eff)) VL;
+        return CheckResult<VL>{VL(v),eff}; }
+    friend bool definitely(L const& l, Deadline d) { return definitely(check(l,d).value); }
+    friend bool probably(L const& l, Deadline d) { return probably(check(l,d).value); }
+    friend bool decide(L const& l, Deadline d) { return decide(check(l,d).value); }
+    friend bool possibly(L const& l, Deadline d) { return possibly(check(l,d).value); }
 };
 
 
@@ -596,19 +707,37 @@ class NondeterministicBoolean {
     LowerKleenean _pt; LowerKleenean _pf; bool _r;
   public:
     NondeterministicBoolean(LowerKleenean pt, LowerKleenean pf) : _pt(pt), _pf(pf), _r(_choose(pt,pf)) { }
+    //! \brief Race \a pt and \a pf on up to \a concurrency threads, as in nondeterministic_choose_index;
+    //! unlike the serial choice, throws if both are definitely \c false.
+    NondeterministicBoolean(LowerKleenean pt, LowerKleenean pf, unsigned int concurrency) : _pt(pt), _pf(pf), _r(_choose(pt,pf,concurrency)) { }
     operator bool() const { return _r; }
   private:
     static bool _choose(LowerKleenean pt, LowerKleenean pf);
+    static bool _choose(LowerKleenean pt, LowerKleenean pf, unsigned int concurrency);
 };
 inline NondeterministicBoolean choose(LowerKleenean pt, LowerKleenean pf) {
     return NondeterministicBoolean(pt,pf);
 }
+inline NondeterministicBoolean choose(LowerKleenean pt, LowerKleenean pf, unsigned int concurrency) {
+    return NondeterministicBoolean(pt,pf,concurrency);
+}
 
 //! \relates LowerKleenean
 //! Returns an index \a i such that \c p[i] is definitely \c true, if one exists.
 //! Loops infinitely if no \c p[i] can be shown to be definitely \c true.
 size_t nondeterministic_choose_index(Array<LowerKleenean> const& p);
 
+//! \relates LowerKleenean
+//! Returns an index \a i such that \c p[i] is definitely \c true, racing the predicates on at most \a concurrency threads
+//! (zero meaning the number of hardware threads). Each thread raises the effort of its own predicates independently,
+//! and the others are cancelled cooperatively, between steps, once one predicate is verified.
+//! When \a concurrency is at least the number of predicates each thread owns a single one; otherwise the predicates
+//! are partitioned by index and those of one thread advance in lockstep, so that a slow predicate delays the others
+//! sharing its thread. With a single thread the predicates are stepped on the calling thread in the serial order.
+//! Unlike the serial version, predicates that become definitely \c false are dropped and the function throws
+//! if all of them are; it loops infinitely if no \c p[i] can be shown to be definitely \c true otherwise.
+size_t nondeterministic_choose_index(Array<LowerKleenean> const& p, unsigned int concurrency);
+
 template<class P, class T> class Case {
     P _p; T _t;
   public:
@@ -0,0 +1,341 @@
+/***************************************************************************
+ *            matrix.hpp
+ *
+ *  Copyright  2023  Luca Geretti
+ *
+ ****************************************************************************/
+
+/*
+ * This file is part of SymboliCore, under the MIT license.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*! \file matrix.hpp
+ *  \brief Dense covectors and matrices over a scalar.
+ */
+
+#ifndef SYMBOLICORE_MATRIX_HPP
+#define SYMBOLICORE_MATRIX_HPP
+
+#include "real.hpp"
+#include "vector.hpp"
+#include "expression.decl.hpp"
+
+namespace SymboliCore {
+
+/************ Covector *********************************************************/
+
+//! \ingroup LinearAlgebraModule
+//! \brief Covectors (row vectors) over some type \a X, acting linearly on vectors by the product \a u*v.
+template<class X>
+class Covector
+{
+    Vector<X> _v;
+  public:
+    //!@{
+    //! \name Type definitions
+    typedef size_t IndexType; //!< <p/>
+    typedef X ScalarType; //!< <p/>
+    //!@}
+
+    //!@{
+    //! \name Constructors
+
+    //! \brief Default constructor constructs a covector with no elements.
+    Covector() : _v() { }
+    //! \brief Construct a covector of size \a n, with elements initialised to \a t.
+    explicit Covector(size_t n, X const& t) : _v(n,t) { }
+    //! \brief Convert from an initializer list of the same type.
+    Covector(initializer_list<X> lst) : _v(lst) { }
+    //! \brief Generate from a function (object) \a g of type \a G mapping an index to a value.
+    template<class G> requires InvocableReturning<X,G,size_t>
+    Covector(size_t n, G const& g) : _v(n,g) { }
+    //! \brief Construct from the transpose of a vector.
+    explicit Covector(Vector<X> const& v) : _v(v) { }
+    explicit Covector(Vector<X>&& v) : _v(std::move(v)) { }
+    //!@}
+
+    //!@{
+    //! \name Data access
+
+    //! \brief The number of elements of the covector.
+    size_t size() const { return _v.size(); }
+    //! \brief Subscripting operator. Unchecked access.
+    X& operator[](size_t j) { return _v[j]; }
+    //! \brief Constant subscripting operator.
+    X const& operator[](size_t j) const { return _v[j]; }
+    //! \brief The zero of the ring containing the elements.
+    X zero_element() const { return _v.zero_element(); }
+    //! \brief The elements as a (column) vector.
+    Vector<X> const& transpose() const { return _v; }
+    //!@}
+};
+
+template<class X> struct IsCovector<Covector<X>> : True { };
+
+//! \relates Covector \brief The transpose of a vector.
+template<class X> Covector<X> transpose(Vector<X> const& v) { return Covector<X>(v); }
+//! \relates Covector \brief The transpose of a covector.
+template<class X> Vector<X> const& transpose(Covector<X> const& u) { return u.transpose(); }
+
+template<class X1, class X2> Covector<SumType<X1,X2>> operator+(Covector<X1> const& u1, Covector<X2> const& u2) {
+    return Covector<SumType<X1,X2>>(Vector<SumType<X1,X2>>(u1.transpose()+u2.transpose())); }
+template<class X1, class X2> Covector<DifferenceType<X1,X2>> operator-(Covector<X1> const& u1, Covector<X2> const& u2) {
+    return Covector<DifferenceType<X1,X2>>(Vector<DifferenceType<X1,X2>>(u1.transpose()-u2.transpose())); }
+template<class X> Covector<X> operator*(X const& s, Covector<X> const& u) {
+    return Covector<X>(Vector<X>(s*u.transpose())); }
+
+//! \relates Covector \brief The action of the covector \a u on the vector \a v.
+template<class X1, class X2> ArithmeticType<X1,X2> operator*(Covector<X1> const& u, Vector<X2> const& v) {
+    HELPER_PRECONDITION(u.size()==v.size());
+    if(u.size()==0u) { return u.zero_element()*v.zero_element(); }
+    ArithmeticType<X1,X2> r=u[0]*v[0];
+    for(size_t i=1; i!=u.size(); ++i) { r+=u[i]*v[i]; }
+    return r;
+}
+Real operator*(Covector<Real> const& u, Vector<Real> const& v);
+
+template<class X> ostream& operator<<(ostream& os, Covector<X> const& u) {
+    return os << u.transpose() << "^T"; }
+
+/************ Matrix *********************************************************/
+
+template<class M> class MatrixRow;
+
+//! \ingroup LinearAlgebraModule
+//! \brief Dense matrices over some type \a X, stored in row-major order.
+//! \details The elements are held in a Vector<X>, so that matrices of Real values inherit its aligned storage
+//! and fused element-wise arithmetic. The products of matrices of Real values use cache-blocked kernels.
+template<class X>
+class Matrix
+{
+    size_t _rs;
+    size_t _cs;
+    Vector<X> _v;
+  public:
+    //!@{
+    //! \name Type definitions
+    typedef size_t IndexType; //!< <p/>
+    typedef X ScalarType; //!< <p/>
+    //!@}
+
+    //!@{
+    //! \name Constructors
+
+    //! \brief Default constructor constructs a matrix with no rows or columns.
+    Matrix() : _rs(0u), _cs(0u), _v() { }
+    //! \brief Construct a matrix with \a rs rows and \a cs columns, with elements initialised to \a t.
+    Matrix(size_t rs, size_t cs, X const& t) : _rs(rs), _cs(cs), _v(rs*cs,t) { }
+    //! \brief Generate from a function (object) \a g mapping a row and a column index to a value.
+    template<class G> requires InvocableReturning<X,G,size_t,size_t>
+    Matrix(size_t rs, size_t cs, G const& g) : _rs(rs), _cs(cs), _v(rs*cs,[&g,cs](size_t k){return g(k/cs,k%cs);}) { }
+    //! \brief Construct from the elements \a v in row-major order.
+    Matrix(size_t rs, size_t cs, Vector<X> v) : _rs(rs), _cs(cs), _v(std::move(v)) {
+        HELPER_PRECONDITION_MSG(_v.size()==rs*cs,"A "<<rs<<"x"<<cs<<" matrix cannot hold "<<_v.size()<<" elements."); }
+    //! \brief Convert from a list of rows.
+    Matrix(initializer_list<initializer_list<X>> lst);
+    //! \brief Construct from a matrix of generic type.
+    template<class Y> requires Constructible<X,Y> and (not Same<X,Y>)
+    explicit Matrix(Matrix<Y> const& A) : Matrix(A.row_size(),A.column_size(),[&A](size_t i, size_t j){return X(A.get(i,j));}) { }
+    //!@}
+
+    //!@{
+    //! \name Static constructors
+
+    //! \brief The zero matrix with \a rs rows and \a cs columns.
+    template<class... PRS> requires Constructible<X,unsigned int,PRS...>
+    static Matrix<X> zero(size_t rs, size_t cs, PRS... prs) { return Matrix<X>(rs,cs,X(0u,prs...)); }
+    //! \brief The identity matrix of size \a n.
+    template<class... PRS> requires Constructible<X,unsigned int,PRS...>
+    static Matrix<X> identity(size_t n, PRS... prs) {
+        return Matrix<X>(n,n,[&](size_t i, size_t j){return X(i==j ? 1u : 0u,prs...);}); }
+    //!@}
+
+    //!@{
+    //! \name Data access
+
+    //! \brief The number of rows.
+    size_t row_size() const { return _rs; }
+    //! \brief The number of columns.
+    size_t column_size() const { return _cs; }
+    //! \brief A reference to the element in row \a i and column \a j.
+    X& at(size_t i, size_t j) { HELPER_PRECONDITION(i<_rs && j<_cs); return _v[i*_cs+j]; }
+    //! \brief A constant reference to the element in row \a i and column \a j.
+    X const& at(size_t i, size_t j) const { HELPER_PRECONDITION(i<_rs && j<_cs); return _v[i*_cs+j]; }
+    //! \brief Get the element in row \a i and column \a j.
+    X const& get(size_t i, size_t j) const { return _v[i*_cs+j]; }
+    //! \brief Set the element in row \a i and column \a j to \a x.
+    void set(size_t i, size_t j, X const& x) { _v[i*_cs+j]=x; }
+    //! \brief The row \a i, to be subscripted by a column index. Unchecked access.
+    MatrixRow<Matrix<X>> operator[](size_t i) { return MatrixRow<Matrix<X>>(*this,i); }
+    //! \brief The constant row \a i, to be subscripted by a column index. Unchecked access.
+    MatrixRow<const Matrix<X>> operator[](size_t i) const { return MatrixRow<const Matrix<X>>(*this,i); }
+    //! \brief A copy of the row \a i.
+    Covector<X> row(size_t i) const { return Covector<X>(_cs,[this,i](size_t j){return get(i,j);}); }
+    //! \brief A copy of the column \a j.
+    Vector<X> column(size_t j) const { return Vector<X>(_rs,[this,j](size_t i){return get(i,j);}); }
+    //! \brief The zero of the ring containing the elements.
+    X zero_element() const { return _v.zero_element(); }
+    //! \brief The elements in row-major order.
+    Vector<X> const& elements() const { return _v; }
+    //!@}
+};
+
+template<class X> struct IsMatrix<Matrix<X>> : True { };
+
+//! \brief A row of a matrix, allowing the subscripting <c>A[i][j]</c>.
+template<class M> class MatrixRow {
+    M& _A; size_t _i;
+  public:
+    MatrixRow(M& A, size_t i) : _A(A), _i(i) { }
+    decltype(auto) operator[](size_t j) const {
+        if constexpr (std::is_const_v<M>) { return _A.get(_i,j); } else { return (_A.at(_i,j)); } }
+};
+
+template<class X> Matrix<X>::Matrix(initializer_list<initializer_list<X>> lst)
+    : _rs(lst.size()), _cs(lst.size()==0u ? 0u : lst.begin()->size()), _v()
+{
+    List<X> elements;
+    for(auto const& row : lst) {
+        HELPER_PRECONDITION_MSG(row.size()==_cs,"All rows of a matrix must have the same size.");
+        for(auto const& x : row) { elements.push_back(x); }
+    }
+    _v=Vector<X>(elements);
+}
+
+//! \relates Matrix \brief The transpose of the matrix \a A.
+template<class X> Matrix<X> transpose(Matrix<X> const& A) {
+    return Matrix<X>(A.column_size(),A.row_size(),[&A](size_t i, size_t j){return A.get(j,i);}); }
+
+template<class X> Matrix<X> operator-(Matrix<X> const& A) {
+    return Matrix<X>(A.row_size(),A.column_size(),Vector<X>(-A.elements())); }
+template<class X1, class X2> Matrix<SumType<X1,X2>> operator+(Matrix<X1> const& A1, Matrix<X2> const& A2) {
+    HELPER_PRECONDITION(A1.row_size()==A2.row_size() && A1.column_size()==A2.column_size());
+    return Matrix<SumType<X1,X2>>(A1.row_size(),A1.column_size(),Vector<SumType<X1,X2>>(A1.elements()+A2.elements())); }
+template<class X1, class X2> Matrix<DifferenceType<X1,X2>> operator-(Matrix<X1> const& A1, Matrix<X2> const& A2) {
+    HELPER_PRECONDITION(A1.row_size()==A2.row_size() && A1.column_size()==A2.column_size());
+    return Matrix<DifferenceType<X1,X2>>(A1.row_size(),A1.column_size(),Vector<DifferenceType<X1,X2>>(A1.elements()-A2.elements())); }
+template<class X> Matrix<X> operator*(X const& s, Matrix<X> const& A) {
+    return Matrix<X>(A.row_size(),A.column_size(),Vector<X>(s*A.elements())); }
+template<class X> Matrix<X> operator*(Matrix<X> const& A, X const& s) {
+    return Matrix<X>(A.row_size(),A.column_size(),Vector<X>(A.elements()*s)); }
+template<class X> Matrix<X> operator/(Matrix<X> const& A, X const& s) {
+    return Matrix<X>(A.row_size(),A.column_size(),Vector<X>(A.elements()/s)); }
+
+//! \relates Matrix \brief The matrix-vector product \a A*v.
+template<class X1, class X2> Vector<ArithmeticType<X1,X2>> operator*(Matrix<X1> const& A, Vector<X2> const& v) {
+    HELPER_PRECONDITION(A.column_size()==v.size());
+    typedef ArithmeticType<X1,X2> R;
+    return Vector<R>(A.row_size(),[&A,&v](size_t i) {
+        if(A.column_size()==0u) { return R(A.zero_element()*v.zero_element()); }
+        R r=A.get(i,0)*v[0];
+        for(size_t j=1; j!=A.column_size(); ++j) { r+=A.get(i,j)*v[j]; }
+        return r; });
+}
+
+//! \relates Matrix \brief The covector-matrix product \a u*A.
+template<class X1, class X2> Covector<ArithmeticType<X1,X2>> operator*(Covector<X1> const& u, Matrix<X2> const& A) {
+    HELPER_PRECONDITION(u.size()==A.row_size());
+    typedef ArithmeticType<X1,X2> R;
+    return Covector<R>(A.column_size(),[&u,&A](size_t j) {
+        if(A.row_size()==0u) { return R(u.zero_element()*A.zero_element()); }
+        R r=u[0]*A.get(0,j);
+        for(size_t i=1; i!=A.row_size(); ++i) { r+=u[i]*A.get(i,j); }
+        return r; });
+}
+
+//! \relates Matrix \brief The matrix product \a A1*A2.
+template<class X1, class X2> Matrix<ArithmeticType<X1,X2>> operator*(Matrix<X1> const& A1, Matrix<X2> const& A2) {
+    HELPER_PRECONDITION(A1.column_size()==A2.row_size());
+    typedef ArithmeticType<X1,X2> R;
+    return Matrix<R>(A1.row_size(),A2.column_size(),[&A1,&A2](size_t i, size_t j) {
+        if(A1.column_size()==0u) { return R(A1.zero_element()*A2.zero_element()); }
+        R r=A1.get(i,0)*A2.get(0,j);
+        for(size_t k=1; k!=A1.column_size(); ++k) { r+=A1.get(i,k)*A2.get(k,j); }
+        return r; });
+}
+
+//!@{
+//! \relates Matrix
+//! \name Cache-blocked products of matrices of Real values
+Vector<Real> operator*(Matrix<Real> const& A, Vector<Real> const& v);
+Covector<Real> operator*(Covector<Real> const& u, Matrix<Real> const& A);
+Matrix<Real> operator*(Matrix<Real> const& A1, Matrix<Real> const& A2);
+//!@}
+
+template<class X1, class X2> decltype(declval<X1>()==declval<X2>()) operator==(Matrix<X1> const& A1, Matrix<X2> const& A2) {
+    if(A1.row_size()!=A2.row_size() || A1.column_size()!=A2.column_size()) { return false; }
+    return A1.elements()==A2.elements(); }
+
+template<class X> ostream& operator<<(ostream& os, Matrix<X> const& A) {
+    os << "[";
+    for(size_t i=0; i!=A.row_size(); ++i) {
+        if(i!=0u) { os << ";"; }
+        for(size_t j=0; j!=A.column_size(); ++j) { os << (j==0u?"":",") << A.get(i,j); }
+    }
+    return os << "]";
+}
+
+/************ LU decomposition *********************************************************/
+
+//! \ingroup LinearAlgebraModule
+//! \brief The LU decomposition with partial pivoting \a PA=LU of a square matrix of Real values.
+//! \details Throws a \c std::runtime_error if the matrix is singular.
+class LUDecomposition {
+    Matrix<Real> _lu;
+    Array<size_t> _p;
+    bool _odd;
+  public:
+    //! \brief Decompose the square matrix \a A.
+    explicit LUDecomposition(Matrix<Real> const& A);
+    //! \brief The size of the decomposed matrix.
+    size_t size() const { return _lu.row_size(); }
+    //! \brief The factors, with \a L strictly below the diagonal (with implicit unit diagonal) and \a U on and above it.
+    Matrix<Real> const& factors() const { return _lu; }
+    //! \brief The row permutation \a P, where row \a i of \a PA is row \a p[i] of \a A.
+    Array<size_t> const& permutation() const { return _p; }
+    //! \brief Solve \a Ax=b.
+    Vector<Real> solve(Vector<Real> const& b) const;
+    //! \brief Solve \a AX=B.
+    Matrix<Real> solve(Matrix<Real> const& B) const;
+    //! \brief The determinant of \a A.
+    Real determinant() const;
+    //! \brief The inverse of \a A.
+    Matrix<Real> inverse() const;
+};
+
+//! \relates Matrix \brief Solve \a Ax=b by LU decomposition with partial pivoting.
+Vector<Real> solve(Matrix<Real> const& A, Vector<Real> const& b);
+//! \relates Matrix \brief Solve \a AX=B by LU decomposition with partial pivoting.
+Matrix<Real> solve(Matrix<Real> const& A, Matrix<Real> const& B);
+//! \relates Matrix \brief The inverse of the square matrix \a A.
+Matrix<Real> inverse(Matrix<Real> const& A);
+//! \relates Matrix \brief The determinant of the square matrix \a A.
+Real determinant(Matrix<Real> const& A);
+
+/************ Symbolic matrices *********************************************************/
+
+//! \relates Matrix \brief The matrix of the derivatives of the expressions \a f with respect to the variables of \a spc.
+Matrix<Expression<Real>> jacobian(Vector<Expression<Real>> const& f, Space<Real> const& spc);
+//! \relates Matrix \brief Evaluate each element of the symbolic matrix \a A on the valuation \a x.
+Matrix<Real> evaluate(Matrix<Expression<Real>> const& A, Valuation<Real> const& x);
+
+} // namespace SymboliCore
+
+#endif // SYMBOLICORE_MATRIX_HPP
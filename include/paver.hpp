@@ -0,0 +1,112 @@
+/***************************************************************************
+ *            paver.hpp
+ *
+ *  Copyright  2023  Luca Geretti
+ *
+ ****************************************************************************/
+
+/*
+ * This file is part of SymboliCore, under the MIT license.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*! \file paver.hpp
+ *  \brief Paving of sets defined by constraints.
+ */
+
+#ifndef SYMBOLICORE_PAVER_HPP
+#define SYMBOLICORE_PAVER_HPP
+
+#include <functional>
+
+#include "helper/container.hpp"
+#include "interval.hpp"
+#include "variables_box.hpp"
+#include "contractor.hpp"
+#include "expression.hpp"
+
+namespace SymboliCore {
+
+using Helper::List;
+
+//! \brief The classification of a box with respect to a set.
+enum class PavingClass : char {
+    INSIDE,   //!< All points of the box are in the set.
+    OUTSIDE,  //!< No point of the box is in the set.
+    UNDECIDED //!< The box was too small, or too deep, to be refined further.
+};
+ostream& operator<<(ostream& os, PavingClass const& cls);
+
+//! \brief Settings for a Paver.
+struct PaverSettings {
+    //! \brief Boxes are not bisected if no variable of the constraints has a wider interval.
+    double minimum_width;
+    //! \brief Boxes are not bisected beyond this number of bisections from the initial box.
+    unsigned int maximum_depth;
+    //! \brief The number of threads; zero means the number of hardware threads.
+    unsigned int concurrency;
+    //! \brief Whether boxes are contracted before being classified, yielding the removed parts as outside boxes.
+    bool contract;
+    //! \brief The default settings.
+    static PaverSettings default_settings();
+};
+
+//! \brief The boxes of a paving, grouped by their class.
+struct Paving {
+    List<RealVariablesBox> inside; //!< <p/>
+    List<RealVariablesBox> outside; //!< <p/>
+    List<RealVariablesBox> undecided; //!< <p/>
+};
+
+//! \brief A branch-and-prune paver for the set of points satisfying a conjunction of constraints.
+//! \details Each box is optionally contracted, then classified by evaluating the constraints over it with interval arithmetic.
+//! Boxes which cannot be classified are bisected along the widest of the variables of the constraints,
+//! unless they have reached the minimum width or the maximum depth, in which case they are undecided.
+//!
+//! Bisection runs on a pool of threads, each one refining its own boxes depth-first and stealing the largest
+//! pending boxes from the other threads when idle. The number of pending boxes is therefore bounded by
+//! the maximum depth for each thread. Classified boxes are passed to a consumer as soon as they are produced;
+//! the consumer is never called concurrently. With one thread, the order of the results is deterministic.
+class Paver {
+  public:
+    //! \brief The type of the function receiving the classified boxes.
+    typedef std::function<void(RealVariablesBox const&, PavingClass)> ConsumerType;
+  public:
+    //! \brief Construct a paver for the set of points satisfying \a p.
+    Paver(Expression<Kleenean> const& p, PaverSettings const& settings=PaverSettings::default_settings());
+    //! \brief Construct a paver for the set of points satisfying all of \a ps, which must be nonempty.
+    Paver(List<Expression<Kleenean>> const& ps, PaverSettings const& settings=PaverSettings::default_settings());
+
+    //! \brief The settings.
+    PaverSettings const& settings() const { return _settings; }
+
+    //! \brief Pave the box \a bx, passing each classified box to \a consumer.
+    void pave(RealVariablesBox const& bx, ConsumerType const& consumer) const;
+    //! \brief Pave the box \a bx, collecting the classified boxes.
+    Paving pave(RealVariablesBox const& bx) const;
+  private:
+    Expression<Kleenean> _predicate;
+    List<Identifier> _variables;
+    Contractor _contractor;
+    PaverSettings _settings;
+};
+
+} // namespace SymboliCore
+
+#endif /* SYMBOLICORE_PAVER_HPP */
@@ -0,0 +1,162 @@
+/***************************************************************************
+ *            program.hpp
+ *
+ *  Copyright  2023  Luca Geretti
+ *
+ ****************************************************************************/
+
+/*
+ * This file is part of SymboliCore, under the MIT license.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+/*! \file program.hpp
+ *  \brief Straight-line register programs computing blocks of assignments.
+ */
+
+#ifndef SYMBOLICORE_PROGRAM_HPP
+#define SYMBOLICORE_PROGRAM_HPP
+
+#include <span>
+#include <vector>
+
+#include "real.hpp"
+#include "vector.hpp"
+#include "expression.hpp"
+#include "assignment.hpp"
+#include "space.hpp"
+#include "valuation.hpp"
+
+namespace SymboliCore {
+
+//! \brief A straight-line program computing the values of a block of assignments \f$v_i:=e_i(x,v_0,\ldots,v_{i-1})\f$
+//! from the values of the variables \f$x\f$ of an argument space.
+//! \details The registers hold the arguments, then the constants, then the temporaries.
+//! Each distinct subexpression is computed once into a register, assignments whose results are never read are removed,
+//! and temporaries are reused once their last reader has executed, so that the register file stays small.
+//! Evaluation does not allocate when the caller supplies the workspace.
+//! \see algebraic_sort
+class RegisterProgram {
+  public:
+    //! \brief An instruction setting register \a result from \a arg1 and \a arg2, or from \a arg1 and the exponent \a num for \c POW.
+    struct Instruction { OperatorCode code; unsigned int result; unsigned int arg1; unsigned int arg2; int num; };
+    //! \brief The number of points evaluated together by the batch evaluation.
+    static constexpr size_t BLOCK_SIZE=64u;
+  public:
+    //! \brief Compile the \a assignments over the argument space \a spc, with results the values of all the assigned variables.
+    //! \details The assignments must be sorted, so that each variable is assigned before it is used;
+    //! throws a \c std::runtime_error if they are not, or if a variable is neither in \a spc nor assigned.
+    RegisterProgram(List<RealAssignment> const& assignments, RealSpace const& spc);
+    //! \brief Compile the \a assignments over the argument space \a spc, with results the values of the \a outputs,
+    //! which may be assigned variables or variables of \a spc.
+    RegisterProgram(List<RealAssignment> const& assignments, RealSpace const& spc, List<RealVariable> const& outputs);
+    //! \brief Compile the \a assignments over the argument space \a spc, with results the values of the expressions \a results,
+    //! which may use both the assigned variables and the variables of \a spc.
+    RegisterProgram(Vector<RealExpression> const& results, List<RealAssignment> const& assignments, RealSpace const& spc);
+
+    //! \brief The space of the arguments.
+    RealSpace const& argument_space() const { return _argument_space; }
+    //! \brief The expressions whose values are the results, in order.
+    List<RealExpression> const& results() const { return _results; }
+    //! \brief The number of arguments.
+    size_t argument_size() const { return _argument_space.dimension(); }
+    //! \brief The number of results.
+    size_t result_size() const { return _outputs.size(); }
+    //! \brief The number of registers, which is the size of the workspace of a single evaluation.
+    size_t register_size() const { return _register_size; }
+    //! \brief The number of instructions.
+    size_t number_of_instructions() const { return _instructions.size(); }
+    //! \brief The instructions, in order of execution.
+    std::vector<Instruction> const& instructions() const { return _instructions; }
+
+    //! \brief Evaluate on the raw array \a x, writing the results into \a y, using \a w as workspace of register_size() values.
+    //! \details The arguments are all read before any result is written, so \a y may coincide with \a x.
+    void operator()(const double* x, double* y, double* w) const;
+    //! \brief Evaluate on the raw array \a x, writing the results into \a y.
+    void operator()(const double* x, double* y) const;
+    //! \brief Evaluate on the vector \a x of values ordered as the argument space.
+    Vector<Real> operator()(Vector<Real> const& x) const;
+    //! \brief Evaluate the program \a p on the valuation \a x.
+    friend Vector<Real> evaluate(RegisterProgram const& p, Valuation<Real> const& x);
+
+    //! \brief Evaluate on \a count points, whose arguments are stored consecutively in \a x, writing the results consecutively into \a y.
+    //! \details Each instruction is executed on blocks of BLOCK_SIZE points at a time. The points are split among
+    //! \a concurrency threads, where \c 0 uses the hardware concurrency. The results equal those of evaluation point by point.
+    //! If there are as many results as arguments, \a y may coincide with \a x.
+    void batch(size_t count, const double* x, double* y, unsigned int concurrency=1u) const;
+    //! \brief Evaluate on \a count points in the calling thread, using \a w as workspace of batch_workspace_size() values.
+    void batch(size_t count, const double* x, double* y, std::span<double> w) const;
+    //! \brief The size of the workspace of a batch evaluation.
+    size_t batch_workspace_size() const { return _register_size*BLOCK_SIZE; }
+
+    friend ostream& operator<<(ostream& os, RegisterProgram const& p);
+  private:
+    void _compile(List<RealAssignment> const& assignments);
+    void _batch(size_t begin, size_t end, const double* x, double* y, double* w) const;
+  private:
+    RealSpace _argument_space;
+    List<RealExpression> _results;
+    std::vector<double> _constants;
+    std::vector<Instruction> _instructions;
+    std::vector<unsigned int> _outputs;
+    size_t _register_size;
+};
+
+//! \brief A compiled reset map \f$x':=r(x)\f$ on a state space, evaluating all the primed assignments on the state before the jump.
+//! \details Variables of the state space which are not reset keep their value. The right-hand sides are compiled into a
+//! single RegisterProgram, so that their common subexpressions are computed once. The new state can be written into a
+//! separate array or over the old state.
+class ResetMap {
+  public:
+    //! \brief Compile the \a resets of the variables of \a spc, whose right-hand sides use the variables of \a spc.
+    //! \details Throws a \c std::runtime_error if a reset variable is not in \a spc or is reset more than once.
+    ResetMap(PrimedRealAssignments const& resets, RealSpace const& spc);
+    //! \brief Compile the \a resets of the variables of \a spc, whose right-hand sides may also use the sorted \a auxiliary assignments.
+    ResetMap(List<RealAssignment> const& auxiliary, PrimedRealAssignments const& resets, RealSpace const& spc);
+
+    //! \brief The state space.
+    RealSpace const& state_space() const { return _program.argument_space(); }
+    //! \brief The dimension of the state space.
+    size_t dimension() const { return _program.argument_size(); }
+    //! \brief The size of the workspace of a single evaluation.
+    size_t workspace_size() const { return _program.register_size(); }
+    //! \brief The compiled program, whose results are the new values of all the state variables.
+    RegisterProgram const& program() const { return _program; }
+
+    //! \brief Write the state after the jump from the state \a x into \a y, using \a w as workspace of workspace_size() values.
+    void operator()(const double* x, double* y, double* w) const { _program(x,y,w); }
+    //! \brief Replace the state \a x by the state after the jump, using \a w as workspace of workspace_size() values.
+    void operator()(double* x, double* w) const { _program(x,x,w); }
+    //! \brief The state after the jump from the state \a x, ordered as the state space.
+    Vector<Real> operator()(Vector<Real> const& x) const { return _program(x); }
+    //! \brief The valuation \a x with the state variables replaced by their values after the jump.
+    friend Valuation<Real> evaluate(ResetMap const& r, Valuation<Real> const& x);
+
+    //! \brief Write the states after the jumps from the \a count states stored consecutively in \a x into \a y.
+    void batch(size_t count, const double* x, double* y, unsigned int concurrency=1u) const { _program.batch(count,x,y,concurrency); }
+    //! \brief Replace the \a count states stored consecutively in \a x by the states after the jumps.
+    void batch(size_t count, double* x, unsigned int concurrency=1u) const { _program.batch(count,x,x,concurrency); }
+
+    friend ostream& operator<<(ostream& os, ResetMap const& r) { return os << "ResetMap(" << r._program << ")"; }
+  private:
+    RegisterProgram _program;
+};
+
+} // namespace SymboliCore
+
+#endif /* SYMBOLICORE_PROGRAM_HPP */
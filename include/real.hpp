@@ -52,12 +52,12 @@ class Real
   public:
     Real(); //!< Default constructor yielding \c 0.0
     explicit Real(String const&); //!< Construct from a string literal
-    Real(double val); //!< Construct from raw double
-    Real(const Real&); //!< Copy constructor
+    Real(double val) : _value(val) { } //!< Construct from raw double
+    Real(const Real&) = default; //!< Copy constructor
     Real(Integer const& i); //!< Costruct from Integer
-    Real& operator=(const Real&); //!< %Assignment
+    Real& operator=(const Real&) = default; //!< %Assignment
     String literal() const; //!< A string literal
-    double const& value() const; //!< Builtin value
+    double const& value() const { return _value; } //!< Builtin value
 
     //!@{
     //! \name Arithmetic operators
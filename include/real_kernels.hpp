@@ -0,0 +1,98 @@
+/***************************************************************************
+ *            real_kernels.hpp
+ *
+ *  Copyright  2023  Luca Geretti
+ *
+ ****************************************************************************/
+
+/*
+ * This file is part of SymboliCore, under the MIT license.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*! \file real_kernels.hpp
+ *  \brief Batch evaluation of the elementary operations on spans of Real values.
+ */
+
+#ifndef SYMBOLICORE_REAL_KERNELS_HPP
+#define SYMBOLICORE_REAL_KERNELS_HPP
+
+#include <span>
+
+#include "real.hpp"
+
+namespace SymboliCore {
+
+//! \brief The accuracy tier of a batch transcendental kernel.
+//! \details The \c ACCURATE and \c FAST tiers evaluate the functions with branch-free
+//! polynomial approximations over blocks of values, so that the compiler can vectorise them.
+//! The \c LIBM tier calls the scalar functions of the C library element by element.
+//!
+//! Bounds on the errors measured against the C library, in units in the last place, are:
+//! <table>
+//! <tr><th>Function</th><th>ACCURATE</th><th>FAST</th><th>Notes</th></tr>
+//! <tr><td>exp</td><td>1</td><td>2</td><td>FAST uses a degree-12 polynomial without division</td></tr>
+//! <tr><td>log</td><td>1</td><td>1</td><td>FAST does not support subnormal arguments</td></tr>
+//! <tr><td>sin, cos</td><td>1</td><td>2</td><td>FAST uses a two-part argument reduction</td></tr>
+//! <tr><td>tan</td><td>2</td><td>3</td><td>as sin and cos</td></tr>
+//! <tr><td>atan</td><td>1</td><td>1</td><td>both tiers share a kernel</td></tr>
+//! <tr><td>asin, acos</td><td>2</td><td>2</td><td>both tiers share a kernel</td></tr>
+//! </table>
+//! Arguments of the trigonometric functions with magnitude larger than 2<sup>19</sup>π/2 are
+//! always evaluated by the C library. Special values (NaN, ±∞, ±0) follow the C library in every tier,
+//! apart from subnormal arguments of \c log in the \c FAST tier.
+enum class KernelAccuracy : char { FAST, ACCURATE, LIBM };
+ostream& operator<<(ostream& os, KernelAccuracy acc);
+
+//!@{
+//! \name Batch arithmetic operations
+//! \details The result \a r must have the same size as the arguments, and may coincide with them.
+void nul(std::span<const Real> x, std::span<Real> r); //!< \brief Zero.
+void pos(std::span<const Real> x, std::span<Real> r); //!< \brief Identity.
+void neg(std::span<const Real> x, std::span<Real> r); //!< \brief Negative.
+void hlf(std::span<const Real> x, std::span<Real> r); //!< \brief Half value.
+void sqr(std::span<const Real> x, std::span<Real> r); //!< \brief Square.
+void rec(std::span<const Real> x, std::span<Real> r); //!< \brief Reciprocal.
+void abs(std::span<const Real> x, std::span<Real> r); //!< \brief Absolute value.
+void sqrt(std::span<const Real> x, std::span<Real> r); //!< \brief Square root.
+void add(std::span<const Real> x1, std::span<const Real> x2, std::span<Real> r); //!< \brief Sum.
+void sub(std::span<const Real> x1, std::span<const Real> x2, std::span<Real> r); //!< \brief Difference.
+void mul(std::span<const Real> x1, std::span<const Real> x2, std::span<Real> r); //!< \brief Product.
+void div(std::span<const Real> x1, std::span<const Real> x2, std::span<Real> r); //!< \brief Quotient.
+void min(std::span<const Real> x1, std::span<const Real> x2, std::span<Real> r); //!< \brief Minimum.
+void max(std::span<const Real> x1, std::span<const Real> x2, std::span<Real> r); //!< \brief Maximum.
+void pow(std::span<const Real> x, int n, std::span<Real> r); //!< \brief Power \a x<sup>n</sup>.
+//!@}
+
+//!@{
+//! \name Batch transcendental operations
+//! \details The result \a r must have the same size as the argument \a x, and may coincide with it.
+void exp(std::span<const Real> x, std::span<Real> r, KernelAccuracy acc=KernelAccuracy::ACCURATE);
+void log(std::span<const Real> x, std::span<Real> r, KernelAccuracy acc=KernelAccuracy::ACCURATE);
+void sin(std::span<const Real> x, std::span<Real> r, KernelAccuracy acc=KernelAccuracy::ACCURATE);
+void cos(std::span<const Real> x, std::span<Real> r, KernelAccuracy acc=KernelAccuracy::ACCURATE);
+void tan(std::span<const Real> x, std::span<Real> r, KernelAccuracy acc=KernelAccuracy::ACCURATE);
+void asin(std::span<const Real> x, std::span<Real> r, KernelAccuracy acc=KernelAccuracy::ACCURATE);
+void acos(std::span<const Real> x, std::span<Real> r, KernelAccuracy acc=KernelAccuracy::ACCURATE);
+void atan(std::span<const Real> x, std::span<Real> r, KernelAccuracy acc=KernelAccuracy::ACCURATE);
+//!@}
+
+} // namespace SymboliCore
+
+#endif
@@ -0,0 +1,332 @@
+/***************************************************************************
+ *            real_vector.hpp
+ *
+ *  Copyright  2023  Luca Geretti
+ *
+ ****************************************************************************/
+
+/*
+ * This file is part of SymboliCore, under the MIT license.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*! \file real_vector.hpp
+ *  \brief Vectors of Real values with fused element-wise expressions and vectorisable reductions.
+ */
+
+#ifndef SYMBOLICORE_REAL_VECTOR_HPP
+#define SYMBOLICORE_REAL_VECTOR_HPP
+
+#include <algorithm>
+#include <memory>
+#include <new>
+
+#include "real.hpp"
+#include "operators.hpp"
+#include "vector.hpp"
+
+namespace SymboliCore {
+
+using Helper::Same;
+
+/************ Real vector expressions *********************************************************/
+
+//! \ingroup LinearAlgebraModule
+//! \brief Base of the element-wise expressions over vectors of Real values.
+//! \details Expressions hold their operands by value and are evaluated in a single loop over raw doubles
+//! when converted or assigned to a Vector<Real>. Since vector operands are held by reference,
+//! an expression must not outlive the vectors it refers to.
+template<class E> struct RealVectorExpression {
+    typedef Real ScalarType;
+    E const& operator()() const { return static_cast<E const&>(*this); }
+    //! \brief The \a i<sup>th</sup> element of the expression.
+    Real operator[](size_t i) const { return Real((*this)().value(i)); }
+};
+
+template<class T> struct IsRealVectorExpression : False { };
+template<class T> concept ARealVectorExpression = IsRealVectorExpression<T>::value;
+template<class T> concept ARealVectorOperand = ARealVectorExpression<T> or Same<T,Vector<Real>>;
+
+namespace Detail {
+inline double apply(Pos, double a) { return a; }
+inline double apply(Neg, double a) { return -a; }
+inline double apply(Add, double a1, double a2) { return a1+a2; }
+inline double apply(Sub, double a1, double a2) { return a1-a2; }
+inline double apply(Mul, double a1, double a2) { return a1*a2; }
+inline double apply(Div, double a1, double a2) { return a1/a2; }
+} // namespace Detail
+
+//! \brief A reference to the elements of a Vector<Real> within an expression.
+class RealVectorOperand : public RealVectorExpression<RealVectorOperand> {
+    Real const* _ptr; size_t _size;
+  public:
+    RealVectorOperand(Vector<Real> const& v);
+    size_t size() const { return _size; }
+    double value(size_t i) const { return _ptr[i].value(); }
+};
+template<> struct IsRealVectorExpression<RealVectorOperand> : True { };
+
+template<class OP, class E> class RealVectorUnaryExpression : public RealVectorExpression<RealVectorUnaryExpression<OP,E>> {
+    E _e;
+  public:
+    RealVectorUnaryExpression(E const& e) : _e(e) { }
+    size_t size() const { return _e.size(); }
+    double value(size_t i) const { return Detail::apply(OP(),_e.value(i)); }
+};
+template<class OP, class E> struct IsRealVectorExpression<RealVectorUnaryExpression<OP,E>> : True { };
+
+template<class OP, class E1, class E2> class RealVectorBinaryExpression : public RealVectorExpression<RealVectorBinaryExpression<OP,E1,E2>> {
+    E1 _e1; E2 _e2;
+  public:
+    RealVectorBinaryExpression(E1 const& e1, E2 const& e2) : _e1(e1), _e2(e2) {
+        HELPER_PRECONDITION_MSG(e1.size()==e2.size(),"Vector operands of sizes "<<e1.size()<<" and "<<e2.size()<<" do not match."); }
+    size_t size() const { return _e1.size(); }
+    double value(size_t i) const { return Detail::apply(OP(),_e1.value(i),_e2.value(i)); }
+};
+template<class OP, class E1, class E2> struct IsRealVectorExpression<RealVectorBinaryExpression<OP,E1,E2>> : True { };
+
+//! \brief An expression combining each element of a vector expression with a scalar on the right.
+template<class OP, class E> class RealVectorScalarExpression : public RealVectorExpression<RealVectorScalarExpression<OP,E>> {
+    E _e; double _s;
+  public:
+    RealVectorScalarExpression(E const& e, double s) : _e(e), _s(s) { }
+    size_t size() const { return _e.size(); }
+    double value(size_t i) const { return Detail::apply(OP(),_e.value(i),_s); }
+};
+template<class OP, class E> struct IsRealVectorExpression<RealVectorScalarExpression<OP,E>> : True { };
+
+namespace Detail {
+inline RealVectorOperand real_vector_operand(Vector<Real> const& v) { return RealVectorOperand(v); }
+template<class E> E const& real_vector_operand(RealVectorExpression<E> const& e) { return e(); }
+template<class A> using RealVectorOperandType = RemoveConst<RemoveReference<decltype(real_vector_operand(declval<A>()))>>;
+} // namespace Detail
+
+/************ Vector<Real> *********************************************************/
+
+//! \ingroup LinearAlgebraModule
+//! \brief Vectors of Real values.
+//! \details The elements are stored contiguously in storage aligned to \ref ALIGNMENT bytes.
+//! The arithmetic operators build fused expressions, so that for example <c>r=a*x+y</c> is evaluated
+//! in a single vectorisable loop without temporaries, and the norms and inner product are computed
+//! with independent partial accumulators. Results obtained through the reductions may therefore
+//! differ in the last bits from a sequential summation.
+template<>
+class Vector<Real>
+        : public VectorContainer<Vector<Real>>
+{
+    Real* _ptr;
+    size_t _size;
+  public:
+    //!@{
+    //! \name Type definitions
+    typedef size_t IndexType; //!< <p/>
+    typedef Real ScalarType; //!< <p/>
+    typedef Real ValueType; //!< <p/>
+    //! \brief The alignment in bytes of the element storage.
+    static constexpr size_t ALIGNMENT = 64;
+    //!@}
+
+    //!@{
+    //! \name Constructors
+
+    //! \brief Default constructor constructs a vector with no elements.
+    Vector() : _ptr(nullptr), _size(0u) { }
+    //! \brief Construct a vector of size \a n with uninitialised elements.
+    //! Each element must be assigned before being read.
+    Vector(size_t n, Uninitialised) : _ptr(_allocate(n)), _size(n) { }
+    //! \brief Construct a vector of size \a n, with elements initialised to \a t.
+    explicit Vector(size_t n, Real const& t) : Vector(n,Uninitialised()) { std::uninitialized_fill_n(_ptr,n,t); }
+    //! \brief Construct a vector of \a n zeros.
+    explicit Vector(size_t n) : Vector(n,Real(0.0)) { }
+    //! \brief Construct from an array of the same type.
+    explicit Vector(Array<Real> const& ary) : Vector(ary.size(),[&ary](size_t i){return ary[i];}) { }
+    //! \brief Construct from a list of the same type.
+    explicit Vector(List<Real> const& lst) : Vector(lst.size(),[&lst](size_t i){return lst[i];}) { }
+    //! \brief Convert from an initializer list of the same type.
+    Vector(initializer_list<Real> lst) : Vector(lst.size(),[&lst](size_t i){return lst.begin()[i];}) { }
+    //! \brief Construct from an initializer list of doubles.
+    template<class... PRS> requires (sizeof...(PRS)==0u)
+    explicit Vector(initializer_list<double> const& lst, PRS...) : Vector(lst.size(),[&lst](size_t i){return Real(lst.begin()[i]);}) { }
+    //! \brief Construct from an array of generic type.
+    template<class Y> requires Constructible<Real,Y> and (not Same<Y,Real>)
+    explicit Vector(Array<Y> const& ary) : Vector(ary.size(),[&ary](size_t i){return Real(ary[i]);}) { }
+    //! \brief Construct from an vector of generic type.
+    template<class Y> requires Constructible<Real,Y> and (not Same<Y,Real>)
+    explicit Vector(Vector<Y> const& v) : Vector(v.size(),[&v](size_t i){return Real(v[i]);}) { }
+    //! \brief Convert from a %VectorExpression of a different type.
+    template<class VE> requires Convertible<typename VE::ScalarType,Real>
+    Vector(VectorExpression<VE> const& ve) : Vector(ve().size(),[&ve](size_t i){return Real(ve()[i]);}) { }
+    //! \brief Evaluate a fused element-wise expression.
+    template<class E> Vector(RealVectorExpression<E> const& e) : Vector(e().size(),Uninitialised()) { _assign(e()); }
+    //! \brief Generate from a function (object) \a g of type \a G mapping an index to a value.
+    template<class G> requires InvocableReturning<Real,G,size_t>
+    Vector(size_t n, G const& g) : Vector(n,Uninitialised()) { for(size_t i=0; i!=n; ++i) { new (_ptr+i) Real(g(i)); } }
+
+    //! \brief Copy constructor.
+    Vector(Vector<Real> const& v) : Vector(v._size,Uninitialised()) { std::uninitialized_copy_n(v._ptr,v._size,_ptr); }
+    //! \brief Move constructor.
+    Vector(Vector<Real>&& v) noexcept : _ptr(v._ptr), _size(v._size) { v._ptr=nullptr; v._size=0u; }
+    //! \brief Copy assignment.
+    Vector<Real>& operator=(Vector<Real> const& v) {
+        if(this!=&v) { if(_size!=v._size) { *this=Vector<Real>(v); } else { std::copy_n(v._ptr,v._size,_ptr); } } return *this; }
+    //! \brief Move assignment.
+    Vector<Real>& operator=(Vector<Real>&& v) noexcept { std::swap(_ptr,v._ptr); std::swap(_size,v._size); return *this; }
+    //! \brief Assign a fused element-wise expression, reusing the storage if the sizes match.
+    //! The expression may refer to the vector itself.
+    template<class E> Vector<Real>& operator=(RealVectorExpression<E> const& e) {
+        if(_size!=e().size()) { *this=Vector<Real>(e); } else { _assign(e()); } return *this; }
+    //! \brief Destructor.
+    ~Vector() { _deallocate(_ptr); }
+    //!@}
+
+    //!@{
+    //! \name Static constructors
+
+    //! \brief The zero vector of size \a n.
+    static Vector<Real> zero(size_t n) { return Vector<Real>(n,Real(0.0)); }
+    //! \brief The vector of size \a n with all entries equal to one.
+    static Vector<Real> one(size_t n) { return Vector<Real>(n,Real(1.0)); }
+    //! \brief The unit vector \f$e_i\f$ with value one in the \a i<sup>th</sup> entry, and zero otherwise.
+    static Vector<Real> unit(size_t n, size_t i) {
+        HELPER_ASSERT(i<n); Vector<Real> result(n,Real(0.0)); result[i]=Real(1.0); return result; }
+    //! \brief The standard basis of vectors of size \a n.
+    static Array<Vector<Real>> basis(size_t n) {
+        return Array<Vector<Real>>(n,[n](size_t i){return unit(n,i);}); }
+    //!@}
+
+    //!@{
+    //! \name Data access
+
+    //! \brief Resize to hold \a n elements, preserving the existing ones and setting new ones to zero.
+    void resize(size_t n) {
+        if(n!=_size) { Vector<Real> r(n,[this](size_t i){return i<_size ? _ptr[i] : Real(0.0);}); *this=std::move(r); } }
+    //! \brief The number of elements of the vector.
+    size_t size() const { return _size; }
+    //! \brief A reference to the value stored in the \a i<sup>th</sup> element.
+    Real& at(size_t i) { HELPER_PRECONDITION_MSG(i<this->size(),*this<<"["<<i<<"]"); return _ptr[i]; }
+    //! \brief A constant reference to the value stored in the \a i<sup>th</sup> element.
+    Real const& at(size_t i) const { HELPER_PRECONDITION_MSG(i<this->size(),*this<<"["<<i<<"]"); return _ptr[i]; }
+    //! \brief Get the value stored in the \a i<sup>th</sup> element.
+    Real const& get(size_t i) const { return _ptr[i]; }
+    //! \brief Set the value stored in the \a i<sup>th</sup> element to \a x.
+    void set(size_t i, Real const& x) { _ptr[i] = x; }
+    //! \brief Subscripting operator. Unchecked access.
+    Real& operator[](size_t i) { return _ptr[i]; }
+    //! \brief Constant subscripting operator.
+    Real const& operator[](size_t i) const { return _ptr[i]; }
+    //! \brief Range subscripting operator.
+    VectorRange<Vector<Real>> operator[](Range rng) { return project(*this,rng); }
+    //! \brief Constant range subscripting operator.
+    VectorRange<const Vector<Real>> operator[](Range rng) const { return project(*this,rng); }
+    //! \brief The zero of the ring containing the Vector's elements.
+    Real zero_element() const { return Real(0.0); }
+    //! \brief A copy of the elements as an array.
+    Array<Real> array() const { return Array<Real>(_ptr,_ptr+_size); }
+    //! \brief The contiguous element storage.
+    Real* data() { return _ptr; }
+    //! \brief The contiguous element storage.
+    Real const* data() const { return _ptr; }
+    //!@}
+
+    //!@{
+    //! \name Inplace arithmetic
+    friend Vector<Real>& operator+=(Vector<Real>& v, Vector<Real> const& w) {
+        return v=RealVectorBinaryExpression<Add,RealVectorOperand,RealVectorOperand>(v,w); }
+    friend Vector<Real>& operator-=(Vector<Real>& v, Vector<Real> const& w) {
+        return v=RealVectorBinaryExpression<Sub,RealVectorOperand,RealVectorOperand>(v,w); }
+    template<ARealVectorExpression E> friend Vector<Real>& operator+=(Vector<Real>& v, E const& e) {
+        return v=RealVectorBinaryExpression<Add,RealVectorOperand,E>(v,e); }
+    template<ARealVectorExpression E> friend Vector<Real>& operator-=(Vector<Real>& v, E const& e) {
+        return v=RealVectorBinaryExpression<Sub,RealVectorOperand,E>(v,e); }
+    friend Vector<Real>& operator*=(Vector<Real>& v, Real const& s) {
+        return v=RealVectorScalarExpression<Mul,RealVectorOperand>(v,s.value()); }
+    friend Vector<Real>& operator/=(Vector<Real>& v, Real const& s) {
+        return v=RealVectorScalarExpression<Div,RealVectorOperand>(v,s.value()); }
+    //!@}
+
+    //!@{
+    //! \name Reductions
+    friend Real dot(Vector<Real> const& v1, Vector<Real> const& v2); //!< \brief The inner product.
+    friend Real norm(Vector<Real> const& v); //!< \brief The supremum norm.
+    friend Real sup_norm(Vector<Real> const& v); //!< \brief The supremum norm.
+    friend Real two_norm(Vector<Real> const& v); //!< \brief The Euclidean norm.
+    //!@}
+
+  private:
+    static Real* _allocate(size_t n) {
+        return n==0u ? nullptr : static_cast<Real*>(::operator new(n*sizeof(Real),std::align_val_t(ALIGNMENT))); }
+    static void _deallocate(Real* p) {
+        if(p!=nullptr) { ::operator delete(p,std::align_val_t(ALIGNMENT)); } }
+    template<class E> void _assign(E const& e) {
+        Real* p=_ptr;
+        for(size_t i=0; i!=_size; ++i) { new (p+i) Real(e.value(i)); } }
+};
+
+inline RealVectorOperand::RealVectorOperand(Vector<Real> const& v) : _ptr(v.data()), _size(v.size()) { }
+
+template<class E> ostream& operator<<(ostream& os, RealVectorExpression<E> const& e) {
+    return os << Vector<Real>(e); }
+
+/************ Real vector operators *********************************************************/
+
+// Operations between vectors only are non-templates, so that they are preferred to the generic vector operators
+
+inline RealVectorUnaryExpression<Pos,RealVectorOperand> operator+(Vector<Real> const& v) {
+    return RealVectorUnaryExpression<Pos,RealVectorOperand>(v); }
+inline RealVectorUnaryExpression<Neg,RealVectorOperand> operator-(Vector<Real> const& v) {
+    return RealVectorUnaryExpression<Neg,RealVectorOperand>(v); }
+template<ARealVectorExpression E> RealVectorUnaryExpression<Pos,E> operator+(E const& e) {
+    return RealVectorUnaryExpression<Pos,E>(e); }
+template<ARealVectorExpression E> RealVectorUnaryExpression<Neg,E> operator-(E const& e) {
+    return RealVectorUnaryExpression<Neg,E>(e); }
+
+inline RealVectorBinaryExpression<Add,RealVectorOperand,RealVectorOperand> operator+(Vector<Real> const& v1, Vector<Real> const& v2) {
+    return {v1,v2}; }
+inline RealVectorBinaryExpression<Sub,RealVectorOperand,RealVectorOperand> operator-(Vector<Real> const& v1, Vector<Real> const& v2) {
+    return {v1,v2}; }
+template<ARealVectorOperand A1, ARealVectorOperand A2> requires ARealVectorExpression<A1> or ARealVectorExpression<A2>
+RealVectorBinaryExpression<Add,Detail::RealVectorOperandType<A1>,Detail::RealVectorOperandType<A2>> operator+(A1 const& a1, A2 const& a2) {
+    return {Detail::real_vector_operand(a1),Detail::real_vector_operand(a2)}; }
+template<ARealVectorOperand A1, ARealVectorOperand A2> requires ARealVectorExpression<A1> or ARealVectorExpression<A2>
+RealVectorBinaryExpression<Sub,Detail::RealVectorOperandType<A1>,Detail::RealVectorOperandType<A2>> operator-(A1 const& a1, A2 const& a2) {
+    return {Detail::real_vector_operand(a1),Detail::real_vector_operand(a2)}; }
+
+inline RealVectorScalarExpression<Mul,RealVectorOperand> operator*(Real const& s, Vector<Real> const& v) { return {v,s.value()}; }
+inline RealVectorScalarExpression<Mul,RealVectorOperand> operator*(double s, Vector<Real> const& v) { return {v,s}; }
+inline RealVectorScalarExpression<Mul,RealVectorOperand> operator*(Vector<Real> const& v, Real const& s) { return {v,s.value()}; }
+inline RealVectorScalarExpression<Mul,RealVectorOperand> operator*(Vector<Real> const& v, double s) { return {v,s}; }
+inline RealVectorScalarExpression<Div,RealVectorOperand> operator/(Vector<Real> const& v, Real const& s) { return {v,s.value()}; }
+inline RealVectorScalarExpression<Div,RealVectorOperand> operator/(Vector<Real> const& v, double s) { return {v,s}; }
+template<ARealVectorExpression E> RealVectorScalarExpression<Mul,E> operator*(Real const& s, E const& e) { return {e,s.value()}; }
+template<ARealVectorExpression E> RealVectorScalarExpression<Mul,E> operator*(double s, E const& e) { return {e,s}; }
+template<ARealVectorExpression E> RealVectorScalarExpression<Mul,E> operator*(E const& e, Real const& s) { return {e,s.value()}; }
+template<ARealVectorExpression E> RealVectorScalarExpression<Mul,E> operator*(E const& e, double s) { return {e,s}; }
+template<ARealVectorExpression E> RealVectorScalarExpression<Div,E> operator/(E const& e, Real const& s) { return {e,s.value()}; }
+template<ARealVectorExpression E> RealVectorScalarExpression<Div,E> operator/(E const& e, double s) { return {e,s}; }
+
+Real dot(Vector<Real> const& v1, Vector<Real> const& v2);
+Real norm(Vector<Real> const& v);
+Real sup_norm(Vector<Real> const& v);
+Real two_norm(Vector<Real> const& v);
+
+Vector<Real> join(Vector<Real> const& v1, Vector<Real> const& v2);
+
+} // namespace SymboliCore
+
+#endif // SYMBOLICORE_REAL_VECTOR_HPP
@@ -34,6 +34,11 @@
 #define SYMBOLICORE_SEQUENCE_HPP
 
 #include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <vector>
 
 namespace SymboliCore {
 
@@ -79,6 +84,74 @@ template<class X> class FastCauchySequence : public Sequence<X> {
 };
 
 
+//! \brief The storage of terms of a CachedSequence, shared between its copies.
+//! \details Terms are held in a contiguous buffer, either growing with the largest index requested,
+//! or as a ring of fixed size \a window keeping only the most recently computed terms.
+//! Readers take a shared lock; a missing term is computed without holding the lock,
+//! so the term function may itself read earlier terms of the same sequence.
+template<class X> class SequenceCache {
+    std::function<X(unsigned int)> _fn;
+    std::size_t _window;
+    mutable std::shared_mutex _mutex;
+    std::vector<unsigned int> _indices;
+    std::vector<std::optional<X>> _terms;
+  public:
+    SequenceCache(std::function<X(unsigned int)> const& fn, std::size_t window)
+        : _fn(fn), _window(window), _indices(window), _terms(window) { }
+    std::size_t window() const { return _window; }
+    std::size_t number_of_cached_terms() const {
+        std::shared_lock<std::shared_mutex> lock(_mutex);
+        std::size_t r=0u; for (auto const& t : _terms) { if (t) { ++r; } } return r; }
+    X operator[](unsigned int n) {
+        {
+            std::shared_lock<std::shared_mutex> lock(_mutex);
+            std::optional<X> const* t=this->_find(n);
+            if (t) { return **t; }
+        }
+        X x=_fn(n);
+        {
+            std::unique_lock<std::shared_mutex> lock(_mutex);
+            if (_window==0u) {
+                if (n>=_terms.size()) { _terms.resize(static_cast<std::size_t>(n)+1u); }
+                if (!_terms[n]) { _terms[n].emplace(x); }
+            } else {
+                std::size_t i=n%_window;
+                _indices[i]=n; _terms[i].emplace(x);
+            }
+        }
+        return x;
+    }
+  private:
+    std::optional<X> const* _find(unsigned int n) const {
+        if (_window==0u) { return (n<_terms.size() and _terms[n]) ? &_terms[n] : nullptr; }
+        std::size_t i=n%_window;
+        return (_terms[i] and _indices[i]==n) ? &_terms[i] : nullptr;
+    }
+};
+
+//! \brief A sequence which stores each term when it is first computed.
+//! \details A %CachedSequence is a Sequence, so it may be passed wherever a Sequence, ConvergentSequence
+//! or FastCauchySequence is accepted; copies, including those sliced to a Sequence, share the stored terms.
+//! The cache is safe for concurrent readers. If \a window is nonzero, only the terms at the
+//! \a window most recent indices are kept, bounding the memory used for monotone access.
+template<class X> class CachedSequence : public Sequence<X> {
+    std::shared_ptr<SequenceCache<X>> _cache;
+    CachedSequence(std::shared_ptr<SequenceCache<X>> cache)
+        : Sequence<X>([cache](unsigned int n){ return (*cache)[n]; }), _cache(cache) { }
+  public:
+    //! \brief Cache the terms of the function \a fn, keeping all terms if \a window is zero.
+    explicit CachedSequence(std::function<X(unsigned int)> const& fn, std::size_t window=0u)
+        : CachedSequence(std::make_shared<SequenceCache<X>>(fn,window)) { }
+    //! \brief Cache the terms of the sequence \a seq, keeping all terms if \a window is zero.
+    explicit CachedSequence(Sequence<X> const& seq, std::size_t window=0u)
+        : CachedSequence(std::function<X(unsigned int)>([seq](unsigned int n){ return seq[n]; }),window) { }
+    //! \brief The number of terms kept, or zero if all terms are kept.
+    std::size_t window() const { return _cache->window(); }
+    //! \brief The number of terms currently stored.
+    std::size_t number_of_cached_terms() const { return _cache->number_of_cached_terms(); }
+};
+
+
 using ostream = std::ostream;
 template<class T, class W> class WritableTemporary;
 
@@ -33,9 +33,13 @@
 #ifndef SYMBOLICORE_SPACE_HPP
 #define SYMBOLICORE_SPACE_HPP
 
+#include <atomic>
 #include <cstdarg>
 #include <iosfwd>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
 
 #include "helper/macros.hpp"
 #include "helper/container.hpp"
@@ -70,6 +74,7 @@ typedef Space<Real> RealSpace;
 //! \b Example
 //! \snippet tutorials/symbolic_usage.cpp Space_usage
 //! \see Variable
+//! Lookup of the index of a variable, and hence containment and joining, takes constant time per variable.
 template<class T> class Space
 {
   public:
@@ -98,8 +103,10 @@ template<class T> class Space
     //! \brief A list giving ordered variables.
     List<VariableType> variables() const;
     //! \brief A map giving the index of a given variable.
+    //! \details A copy of a map built on the first request and kept until the space is modified.
     Map<Identifier,size_t> indices_from_names() const;
     //! \brief A map giving the index of a given variable.
+    //! \details A copy of a map built on the first request and kept until the space is modified.
     Map<VariableType,size_t> indices() const;
 
     //! \brief Tests if the variable \a v is in the space.
@@ -118,8 +125,19 @@ template<class T> class Space
     Space<T>& adjoin(const Space<T>& spc);
     //! \brief Append the named variable \a v to the variables defining the space.
     Space<T>& append(const VariableType& v);
+  private:
+    //! \brief The ordered maps of indices, built at most once and shared by copies of the space.
+    struct IndexMaps {
+        std::once_flag names_built, variables_built;
+        std::atomic<bool> requested = false;
+        Map<Identifier,size_t> names;
+        Map<VariableType,size_t> variables;
+    };
+    void _modified();
   private:
     List<Identifier> _variables;
+    std::unordered_map<Identifier,size_t,std::hash<std::string>> _indices;
+    std::shared_ptr<IndexMaps> _maps;
 };
 
 template<class T> ostream& operator<<(ostream& os, const Space<T>& spc) { return os << spc.variables(); }
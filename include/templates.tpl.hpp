@@ -342,14 +342,14 @@ struct IdenticalSymbolic {
 class UntypedVariable;
 
 namespace {
-template<class T> Set<UntypedVariable> _arguments(Constant<T> const& var) { return {}; }
-template<class T> Set<UntypedVariable> _arguments(Variable<T> const& var) { return {var}; }
-template<class OP, class E> Set<UntypedVariable> _arguments(Symbolic<OP,E> const& s) {
-    return s._arg.arguments(); }
-template<class OP, class E1, class E2> Set<UntypedVariable> _arguments(Symbolic<OP,E1,E2> const& s) {
-    return join(s._arg1.arguments(),s._arg2.arguments()); }
-template<class OP, class E1> Set<UntypedVariable> _arguments(Symbolic<OP,E1,int> const& s) {
-    return s._arg.arguments(); }
+template<class T> ArgumentSet _argument_set(Constant<T> const&) { return ArgumentSet(); }
+template<class T> ArgumentSet _argument_set(Variable<T> const& var) { return ArgumentSet(var); }
+template<class OP, class E> ArgumentSet _argument_set(Symbolic<OP,E> const& s) {
+    return s._arg.argument_set(); }
+template<class OP, class E1, class E2> ArgumentSet _argument_set(Symbolic<OP,E1,E2> const& s) {
+    return join(s._arg1.argument_set(),s._arg2.argument_set()); }
+template<class OP, class E1> ArgumentSet _argument_set(Symbolic<OP,E1,int> const& s) {
+    return s._arg.argument_set(); }
 }
 
 namespace {
@@ -35,6 +35,7 @@
 
 #include <cstdarg>
 #include <iostream>
+#include <span>
 #include <string>
 
 #include "helper/macros.hpp"
@@ -42,6 +43,7 @@
 
 #include "integer.hpp"
 #include "variable.hpp"
+#include "space.hpp"
 #include "expression.hpp"
 
 namespace SymboliCore {
@@ -55,6 +57,7 @@ template<class X> Pair<Variable<X>,X> operator|(const Variable<X>& v, const type
 template<class X> Pair<Variable<X>,X> operator|(const Variable<X>& v, const Constant<X>& c) { return Pair<Variable<X>,X>(v,c.value()); }
 
 template<class T, class X> class Valuation;
+template<class T, class X> class ValuationView;
 
 typedef Space<Real> RealSpace;
 //! \relates Valuation \brief A Valuation taking integer values.
@@ -112,6 +115,54 @@ class Valuation
     Map<Identifier,ValueType> _values;
 };
 
+//! \ingroup SymbolicModule
+//! \brief A non-owning valuation of the variables of a space, whose values are held in the order of the space
+//!   in a contiguous buffer owned by the caller.
+//! \details Neither the values nor the space are copied, so both must outlive the view.
+//! The value of a variable is found through the index of the space, in constant time.
+//! \see Valuation, Space
+template<class T, class X>
+class ValuationView
+{
+  public:
+    //! \brief The abstract mathematical type represented by variables.
+    typedef T Type;
+    //! \brief The concrete class of the values of the variables.
+    typedef X ValueType;
+  public:
+    //! \brief Construct a view of the values \a values of the variables of \a spc.
+    ValuationView(std::span<const X> values, Space<T> const& spc) : _values(values), _spc(&spc) {
+        HELPER_PRECONDITION_MSG(values.size()==spc.dimension(),"A buffer of "<<values.size()<<" values cannot hold a valuation of the space "<<spc); }
+    //! \brief Construct a view of the \a n values starting at \a ptr.
+    ValuationView(X const* ptr, size_t n, Space<T> const& spc) : ValuationView(std::span<const X>(ptr,n),spc) { }
+    //! \brief The space of the variables.
+    Space<T> const& space() const { return *_spc; }
+    //! \brief The values, in the order of the variables of the space.
+    std::span<const X> values() const { return _values; }
+    //! \brief The number of variables.
+    size_t size() const { return _values.size(); }
+    //! \brief Tests if the variable \a v has a value.
+    bool has_key(const Variable<Type>& v) const { return _spc->contains(v); }
+    //! \brief Get the value associated with variable \a v.
+    const ValueType& get(const Variable<Type>& v) const { return _values[_spc->index(v)]; }
+    //! \brief Extract the value associated with the variable named \a nm.
+    const ValueType& operator[](const Identifier& nm) const { return _values[_spc->index(nm)]; }
+    //! \brief Extract the value associated with the variable \a v.
+    const ValueType& operator[](const Variable<Type>& v) const { return _values[_spc->index(v)]; }
+  private:
+    std::span<const X> _values;
+    Space<T> const* _spc;
+};
+
+template<class T, class X> inline ostream& operator<<(ostream& os, const ValuationView<T,X>& val) {
+    os << '(';
+    for(size_t i=0; i!=val.size(); ++i) {
+        if(i!=0u) { os << ','; }
+        os << val.space()[i] << '|' << val.values()[i];
+    }
+    return os << ')';
+}
+
 template<class T, class X> bool operator==(const Valuation<T,X>& v1, const Valuation<T,X>& v2) {
     bool identical = true;
     const Map<Identifier,X>& v1sm=v1.values();
@@ -36,6 +36,8 @@
 #include <cstdarg>
 #include <iosfwd>
 #include <iostream>
+#include <memory>
+#include <vector>
 
 #include "helper/macros.hpp"
 #include "helper/string.hpp"
@@ -48,6 +50,7 @@
 namespace SymboliCore {
 
 using Helper::List;
+using Helper::Set;
 using Helper::to_str;
 using std::initializer_list;
 
@@ -98,6 +101,51 @@ class UntypedVariable {
 };
 
 
+//! \brief The index of a variable in the global table of the variables used in expressions.
+typedef unsigned int VariableIndex;
+
+//! \brief The index of the variable \a v, adding it to the table if it has not been seen before.
+//! \details Variables with the same name but different types have different indices. Thread-safe.
+VariableIndex intern(const UntypedVariable& v);
+//! \brief The variable with index \a i.
+UntypedVariable interned_variable(VariableIndex i);
+
+//! \ingroup SymbolicModule
+//! \brief A set of variables, held as a sorted array of their interned indices.
+//! \details The array is immutable and shared between copies, so that the arguments of an expression
+//! can be cached in each node at the cost of one pointer when a node has the same arguments as one of its children.
+//! \see intern
+class ArgumentSet {
+  public:
+    //! \brief The empty set.
+    ArgumentSet() : _ids() { }
+    //! \brief The set containing only the variable \a v.
+    explicit ArgumentSet(const UntypedVariable& v);
+
+    //! \brief The number of variables.
+    size_t size() const { return _ids ? _ids->size() : 0u; }
+    //! \brief Tests if the set has no variables.
+    bool empty() const { return size()==0u; }
+    //! \brief The sorted indices of the variables.
+    VariableIndex const* begin() const { return _ids ? _ids->data() : nullptr; }
+    VariableIndex const* end() const { return _ids ? _ids->data()+_ids->size() : nullptr; }
+    //! \brief Tests if the variable with index \a i is in the set, in logarithmic time.
+    bool contains(VariableIndex i) const;
+    //! \brief Tests if the variable \a v is in the set.
+    bool contains(const UntypedVariable& v) const;
+    //! \brief The variables of the set.
+    Set<UntypedVariable> variables() const;
+
+    //! \brief The union of \a as1 and \a as2, in linear time; shares the indices of an argument when possible.
+    friend ArgumentSet join(const ArgumentSet& as1, const ArgumentSet& as2);
+    friend bool operator==(const ArgumentSet& as1, const ArgumentSet& as2);
+    friend ostream& operator<<(ostream& os, const ArgumentSet& as);
+  private:
+    explicit ArgumentSet(std::shared_ptr<const std::vector<VariableIndex>> ids) : _ids(std::move(ids)) { }
+  private:
+    std::shared_ptr<const std::vector<VariableIndex>> _ids;
+};
+
 //! \ingroup SymbolicModule
 //! \brief A named variable of type \a T.
 //! We support variables of type Boolean, Kleenean, String, Integer and Real.
@@ -0,0 +1,172 @@
+/***************************************************************************
+ *            variables_box.hpp
+ *
+ *  Copyright  2023  Luca Geretti
+ *
+ ****************************************************************************/
+
+/*
+ * This file is part of SymboliCore, under the MIT license.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*! \file variables_box.hpp
+ *  \brief Boxes in named real variables, and their evaluation on expressions.
+ */
+
+#ifndef SYMBOLICORE_VARIABLES_BOX_HPP
+#define SYMBOLICORE_VARIABLES_BOX_HPP
+
+#include <iosfwd>
+#include <initializer_list>
+
+#include "helper/macros.hpp"
+#include "helper/container.hpp"
+#include "interval.hpp"
+#include "variable.hpp"
+#include "expression.hpp"
+
+namespace SymboliCore {
+
+using Helper::List;
+using Helper::Map;
+using Helper::Set;
+using std::initializer_list;
+
+//! \brief A lower bound \a l≤x on a real variable \a x.
+template<class UB> class VariableLowerInterval {
+  public:
+    VariableLowerInterval(UB const& l, Variable<Real> const& v) : _lower(l), _variable(v) { }
+    UB const& lower_bound() const { return _lower; } //!< <p/>
+    Variable<Real> const& variable() const { return _variable; } //!< <p/>
+    friend ostream& operator<<(ostream& os, VariableLowerInterval<UB> const& vivl) {
+        return os << vivl._lower << "<=" << vivl._variable; }
+  private:
+    UB _lower;
+    Variable<Real> _variable;
+};
+
+//! \brief An upper bound \a x≤u on a real variable \a x.
+template<class UB> class VariableUpperInterval {
+  public:
+    VariableUpperInterval(Variable<Real> const& v, UB const& u) : _variable(v), _upper(u) { }
+    Variable<Real> const& variable() const { return _variable; } //!< <p/>
+    UB const& upper_bound() const { return _upper; } //!< <p/>
+    friend ostream& operator<<(ostream& os, VariableUpperInterval<UB> const& vivl) {
+        return os << vivl._variable << "<=" << vivl._upper; }
+  private:
+    Variable<Real> _variable;
+    UB _upper;
+};
+
+//! \brief A pair of bounds \a l≤x≤u on a real variable \a x.
+template<class UB> class VariableInterval {
+  public:
+    VariableInterval(Variable<Real> const& v, Interval<UB> const& ivl) : _variable(v), _interval(ivl) { }
+    VariableInterval(UB const& l, Variable<Real> const& v, UB const& u) : _variable(v), _interval(l,u) { }
+    VariableInterval(VariableLowerInterval<UB> const& lv, UB const& u) : VariableInterval(lv.lower_bound(),lv.variable(),u) { }
+    VariableInterval(UB const& l, VariableUpperInterval<UB> const& uv) : VariableInterval(l,uv.variable(),uv.upper_bound()) { }
+    Variable<Real> const& variable() const { return _variable; } //!< <p/>
+    Interval<UB> const& interval() const { return _interval; } //!< <p/>
+    UB const& lower_bound() const { return _interval.lower_bound(); } //!< <p/>
+    UB const& upper_bound() const { return _interval.upper_bound(); } //!< <p/>
+    friend ostream& operator<<(ostream& os, VariableInterval<UB> const& vivl) {
+        return os << vivl.lower_bound() << "<=" << vivl._variable << "<=" << vivl.upper_bound(); }
+  private:
+    Variable<Real> _variable;
+    Interval<UB> _interval;
+};
+
+//! \brief Complete a lower bound \a l≤x into the bounds \a l≤x≤u.
+template<class UB> VariableInterval<UB> operator<=(VariableLowerInterval<UB> const& lv, UB const& u) { return VariableInterval<UB>(lv,u); }
+//! \brief Complete an upper bound \a x≤u into the bounds \a l≤x≤u.
+template<class UB> VariableInterval<UB> operator<=(UB const& l, VariableUpperInterval<UB> const& uv) { return VariableInterval<UB>(l,uv); }
+
+//! \brief A box in named real variables, given by an interval of type \a IVL for each variable.
+//! \details Variables are looked up by name, in the same way as for a Valuation.
+//! \see Valuation, Space
+template<class IVL> class VariablesBox {
+  public:
+    typedef IVL IntervalType;
+    typedef typename IVL::UpperBoundType UpperBoundType;
+    typedef typename Map<Identifier,IVL>::const_iterator ConstIterator;
+  public:
+    //! \brief The box in no variables.
+    VariablesBox() { }
+    //! \brief Construct from a mapping from variables to intervals.
+    VariablesBox(Map<Variable<Real>,IVL> const& bnds) {
+        for (auto const& b : bnds) { this->insert(b.first,b.second); } }
+    //! \brief Construct from a list of bounds on variables.
+    VariablesBox(List<VariableInterval<UpperBoundType>> const& bnds) {
+        for (auto const& b : bnds) { this->insert(b.variable(),b.interval()); } }
+    VariablesBox(initializer_list<VariableInterval<UpperBoundType>> const& bnds) {
+        for (auto const& b : bnds) { this->insert(b.variable(),b.interval()); } }
+
+    //! \brief %Set the interval for variable \a v to \a ivl.
+    void insert(Variable<Real> const& v, IVL const& ivl) { _bounds[v.name()]=ivl; }
+    //! \brief The number of variables.
+    size_t dimension() const { return _bounds.size(); }
+    //! \brief Tests whether the variable \a v is bounded by the box.
+    bool has_variable(Variable<Real> const& v) const { return _bounds.find(v.name())!=_bounds.end(); }
+    //! \brief Tests whether the interval of some variable is empty.
+    bool is_empty() const {
+        for (auto const& b : _bounds) { if (b.second.is_empty()) { return true; } } return false; }
+    //! \brief The variables bounded by the box.
+    Set<Variable<Real>> variables() const {
+        Set<Variable<Real>> r; for (auto const& b : _bounds) { r.insert(Variable<Real>(b.first)); } return r; }
+    //! \brief The interval for the variable \a v.
+    IVL const& operator[](Variable<Real> const& v) const { return (*this)[v.name()]; }
+    IVL const& operator[](Identifier const& nm) const {
+        auto iter=_bounds.find(nm);
+        HELPER_ASSERT_MSG(iter!=_bounds.end(),"Variable "<<nm<<" is not in the box "<<*this);
+        return iter->second; }
+    IVL& operator[](Variable<Real> const& v) { return _bounds[v.name()]; }
+    //! \brief The intervals, by variable name.
+    Map<Identifier,IVL> const& bounds() const { return _bounds; }
+    ConstIterator begin() const { return _bounds.begin(); }
+    ConstIterator end() const { return _bounds.end(); }
+
+    friend ostream& operator<<(ostream& os, VariablesBox<IVL> const& bx) {
+        os << "{"; bool first=true;
+        for (auto const& b : bx._bounds) { os << (first?"":",") << b.first << ":" << b.second; first=false; }
+        return os << "}"; }
+  private:
+    Map<Identifier,IVL> _bounds;
+};
+
+//!@{
+//! \name Evaluation over boxes.
+//! \related VariablesBox
+
+//! \brief An enclosure of the range of \a e over the box \a bx.
+//! \details Each distinct node of \a e is evaluated once, using outward-rounded interval arithmetic.
+RealInterval evaluate(Expression<Real> const& e, RealVariablesBox const& bx);
+//! \brief Check the predicate \a p over the box \a bx, yielding \a TRUE or \a FALSE only if it holds or fails at all points.
+ValidatedKleenean evaluate(Expression<Kleenean> const& p, RealVariablesBox const& bx);
+
+//! \brief Enclosures of the range of \a e over each of the boxes \a bxs.
+//! \details The expression is translated once, and the working storage is shared between the boxes.
+List<RealInterval> evaluate(Expression<Real> const& e, List<RealVariablesBox> const& bxs);
+//! \brief Check the predicate \a p over each of the boxes \a bxs.
+List<ValidatedKleenean> evaluate(Expression<Kleenean> const& p, List<RealVariablesBox> const& bxs);
+//!@}
+
+} // namespace SymboliCore
+
+#endif /* SYMBOLICORE_VARIABLES_BOX_HPP */
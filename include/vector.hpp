@@ -82,6 +82,9 @@ template<class X> class Vector;
 template<class X> class Covector;
 template<class X> class Matrix;
 
+class Real;
+template<> class Vector<Real>;
+
 template<class V> struct IsVector : False { };
 template<class V> struct IsVectorExpression : IsVector<V> { };
 
@@ -127,11 +130,13 @@ template<class PR> PR make_default_precision();
 
 template<class X> X make_zero() {
     if constexpr (DefaultConstructible<X>) { return X(); }
-    typedef typename X::PrecisionType PR;
-    if constexpr (Constructible<X,PR>) {
-        PR pr=make_default_precision<PR>(); return X(pr);
-    } else {
-        abort();
+    else {
+        typedef typename X::PrecisionType PR;
+        if constexpr (Constructible<X,PR>) {
+            PR pr=make_default_precision<PR>(); return X(pr);
+        } else {
+            abort();
+        }
     }
 }
 
@@ -793,4 +798,6 @@ Vector<X>::Vector(initializer_list<double> const& lst, PRS... prs)
 
 } // namespace SymboliCore
 
+#include "real_vector.hpp"
+
 #endif // HELPER_VECTOR_HPP
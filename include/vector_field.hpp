@@ -0,0 +1,109 @@
+/***************************************************************************
+ *            vector_field.hpp
+ *
+ *  Copyright  2023  Luca Geretti
+ *
+ ****************************************************************************/
+
+/*
+ * This file is part of SymboliCore, under the MIT license.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+/*! \file vector_field.hpp
+ *  \brief Compiled vector fields of ordinary differential equations.
+ */
+
+#ifndef SYMBOLICORE_VECTOR_FIELD_HPP
+#define SYMBOLICORE_VECTOR_FIELD_HPP
+
+#include "real.hpp"
+#include "vector.hpp"
+#include "matrix.hpp"
+#include "expression.hpp"
+#include "assignment.hpp"
+#include "space.hpp"
+#include "valuation.hpp"
+#include "dependency.hpp"
+#include "program.hpp"
+
+namespace SymboliCore {
+
+//! \brief The vector field \f$f:\R^n\to\R^n\f$ of the differential equations \f$\dot{x}=f(x)\f$ over a state space,
+//! compiled for fast evaluation of \f$f\f$ and of its Jacobian derivative \f$Df\f$.
+//! \details The entries of the Jacobian are the symbolic derivatives of the right-hand sides, restricted to the
+//! dependency pattern. They are compiled together with \f$f\f$ into a single RegisterProgram, so that the derivatives
+//! reuse the subexpressions of \f$f\f$; the evaluation of \f$f\f$ alone uses the same program with the Jacobian removed.
+//! The raw evaluations take a caller workspace of workspace_size() values and do not allocate.
+class VectorField {
+  public:
+    //! \brief Compile the \a dynamics, which must give the derivative of each variable of \a spc exactly once.
+    //! \details Throws a \c std::runtime_error if a variable is not in \a spc, has more than one derivative, or none.
+    VectorField(DottedRealAssignments const& dynamics, RealSpace const& spc);
+    //! \brief Compile the \a dynamics, whose right-hand sides may also use the sorted \a auxiliary assignments.
+    VectorField(List<RealAssignment> const& auxiliary, DottedRealAssignments const& dynamics, RealSpace const& spc);
+
+    //! \brief The state space.
+    RealSpace const& state_space() const { return _field.argument_space(); }
+    //! \brief The dimension of the state space.
+    size_t dimension() const { return _field.argument_size(); }
+    //! \brief The size of the workspace of a single evaluation.
+    size_t workspace_size() const;
+    //! \brief The right-hand sides, ordered as the state space.
+    Vector<RealExpression> const& expressions() const { return _expressions; }
+    //! \brief The pattern of the nonzero entries of the Jacobian.
+    DependencyPattern const& jacobian_pattern() const { return _pattern; }
+    //! \brief The program evaluating \f$f\f$.
+    RegisterProgram const& program() const { return _field; }
+    //! \brief The program evaluating \f$f\f$ followed by the nonzero entries of \f$Df\f$, row by row.
+    RegisterProgram const& jacobian_program() const { return _fused; }
+
+    //! \brief Write \f$f(x)\f$ into \a f, using \a w as workspace.
+    void operator()(const double* x, double* f, double* w) const { _field(x,f,w); }
+    //! \brief The value \f$f(x)\f$ at the state \a x ordered as the state space.
+    Vector<Real> operator()(Vector<Real> const& x) const { return _field(x); }
+    //! \brief The value of the vector field \a vf at the state given by the valuation \a x.
+    friend Vector<Real> evaluate(VectorField const& vf, Valuation<Real> const& x) { return evaluate(vf._field,x); }
+
+    //! \brief Write \f$f(x)\f$ into \a f and the Jacobian \f$Df(x)\f$ into \a df as a dense row-major matrix, using \a w as workspace.
+    void jacobian(const double* x, double* f, double* df, double* w) const;
+    //! \brief Write \f$f(x)\f$ into \a f and the nonzero entries of \f$Df(x)\f$ into \a values, ordered as the columns of the jacobian_pattern().
+    void sparse_jacobian(const double* x, double* f, double* values, double* w) const;
+    //! \brief The Jacobian \f$Df(x)\f$ at the state \a x ordered as the state space.
+    Matrix<Real> jacobian(Vector<Real> const& x) const;
+
+    //! \brief Write the values of \f$f\f$ at the \a count states stored consecutively in \a x consecutively into \a f.
+    //! \see RegisterProgram::batch
+    void batch(size_t count, const double* x, double* f, unsigned int concurrency=1u) const { _field.batch(count,x,f,concurrency); }
+    //! \brief Write the values of \f$f\f$ at the \a count states stored consecutively in \a x consecutively into \a f,
+    //! using \a w as workspace of batch_workspace_size() values.
+    void batch(size_t count, const double* x, double* f, std::span<double> w) const { _field.batch(count,x,f,w); }
+    //! \brief The size of the workspace of a batch evaluation.
+    size_t batch_workspace_size() const { return _field.batch_workspace_size(); }
+
+    friend ostream& operator<<(ostream& os, VectorField const& vf);
+  private:
+    Vector<RealExpression> _expressions;
+    DependencyPattern _pattern;
+    RegisterProgram _field;
+    RegisterProgram _fused;
+};
+
+} // namespace SymboliCore
+
+#endif /* SYMBOLICORE_VECTOR_FIELD_HPP */
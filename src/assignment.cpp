@@ -0,0 +1,177 @@
+/***************************************************************************
+ *            assignment.cpp
+ *
+ *  Copyright  2023  Luca Geretti
+ *
+ ****************************************************************************/
+
+/*
+ * This file is part of SymboliCore, under the MIT license.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*! \file assignment.cpp
+ *  \brief Assignment expressions
+ */
+
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
+#include "real.hpp"
+#include "vector.hpp"
+#include "expression.hpp"
+#include "assignment.hpp"
+
+namespace SymboliCore {
+
+namespace {
+
+// The dependency graph of a list of assignments: the successors of an assignment are the assignments
+// whose variables occur in its right-hand side, in compressed row storage
+struct AssignmentGraph {
+    std::vector<size_t> offsets;
+    std::vector<size_t> targets;
+    size_t size() const { return offsets.size()-1u; }
+};
+
+AssignmentGraph assignment_graph(List<RealAssignment> const& asg) {
+    std::unordered_map<VariableIndex,size_t> assigned; assigned.reserve(asg.size());
+    for(size_t k=0; k!=asg.size(); ++k) {
+        bool inserted=assigned.emplace(intern(asg[k].lhs),k).second;
+        HELPER_PRECONDITION_MSG(inserted,"Variable "<<asg[k].lhs<<" is assigned more than once.");
+    }
+    AssignmentGraph g;
+    g.offsets.reserve(asg.size()+1u); g.offsets.push_back(0u);
+    for(size_t k=0; k!=asg.size(); ++k) {
+        for(auto id : asg[k].rhs.argument_set()) {
+            auto iter=assigned.find(id);
+            if(iter!=assigned.end()) { g.targets.push_back(iter->second); }
+        }
+        g.offsets.push_back(g.targets.size());
+    }
+    return g;
+}
+
+// The strongly connected components of the graph by Tarjan's algorithm, with an explicit call stack.
+// Each component is emitted after all the components it depends on, so that the emission order is a topological order
+// when there are no cycles; the roots are taken in increasing order, so that a sorted list is unchanged.
+template<class F> void strong_components(AssignmentGraph const& g, F const& emit) {
+    constexpr size_t UNVISITED=static_cast<size_t>(-1);
+    size_t n=g.size();
+    std::vector<size_t> index(n,UNVISITED), low(n,0u);
+    std::vector<bool> on_stack(n,false);
+    std::vector<size_t> stack;
+    std::vector<std::pair<size_t,size_t>> calls;
+    size_t counter=0;
+    for(size_t root=0; root!=n; ++root) {
+        if(index[root]!=UNVISITED) { continue; }
+        index[root]=low[root]=counter++; stack.push_back(root); on_stack[root]=true;
+        calls.emplace_back(root,g.offsets[root]);
+        while(!calls.empty()) {
+            size_t v=calls.back().first;
+            size_t& pos=calls.back().second;
+            if(pos!=g.offsets[v+1]) {
+                size_t w=g.targets[pos++];
+                if(index[w]==UNVISITED) {
+                    index[w]=low[w]=counter++; stack.push_back(w); on_stack[w]=true;
+                    calls.emplace_back(w,g.offsets[w]);
+                } else if(on_stack[w]) {
+                    low[v]=std::min(low[v],index[w]);
+                }
+                continue;
+            }
+            calls.pop_back();
+            if(!calls.empty()) { size_t u=calls.back().first; low[u]=std::min(low[u],low[v]); }
+            if(low[v]==index[v]) {
+                auto first=std::find(stack.rbegin(),stack.rend(),v).base()-1;
+                std::vector<size_t> component(first,stack.end());
+                stack.erase(first,stack.end());
+                for(auto w : component) { on_stack[w]=false; }
+                emit(component);
+            }
+        }
+    }
+}
+
+bool is_loop(AssignmentGraph const& g, std::vector<size_t> const& component) {
+    if(component.size()>1u) { return true; }
+    size_t v=component.front();
+    return std::find(g.targets.begin()+static_cast<std::ptrdiff_t>(g.offsets[v]),
+                     g.targets.begin()+static_cast<std::ptrdiff_t>(g.offsets[v+1]),v)
+        !=g.targets.begin()+static_cast<std::ptrdiff_t>(g.offsets[v+1]);
+}
+
+// The topological order of the assignments, throwing if there are algebraic loops
+std::vector<size_t> topological_order(List<RealAssignment> const& asg, AssignmentGraph const& g, const char* function) {
+    std::vector<size_t> order; order.reserve(g.size());
+    List<List<RealVariable>> loops;
+    strong_components(g,[&](std::vector<size_t> const& component){
+        if(is_loop(g,component)) {
+            List<RealVariable> loop;
+            for(auto k : component) { loop.push_back(asg[k].lhs); }
+            loops.push_back(loop);
+        } else {
+            order.push_back(component.front());
+        }
+    });
+    if(!loops.empty()) {
+        HELPER_THROW(std::runtime_error,function,"The assignments contain "<<loops.size()<<" algebraic loop(s), with variables "<<loops);
+    }
+    return order;
+}
+
+} // namespace
+
+List<RealAssignment> algebraic_sort(const List<RealAssignment>& assignments) {
+    AssignmentGraph g=assignment_graph(assignments);
+    std::vector<size_t> order=topological_order(assignments,g,"algebraic_sort(List<RealAssignment>)");
+    List<RealAssignment> r; r.reserve(order.size());
+    for(auto k : order) { r.push_back(assignments[k]); }
+    return r;
+}
+
+List<List<RealVariable>> algebraic_loops(const List<RealAssignment>& assignments) {
+    AssignmentGraph g=assignment_graph(assignments);
+    List<List<RealVariable>> loops;
+    strong_components(g,[&](std::vector<size_t> const& component){
+        if(is_loop(g,component)) {
+            List<RealVariable> loop;
+            for(auto k : component) { loop.push_back(assignments[k].lhs); }
+            loops.push_back(loop);
+        }
+    });
+    return loops;
+}
+
+List<List<RealAssignment>> algebraic_levels(const List<RealAssignment>& assignments) {
+    AssignmentGraph g=assignment_graph(assignments);
+    std::vector<size_t> order=topological_order(assignments,g,"algebraic_levels(List<RealAssignment>)");
+    std::vector<size_t> level(g.size(),0u);
+    size_t number_of_levels=0;
+    for(auto k : order) {
+        for(size_t p=g.offsets[k]; p!=g.offsets[k+1]; ++p) { level[k]=std::max(level[k],level[g.targets[p]]+1u); }
+        number_of_levels=std::max(number_of_levels,level[k]+1u);
+    }
+    List<List<RealAssignment>> r; r.resize(number_of_levels);
+    for(auto k : order) { r[level[k]].push_back(assignments[k]); }
+    return r;
+}
+
+} // namespace SymboliCore
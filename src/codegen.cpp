@@ -0,0 +1,322 @@
+/***************************************************************************
+ *            codegen.cpp
+ *
+ *  Copyright  2023  Luca Geretti
+ *
+ ****************************************************************************/
+
+/*
+ * This file is part of SymboliCore, under the MIT license.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*! \file codegen.cpp
+ *  \brief Generation of native code for expressions.
+ */
+
+#include <atomic>
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <fstream>
+#include <filesystem>
+#include <functional>
+#include <map>
+
+#if defined(_WIN32)
+#else
+#include <dlfcn.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "helper/macros.hpp"
+#include "helper/string.hpp"
+#include "helper/container.hpp"
+#include "codegen.hpp"
+
+namespace SymboliCore {
+
+using Helper::to_string;
+
+namespace {
+
+struct ExpressionOrder {
+    bool operator()(Expression<Real> const& e1, Expression<Real> const& e2) const { return before(e1,e2); }
+};
+
+String c_literal(double v) {
+    if (std::isnan(v)) { return "NAN"; }
+    if (std::isinf(v)) { return v>0 ? "INFINITY" : "(-INFINITY)"; }
+    std::ostringstream ss; ss << std::hexfloat << v;
+    if (v<0) { return "("+ss.str()+")"; } else { return ss.str(); }
+}
+
+//! \brief Writes the body of a straight-line function, holding each distinct subexpression in a temporary.
+class CSourceWriter {
+    RealSpace const& _spc;
+    std::map<void const*,String> _by_pointer;
+    std::map<Expression<Real>,String,ExpressionOrder> _by_structure;
+    std::ostringstream _body;
+    size_t _num_temporaries;
+  public:
+    CSourceWriter(RealSpace const& spc) : _spc(spc), _num_temporaries(0u) { }
+    String operand(Expression<Real> const& e);
+    void assign(size_t i, Expression<Real> const& e) { String r=operand(e); _body << "    y[" << i << "] = " << r << ";\n"; }
+    String body() const { return _body.str(); }
+  private:
+    String _unary(OperatorCode code, String const& a);
+    String _binary(OperatorCode code, String const& a1, String const& a2);
+};
+
+String CSourceWriter::_unary(OperatorCode code, String const& a) {
+    switch(code) {
+        case OperatorCode::NUL: return "0.0";
+        case OperatorCode::POS: return "+"+a;
+        case OperatorCode::NEG: return "-"+a;
+        case OperatorCode::HLF: return a+"/2";
+        case OperatorCode::REC: return "1.0/"+a;
+        case OperatorCode::SQR: return a+"*"+a;
+        case OperatorCode::SQRT: return "sqrt("+a+")";
+        case OperatorCode::EXP: return "exp("+a+")";
+        case OperatorCode::LOG: return "log("+a+")";
+        case OperatorCode::SIN: return "sin("+a+")";
+        case OperatorCode::COS: return "cos("+a+")";
+        case OperatorCode::TAN: return "tan("+a+")";
+        case OperatorCode::ASIN: return "asin("+a+")";
+        case OperatorCode::ACOS: return "acos("+a+")";
+        case OperatorCode::ATAN: return "atan("+a+")";
+        case OperatorCode::ABS: return "fabs("+a+")";
+        default: HELPER_FAIL_MSG("Cannot generate code for unary operator "<<code);
+    }
+}
+
+String CSourceWriter::_binary(OperatorCode code, String const& a1, String const& a2) {
+    switch(code) {
+        case OperatorCode::ADD: return a1+"+"+a2;
+        case OperatorCode::SUB: return a1+"-"+a2;
+        case OperatorCode::MUL: return a1+"*"+a2;
+        case OperatorCode::DIV: return a1+"/"+a2;
+        // Same semantics as std::max and std::min, used for the evaluation of Real
+        case OperatorCode::MAX: return "("+a1+"<"+a2+") ? "+a2+" : "+a1;
+        case OperatorCode::MIN: return "("+a2+"<"+a1+") ? "+a2+" : "+a1;
+        default: HELPER_FAIL_MSG("Cannot generate code for binary operator "<<code);
+    }
+}
+
+String CSourceWriter::operand(Expression<Real> const& e) {
+    auto piter=_by_pointer.find(e.node_raw_ptr());
+    if (piter!=_by_pointer.end()) { return piter->second; }
+
+    String r;
+    if (e.code()==OperatorCode::CNST) {
+        r=c_literal(e.val().value());
+    } else if (e.code()==OperatorCode::VAR) {
+        HELPER_ASSERT_MSG(_spc.contains(RealVariable(e.var())),"Variable "<<e.var()<<" is not in the space "<<_spc);
+        r="x["+to_string(_spc.index(e.var()))+"]";
+    } else {
+        auto siter=_by_structure.find(e);
+        if (siter!=_by_structure.end()) {
+            r=siter->second;
+        } else {
+            String value;
+            switch(e.kind()) {
+                case OperatorKind::UNARY: value=_unary(e.code(),operand(e.arg())); break;
+                case OperatorKind::BINARY: { String a1=operand(e.arg1()); value=_binary(e.code(),a1,operand(e.arg2())); break; }
+                case OperatorKind::GRADED: value="pow("+operand(e.arg())+","+to_string(e.num())+")"; break;
+                default: HELPER_FAIL_MSG("Cannot generate code for expression "<<e);
+            }
+            r="t"+to_string(_num_temporaries++);
+            _body << "    const double " << r << " = " << value << ";\n";
+            _by_structure.insert(std::make_pair(e,r));
+        }
+    }
+    _by_pointer.insert(std::make_pair(e.node_raw_ptr(),r));
+    return r;
+}
+
+String getenv_or(const char* variable, String const& fallback) {
+    const char* value=std::getenv(variable);
+    return (value!=nullptr && value[0]!='\0') ? String(value) : fallback;
+}
+
+//! \brief The per-user directory for cached libraries, in the XDG cache directory if available.
+String default_cache_directory() {
+#if defined(_WIN32)
+    return (std::filesystem::temp_directory_path()/"symbolicore-codegen").string();
+#else
+    String xdg_cache=getenv_or("XDG_CACHE_HOME","");
+    if (not xdg_cache.empty()) { return (std::filesystem::path(xdg_cache)/"symbolicore-codegen").string(); }
+    String home=getenv_or("HOME","");
+    if (not home.empty()) { return (std::filesystem::path(home)/".cache"/"symbolicore-codegen").string(); }
+    return (std::filesystem::temp_directory_path()/("symbolicore-codegen-"+to_string(geteuid()))).string();
+#endif
+}
+
+#if defined(_WIN32)
+#else
+const char* const COMPILE_SIGNATURE="compile(Vector<Expression<Real>>,RealSpace,CompilerSettings)";
+
+//! \brief A suffix for temporary files, unique across processes and across the threads of this process.
+String unique_suffix() {
+    static std::atomic<unsigned long> counter(0u);
+    return "."+to_string(getpid())+"."+to_string(counter.fetch_add(1u));
+}
+
+//! \brief Whether \a path is of file \a type without being a symbolic link, is owned by the current user
+//! and is not writable by other users, so that nobody else can have placed or altered it.
+bool is_private(std::filesystem::path const& path, mode_t type) {
+    struct stat status;
+    return ::lstat(path.c_str(),&status)==0 and (status.st_mode&S_IFMT)==type
+        and status.st_uid==::geteuid() and (status.st_mode&(S_IWGRP|S_IWOTH))==0;
+}
+
+//! \brief Create the directory \a path accessible by the current user only, unless already present,
+//! throwing if it cannot be created or if it is not private.
+void create_private_directory(std::filesystem::path const& path) {
+    std::error_code ec;
+    if (path.has_parent_path()) { std::filesystem::create_directories(path.parent_path(),ec); }
+    if (::mkdir(path.c_str(),S_IRWXU)!=0 and errno!=EEXIST) {
+        HELPER_THROW(std::runtime_error,COMPILE_SIGNATURE,"Could not create the code generation directory "<<path<<": "<<std::strerror(errno));
+    }
+    if (not is_private(path,S_IFDIR)) {
+        HELPER_THROW(std::runtime_error,COMPILE_SIGNATURE,"The code generation directory "<<path<<" must be owned by the current user and not writable by others.");
+    }
+}
+
+//! \brief The contents of the file at \a path, or an empty string if it cannot be read.
+String read_file(std::filesystem::path const& path) {
+    std::ifstream ifs(path,std::ios::binary);
+    std::ostringstream ss;
+    ss << ifs.rdbuf();
+    return ss.str();
+}
+#endif
+
+} // namespace
+
+String c_source(Vector<Expression<Real>> const& e, RealSpace const& spc, String const& name) {
+    CSourceWriter writer(spc);
+    for (size_t i=0; i!=e.size(); ++i) { writer.assign(i,e[i]); }
+    std::ostringstream ss;
+    ss << "/* Generated by SymboliCore */\n"
+       << "#include <math.h>\n\n"
+       << "void " << name << "(const double* x, double* y)\n"
+       << "{\n"
+       << "    (void)x;\n"
+       << writer.body()
+       << "}\n";
+    return ss.str();
+}
+
+String c_source(Expression<Real> const& e, RealSpace const& spc, String const& name) {
+    return c_source(Vector<Expression<Real>>({e}),spc,name);
+}
+
+CompilerSettings CompilerSettings::default_settings() {
+    CompilerSettings result;
+    result.compiler=getenv_or("CC","cc");
+    result.flags="-O2 -shared -fPIC -ffp-contract=off";
+    result.cache_directory=getenv_or("SYMBOLICORE_CODEGEN_CACHE",default_cache_directory());
+    return result;
+}
+
+CompiledFunction::CompiledFunction(shared_ptr<void> lib, KernelType knl, RealSpace const& spc, size_t rs)
+    : _library(lib), _kernel(knl), _argument_space(spc), _result_size(rs) { }
+
+Vector<Real> CompiledFunction::operator()(Vector<Real> const& x) const {
+    HELPER_PRECONDITION(x.size()==this->argument_size());
+    Array<double> xa(x.size(),[&x](size_t i){return x[i].value();});
+    Array<double> ya(this->result_size(),0.0);
+    _kernel(xa.begin(),ya.begin());
+    return Vector<Real>(ya.size(),[&ya](size_t i){return Real(ya[i]);});
+}
+
+Vector<Real> evaluate(CompiledFunction const& f, Valuation<Real> const& x) {
+    RealSpace const& spc=f.argument_space();
+    Array<double> xa(spc.dimension(),[&](size_t i){return x.values()[spc.variable(i).name()].value();});
+    Array<double> ya(f.result_size(),0.0);
+    f(xa.begin(),ya.begin());
+    return Vector<Real>(ya.size(),[&ya](size_t i){return Real(ya[i]);});
+}
+
+CompiledFunction compile(Vector<Expression<Real>> const& e, RealSpace const& spc, CompilerSettings const& settings) {
+#if defined(_WIN32)
+    HELPER_THROW(std::runtime_error,"compile(Vector<Expression<Real>>,RealSpace,CompilerSettings)","Runtime loading of compiled code is not supported on this platform.");
+#else
+    namespace fs = std::filesystem;
+    const String function_name="symbolicore_kernel";
+    String source=c_source(e,spc,function_name);
+
+    // The source is stored together with the command compiling it, and compared before reusing a cached library
+    String cached_source="/* "+settings.compiler+" "+settings.flags+" */\n"+source;
+    std::ostringstream hs; hs << std::hex << std::hash<String>()(cached_source);
+    fs::path directory(settings.cache_directory);
+    fs::path entry_path=directory/("symbolicore_"+hs.str());
+    fs::path library_path=entry_path/"kernel.so";
+    fs::path private_path;
+
+    // Each entry is a directory holding both files, published by renaming and never modified afterwards;
+    // it is reused only if nobody else can have written it, since the library is loaded into this process
+    create_private_directory(directory);
+    bool reusable=is_private(entry_path,S_IFDIR) and is_private(entry_path/"kernel.c",S_IFREG) and is_private(library_path,S_IFREG)
+        and read_file(entry_path/"kernel.c")==cached_source;
+    if (not reusable) {
+        std::error_code ec;
+        fs::path temporary_path=directory/("symbolicore_"+hs.str()+unique_suffix());
+        if (::mkdir(temporary_path.c_str(),S_IRWXU)!=0) {
+            HELPER_THROW(std::runtime_error,COMPILE_SIGNATURE,"Could not create the code generation directory "<<temporary_path<<": "<<std::strerror(errno));
+        }
+        std::ofstream ofs(temporary_path/"kernel.c");
+        ofs << cached_source;
+        ofs.close();
+        String command=settings.compiler+" "+settings.flags+" -o \""+(temporary_path/"kernel.so").string()+"\" \""+(temporary_path/"kernel.c").string()+"\" -lm";
+        if (std::system(command.c_str())!=0) {
+            fs::remove_all(temporary_path,ec);
+            HELPER_THROW(std::runtime_error,COMPILE_SIGNATURE,"Compilation failed using command: "<<command);
+        }
+        // A permissive umask must not prevent the entry from being reused
+        for (auto const& file : {temporary_path/"kernel.c",temporary_path/"kernel.so"}) {
+            fs::permissions(file,fs::perms::group_write|fs::perms::others_write,fs::perm_options::remove,ec);
+        }
+        // Renaming a directory onto an existing entry fails, in which case a concurrent compilation of the same source
+        // or a colliding entry is already in place, and the library just built is loaded privately instead
+        fs::rename(temporary_path,entry_path,ec);
+        if (ec) { private_path=temporary_path; library_path=temporary_path/"kernel.so"; }
+    }
+
+    void* library=dlopen(library_path.c_str(),RTLD_NOW|RTLD_LOCAL);
+    if (not private_path.empty()) { std::error_code ec; fs::remove_all(private_path,ec); }
+    if (library==nullptr) {
+        HELPER_THROW(std::runtime_error,COMPILE_SIGNATURE,"Could not load "<<library_path<<": "<<dlerror());
+    }
+    shared_ptr<void> library_handle(library,[](void* l){dlclose(l);});
+    auto kernel=reinterpret_cast<CompiledFunction::KernelType>(dlsym(library,function_name.c_str()));
+    HELPER_ASSERT_MSG(kernel!=nullptr,"Symbol "<<function_name<<" not found in "<<library_path);
+    return CompiledFunction(library_handle,kernel,spc,e.size());
+#endif
+}
+
+CompiledFunction compile(Expression<Real> const& e, RealSpace const& spc, CompilerSettings const& settings) {
+    return compile(Vector<Expression<Real>>({e}),spc,settings);
+}
+
+} // namespace SymboliCore
@@ -0,0 +1,353 @@
+/***************************************************************************
+ *            contractor.cpp
+ *
+ *  Copyright  2023  Luca Geretti
+ *
+ ****************************************************************************/
+
+/*
+ * This file is part of SymboliCore, under the MIT license.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*! \file contractor.cpp
+ *  \brief Contraction of boxes by constraints.
+ */
+
+#include <cmath>
+#include <deque>
+#include <limits>
+#include <algorithm>
+
+#include "helper/macros.hpp"
+#include "contractor.hpp"
+
+namespace SymboliCore {
+
+namespace {
+
+constexpr double inf = std::numeric_limits<double>::infinity();
+// The periodic inverses are only contracted when the argument spans few periods.
+constexpr long max_periods = 8;
+
+const RealInterval pi_interval(Real(0x1.921fb54442d18p+1),Real(0x1.921fb54442d19p+1));
+
+inline RealInterval make_interval(double l, double u) { return RealInterval(Real(l),Real(u)); }
+inline double lower(RealInterval const& ivl) { return ivl.lower_bound().value(); }
+inline double upper(RealInterval const& ivl) { return ivl.upper_bound().value(); }
+
+inline bool bounded(RealInterval const& ivl) { return std::isfinite(lower(ivl)) && std::isfinite(upper(ivl)); }
+
+inline RealInterval nonnegative(RealInterval const& ivl) { return intersection(ivl,make_interval(0.0,inf)); }
+
+//! \brief Restrict \a x to the union of the sets \a b+k×p over integers \a k, returning the hull of the result.
+RealInterval periodic_intersection(RealInterval const& x, RealInterval const& b, RealInterval const& p) {
+    if (x.is_empty() || b.is_empty()) { return intersection(x,b); }
+    if (!bounded(x)) { return x; }
+    double kmin=std::floor((lower(x)-upper(b))/lower(p))-1;
+    double kmax=std::ceil((upper(x)-lower(b))/lower(p))+1;
+    if (kmax-kmin>2*max_periods) { return x; }
+    RealInterval r=intersection(x,make_interval(inf,-inf));
+    for (double k=kmin; k<=kmax; k+=1.0) {
+        r=hull(r,intersection(x,add(b,mul(RealInterval(Real(k)),p))));
+    }
+    return r;
+}
+
+//! \brief Restrict \a x to the set of values \a v with \a v or \a -v in \a z.
+RealInterval symmetric_intersection(RealInterval const& x, RealInterval const& z) {
+    return hull(intersection(x,neg(z)),intersection(x,z));
+}
+
+RealInterval two_pi() { return add(pi_interval,pi_interval); }
+
+} // namespace
+
+Contractor::Contractor(Expression<Kleenean> const& p, double ratio)
+    : Contractor(List<Expression<Kleenean>>({p}),ratio)
+{ }
+
+Contractor::Contractor(List<Expression<Kleenean>> const& ps, double ratio)
+    : _ratio(ratio)
+{
+    HELPER_PRECONDITION(ratio>0 && ratio<1);
+    for (auto const& p : ps) { this->_adjoin(p,false); }
+}
+
+void Contractor::_adjoin(Expression<Kleenean> const& p, bool negated) {
+    OperatorCode code=p.code();
+    if ((code==OperatorCode::AND && !negated) || (code==OperatorCode::OR && negated)) {
+        this->_adjoin(p.arg1(),negated); this->_adjoin(p.arg2(),negated); return;
+    }
+    if (code==OperatorCode::NOT) { this->_adjoin(p.arg(),!negated); return; }
+
+    Constraint c({code,0u,0u,List<size_t>(),List<size_t>()});
+    std::map<void const*,size_t> recorded;
+    if (code==OperatorCode::SGN) {
+        // The predicate sgn(e) holds when 0<e, and its negation when e<=0
+        size_t zero=_nodes.size();
+        _nodes.push_back(Node({OperatorCode::CNST,OperatorKind::NULLARY,0u,0u,0,RealInterval(Real(0.0))}));
+        c.nodes.push_back(zero);
+        size_t arg=this->_record(p.cmp<Real>(),c,recorded);
+        c.code = negated ? OperatorCode::LEQ : OperatorCode::LT;
+        c.arg1 = negated ? arg : zero;
+        c.arg2 = negated ? zero : arg;
+    } else if (p.kind()==OperatorKind::COMPARISON) {
+        if (negated) {
+            switch(code) {
+                case OperatorCode::LEQ: code=OperatorCode::GT; break;
+                case OperatorCode::LT: code=OperatorCode::GEQ; break;
+                case OperatorCode::GEQ: code=OperatorCode::LT; break;
+                case OperatorCode::GT: code=OperatorCode::LEQ; break;
+                case OperatorCode::EQ: code=OperatorCode::NEQ; break;
+                case OperatorCode::NEQ: code=OperatorCode::EQ; break;
+                default: return;
+            }
+        }
+        if (code==OperatorCode::NEQ) { return; }
+        c.code=code;
+        c.arg1=this->_record(p.cmp1<Real>(),c,recorded);
+        c.arg2=this->_record(p.cmp2<Real>(),c,recorded);
+    } else {
+        return;
+    }
+
+    size_t index=_constraints.size();
+    for (size_t v : c.variables) { _variable_constraints[v].push_back(index); }
+    _constraints.push_back(c);
+}
+
+size_t Contractor::_record(Expression<Real> const& e, Constraint& c, std::map<void const*,size_t>& recorded) {
+    auto iter=recorded.find(e.node_raw_ptr());
+    if (iter!=recorded.end()) { return iter->second; }
+
+    Node node({e.code(),e.kind(),0u,0u,0,RealInterval()});
+    switch(e.kind()) {
+        case OperatorKind::NULLARY:
+        case OperatorKind::VARIABLE:
+            if (e.code()==OperatorCode::CNST) {
+                node.value=RealInterval(e.val());
+            } else {
+                auto viter=std::find(_variables.begin(),_variables.end(),e.var());
+                node.arg1=static_cast<size_t>(viter-_variables.begin());
+                if (viter==_variables.end()) { _variables.push_back(e.var()); _variable_constraints.push_back(List<size_t>()); }
+                if (std::find(c.variables.begin(),c.variables.end(),node.arg1)==c.variables.end()) { c.variables.push_back(node.arg1); }
+            }
+            break;
+        case OperatorKind::UNARY: node.arg1=this->_record(e.arg(),c,recorded); break;
+        case OperatorKind::BINARY: node.arg1=this->_record(e.arg1(),c,recorded); node.arg2=this->_record(e.arg2(),c,recorded); break;
+        case OperatorKind::GRADED: node.arg1=this->_record(e.arg(),c,recorded); node.num=e.num(); break;
+        default: HELPER_FAIL_MSG("Cannot contract over expression "<<e);
+    }
+
+    size_t index;
+    auto niter=_node_indices.find(e.node_raw_ptr());
+    if (niter!=_node_indices.end()) {
+        index=niter->second;
+    } else {
+        index=_nodes.size();
+        _nodes.push_back(node);
+        _node_indices.insert(std::make_pair(e.node_raw_ptr(),index));
+    }
+    c.nodes.push_back(index);
+    recorded.insert(std::make_pair(e.node_raw_ptr(),index));
+    return index;
+}
+
+bool Contractor::_revise(Constraint const& c, List<RealInterval>& domains, List<RealInterval>& values) const {
+    // Forward evaluation
+    for (size_t i : c.nodes) {
+        Node const& n=_nodes[i];
+        RealInterval& z=values[i];
+        switch(n.kind) {
+            case OperatorKind::NULLARY:
+            case OperatorKind::VARIABLE:
+                z = (n.code==OperatorCode::CNST) ? n.value : domains[n.arg1]; break;
+            case OperatorKind::GRADED: z=pow(values[n.arg1],n.num); break;
+            case OperatorKind::UNARY: {
+                RealInterval const& x=values[n.arg1];
+                switch(n.code) {
+                    case OperatorCode::NUL: z=nul(x); break;
+                    case OperatorCode::POS: z=pos(x); break;
+                    case OperatorCode::NEG: z=neg(x); break;
+                    case OperatorCode::HLF: z=hlf(x); break;
+                    case OperatorCode::REC: z=rec(x); break;
+                    case OperatorCode::SQR: z=sqr(x); break;
+                    case OperatorCode::SQRT: z=sqrt(x); break;
+                    case OperatorCode::EXP: z=exp(x); break;
+                    case OperatorCode::LOG: z=log(x); break;
+                    case OperatorCode::SIN: z=sin(x); break;
+                    case OperatorCode::COS: z=cos(x); break;
+                    case OperatorCode::TAN: z=tan(x); break;
+                    case OperatorCode::ASIN: z=asin(x); break;
+                    case OperatorCode::ACOS: z=acos(x); break;
+                    case OperatorCode::ATAN: z=atan(x); break;
+                    case OperatorCode::ABS: z=abs(x); break;
+                    default: HELPER_FAIL_MSG("Cannot contract over unary operator "<<n.code);
+                }
+                break;
+            }
+            case OperatorKind::BINARY: {
+                RealInterval const& x=values[n.arg1]; RealInterval const& y=values[n.arg2];
+                switch(n.code) {
+                    case OperatorCode::ADD: z=add(x,y); break;
+                    case OperatorCode::SUB: z=sub(x,y); break;
+                    case OperatorCode::MUL: z=mul(x,y); break;
+                    case OperatorCode::DIV: z=div(x,y); break;
+                    case OperatorCode::MAX: z=max(x,y); break;
+                    case OperatorCode::MIN: z=min(x,y); break;
+                    default: HELPER_FAIL_MSG("Cannot contract over binary operator "<<n.code);
+                }
+                break;
+            }
+            default: HELPER_FAIL_MSG("Unhandled operator kind "<<n.kind);
+        }
+    }
+
+    // Restriction by the comparison
+    RealInterval& a1=values[c.arg1]; RealInterval& a2=values[c.arg2];
+    switch(c.code) {
+        case OperatorCode::LEQ: case OperatorCode::LT:
+            a1=intersection(a1,make_interval(-inf,upper(a2))); a2=intersection(a2,make_interval(lower(a1),+inf)); break;
+        case OperatorCode::GEQ: case OperatorCode::GT:
+            a2=intersection(a2,make_interval(-inf,upper(a1))); a1=intersection(a1,make_interval(lower(a2),+inf)); break;
+        case OperatorCode::EQ:
+            a1=intersection(a1,a2); a2=a1; break;
+        default: HELPER_FAIL_MSG("Unhandled constraint "<<c.code);
+    }
+
+    // Backward propagation, in which each node is reached after all the nodes using it
+    for (auto iter=c.nodes.rbegin(); iter!=c.nodes.rend(); ++iter) {
+        Node const& n=_nodes[*iter];
+        RealInterval const z=values[*iter];
+        if (z.is_empty()) { return false; }
+        switch(n.kind) {
+            case OperatorKind::NULLARY:
+            case OperatorKind::VARIABLE:
+                if (n.code==OperatorCode::VAR) {
+                    domains[n.arg1]=intersection(domains[n.arg1],z);
+                    if (domains[n.arg1].is_empty()) { return false; }
+                }
+                break;
+            case OperatorKind::GRADED: {
+                RealInterval& x=values[n.arg1];
+                if (n.num==1) { x=intersection(x,z); }
+                else if (n.num==2) { x=symmetric_intersection(x,sqrt(z)); }
+                break;
+            }
+            case OperatorKind::UNARY: {
+                RealInterval& x=values[n.arg1];
+                switch(n.code) {
+                    case OperatorCode::POS: x=intersection(x,z); break;
+                    case OperatorCode::NEG: x=intersection(x,neg(z)); break;
+                    case OperatorCode::HLF: x=intersection(x,add(z,z)); break;
+                    case OperatorCode::REC: x=intersection(x,rec(z)); break;
+                    case OperatorCode::SQR: x=symmetric_intersection(x,sqrt(nonnegative(z))); break;
+                    case OperatorCode::SQRT: x=intersection(x,sqr(nonnegative(z))); break;
+                    case OperatorCode::EXP: x=intersection(x,log(nonnegative(z))); break;
+                    case OperatorCode::LOG: x=intersection(x,exp(z)); break;
+                    case OperatorCode::SIN: {
+                        RealInterval a=asin(z);
+                        x=hull(periodic_intersection(x,a,two_pi()),periodic_intersection(x,sub(pi_interval,a),two_pi()));
+                        break;
+                    }
+                    case OperatorCode::COS: {
+                        RealInterval a=acos(z);
+                        x=hull(periodic_intersection(x,a,two_pi()),periodic_intersection(x,neg(a),two_pi()));
+                        break;
+                    }
+                    case OperatorCode::TAN: x=periodic_intersection(x,atan(z),pi_interval); break;
+                    case OperatorCode::ASIN: x=intersection(x,sin(intersection(z,hlf(make_interval(-upper(pi_interval),upper(pi_interval)))))); break;
+                    case OperatorCode::ACOS: x=intersection(x,cos(intersection(z,make_interval(0.0,upper(pi_interval))))); break;
+                    case OperatorCode::ATAN: x=intersection(x,tan(z)); break;
+                    case OperatorCode::ABS: x=symmetric_intersection(x,nonnegative(z)); break;
+                    default: break;
+                }
+                break;
+            }
+            case OperatorKind::BINARY: {
+                RealInterval& x=values[n.arg1]; RealInterval& y=values[n.arg2];
+                switch(n.code) {
+                    case OperatorCode::ADD: x=intersection(x,sub(z,y)); y=intersection(y,sub(z,x)); break;
+                    case OperatorCode::SUB: x=intersection(x,add(z,y)); y=intersection(y,sub(x,z)); break;
+                    case OperatorCode::MUL:
+                        if (!y.contains(Real(0.0))) { x=intersection(x,div(z,y)); }
+                        if (!x.contains(Real(0.0))) { y=intersection(y,div(z,x)); }
+                        break;
+                    case OperatorCode::DIV:
+                        x=intersection(x,mul(z,y));
+                        if (!z.contains(Real(0.0))) { y=intersection(y,div(x,z)); }
+                        break;
+                    case OperatorCode::MAX:
+                        x=intersection(x,make_interval(-inf,upper(z))); y=intersection(y,make_interval(-inf,upper(z)));
+                        if (upper(y)<lower(z)) { x=intersection(x,z); } else if (upper(x)<lower(z)) { y=intersection(y,z); }
+                        break;
+                    case OperatorCode::MIN:
+                        x=intersection(x,make_interval(lower(z),+inf)); y=intersection(y,make_interval(lower(z),+inf));
+                        if (lower(y)>upper(z)) { x=intersection(x,z); } else if (lower(x)>upper(z)) { y=intersection(y,z); }
+                        break;
+                    default: break;
+                }
+                break;
+            }
+            default: break;
+        }
+    }
+    return true;
+}
+
+RealVariablesBox Contractor::contract(RealVariablesBox const& bx) const {
+    List<RealInterval> domains;
+    for (auto const& v : _variables) { domains.push_back(bx[v]); }
+    List<RealInterval> values(_nodes.size());
+
+    RealVariablesBox result(bx);
+    std::deque<size_t> worklist;
+    List<bool> queued(_constraints.size(),true);
+    for (size_t i=0; i!=_constraints.size(); ++i) { worklist.push_back(i); }
+
+    while (!worklist.empty()) {
+        size_t i=worklist.front(); worklist.pop_front(); queued[i]=false;
+        Constraint const& c=_constraints[i];
+        List<double> widths;
+        for (size_t v : c.variables) { widths.push_back(width(domains[v]).value()); }
+        if (!this->_revise(c,domains,values)) {
+            for (auto const& b : bx) { result[RealVariable(b.first)]=make_interval(inf,-inf); }
+            return result;
+        }
+        for (size_t j=0; j!=c.variables.size(); ++j) {
+            size_t v=c.variables[j];
+            double w=width(domains[v]).value();
+            if (w < widths[j]*(1-_ratio) || (std::isinf(widths[j]) && !std::isinf(w))) {
+                for (size_t k : _variable_constraints[v]) {
+                    if (k!=i && !queued[k]) { worklist.push_back(k); queued[k]=true; }
+                }
+            }
+        }
+    }
+
+    for (size_t v=0; v!=_variables.size(); ++v) { result[RealVariable(_variables[v])]=domains[v]; }
+    return result;
+}
+
+RealVariablesBox contract(Expression<Kleenean> const& p, RealVariablesBox const& bx) {
+    return Contractor(p).contract(bx);
+}
+
+} // namespace SymboliCore
@@ -0,0 +1,218 @@
+/***************************************************************************
+ *            dependency.cpp
+ *
+ *  Copyright  2023  Luca Geretti
+ *
+ ****************************************************************************/
+
+/*
+ * This file is part of SymboliCore, under the MIT license.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*! \file dependency.cpp
+ *  \brief Sparsity patterns of the dependencies of expressions on variables.
+ */
+
+#include <algorithm>
+#include <unordered_map>
+
+#include "dependency.hpp"
+#include "vector.hpp"
+#include "expression.hpp"
+#include "assignment.hpp"
+#include "space.hpp"
+
+namespace SymboliCore {
+
+DependencyPattern::DependencyPattern(size_t rs, size_t cs)
+    : _cs(cs), _offsets(rs+1u,0u), _columns() { }
+
+DependencyPattern::DependencyPattern(size_t cs, std::vector<size_t> offsets, std::vector<size_t> columns)
+    : _cs(cs), _offsets(std::move(offsets)), _columns(std::move(columns))
+{
+    HELPER_PRECONDITION_MSG(!_offsets.empty() && _offsets.front()==0u && _offsets.back()==_columns.size(),
+                            "The row offsets of a dependency pattern must start at zero and end at the number of nonzeros.");
+    for(size_t i=0; i!=row_size(); ++i) {
+        HELPER_PRECONDITION_MSG(_offsets[i]<=_offsets[i+1],"The row offsets of a dependency pattern must be increasing.");
+        for(size_t k=_offsets[i]; k!=_offsets[i+1]; ++k) {
+            HELPER_PRECONDITION_MSG(_columns[k]<cs && (k==_offsets[i] || _columns[k-1]<_columns[k]),
+                                    "The columns of row "<<i<<" of a dependency pattern must be increasing and less than "<<cs<<".");
+        }
+    }
+}
+
+bool DependencyPattern::get(size_t i, size_t j) const {
+    HELPER_PRECONDITION(i<row_size() && j<column_size());
+    auto r=row(i);
+    return std::binary_search(r.begin(),r.end(),j);
+}
+
+DependencyPattern DependencyPattern::transpose() const {
+    std::vector<size_t> offsets(_cs+1u,0u);
+    for(auto j : _columns) { ++offsets[j+1]; }
+    for(size_t j=0; j!=_cs; ++j) { offsets[j+1]+=offsets[j]; }
+    std::vector<size_t> rows(_columns.size());
+    std::vector<size_t> next(offsets.begin(),offsets.end()-1);
+    // Traversing the rows in order leaves the rows of the transpose sorted
+    for(size_t i=0; i!=row_size(); ++i) {
+        for(auto j : row(i)) { rows[next[j]++]=i; }
+    }
+    return DependencyPattern(row_size(),std::move(offsets),std::move(rows));
+}
+
+bool operator==(DependencyPattern const& p1, DependencyPattern const& p2) {
+    return p1._cs==p2._cs && p1._offsets==p2._offsets && p1._columns==p2._columns;
+}
+
+ostream& operator<<(ostream& os, DependencyPattern const& p) {
+    os << "[";
+    for(size_t i=0; i!=p.row_size(); ++i) {
+        if(i!=0u) { os << ";"; }
+        for(size_t j=0; j!=p.column_size(); ++j) { os << (p.get(i,j) ? '1' : '0'); }
+    }
+    return os << "]";
+}
+
+namespace {
+
+typedef std::unordered_map<VariableIndex,size_t> IndexMap;
+
+IndexMap space_columns(RealSpace const& spc) {
+    IndexMap columns; columns.reserve(spc.dimension());
+    for(size_t j=0; j!=spc.dimension(); ++j) { columns.emplace(intern(spc.variable(j)),j); }
+    return columns;
+}
+
+// Collects the rows of a pattern, each appended as a (possibly unsorted) list of columns
+class PatternBuilder {
+    size_t _cs;
+    std::vector<size_t> _offsets;
+    std::vector<size_t> _columns;
+  public:
+    PatternBuilder(size_t cs, size_t rs) : _cs(cs), _offsets(1u,0u), _columns() { _offsets.reserve(rs+1u); }
+    void push_back(size_t j) { _columns.push_back(j); }
+    void append(std::span<const size_t> js) { _columns.insert(_columns.end(),js.begin(),js.end()); }
+    void end_row() {
+        auto first=_columns.begin()+static_cast<std::ptrdiff_t>(_offsets.back());
+        std::sort(first,_columns.end());
+        _columns.erase(std::unique(first,_columns.end()),_columns.end());
+        _offsets.push_back(_columns.size());
+    }
+    DependencyPattern build() { return DependencyPattern(_cs,std::move(_offsets),std::move(_columns)); }
+};
+
+// The transitive dependencies of the assignments, each resolved once, in the order of the assignments
+DependencyPattern resolve_assignments(List<RealAssignment> const& asg, IndexMap const& columns, IndexMap const& assigned, size_t cs) {
+    enum class State : char { UNVISITED, VISITING, RESOLVED };
+    size_t n=asg.size();
+    std::vector<State> states(n,State::UNVISITED);
+    std::vector<std::vector<size_t>> resolved(n);
+
+    // Explicit stack of (assignment, position in its arguments), so that long chains do not overflow the call stack
+    std::vector<std::pair<size_t,size_t>> stack;
+    for(size_t root=0; root!=n; ++root) {
+        if(states[root]!=State::UNVISITED) { continue; }
+        stack.emplace_back(root,0u);
+        states[root]=State::VISITING;
+        while(!stack.empty()) {
+            auto& [k,pos]=stack.back();
+            ArgumentSet const& args=asg[k].rhs.argument_set();
+            bool descended=false;
+            while(pos!=args.size()) {
+                auto iter=assigned.find(args.begin()[pos++]);
+                if(iter==assigned.end()) { continue; }
+                size_t d=iter->second;
+                if(states[d]==State::VISITING) {
+                    HELPER_THROW(std::runtime_error,"dependency_pattern(List<RealAssignment>,RealSpace)",
+                                 "Algebraic loop involving the assignment "<<asg[d]);
+                }
+                if(states[d]==State::UNVISITED) {
+                    states[d]=State::VISITING;
+                    stack.emplace_back(d,0u);
+                    descended=true;
+                    break;
+                }
+            }
+            if(descended) { continue; }
+            std::vector<size_t>& row=resolved[k];
+            for(auto id : args) {
+                auto citer=assigned.find(id);
+                if(citer!=assigned.end()) { row.insert(row.end(),resolved[citer->second].begin(),resolved[citer->second].end()); continue; }
+                auto iter=columns.find(id);
+                if(iter!=columns.end()) { row.push_back(iter->second); }
+            }
+            std::sort(row.begin(),row.end());
+            row.erase(std::unique(row.begin(),row.end()),row.end());
+            states[k]=State::RESOLVED;
+            stack.pop_back();
+        }
+    }
+
+    PatternBuilder builder(cs,n);
+    for(size_t k=0; k!=n; ++k) { builder.append(resolved[k]); builder.end_row(); }
+    return builder.build();
+}
+
+IndexMap assigned_indices(List<RealAssignment> const& asg) {
+    IndexMap assigned; assigned.reserve(asg.size());
+    for(size_t k=0; k!=asg.size(); ++k) {
+        bool inserted=assigned.emplace(intern(asg[k].lhs),k).second;
+        HELPER_PRECONDITION_MSG(inserted,"Variable "<<asg[k].lhs<<" is assigned more than once.");
+    }
+    return assigned;
+}
+
+} // namespace
+
+DependencyPattern dependency_pattern(Vector<Expression<Real>> const& f, RealSpace const& spc) {
+    IndexMap columns=space_columns(spc);
+    PatternBuilder builder(spc.dimension(),f.size());
+    for(size_t i=0; i!=f.size(); ++i) {
+        for(auto id : f[i].argument_set()) {
+            auto iter=columns.find(id);
+            if(iter!=columns.end()) { builder.push_back(iter->second); }
+        }
+        builder.end_row();
+    }
+    return builder.build();
+}
+
+DependencyPattern dependency_pattern(List<RealAssignment> const& asg, RealSpace const& spc) {
+    return resolve_assignments(asg,space_columns(spc),assigned_indices(asg),spc.dimension());
+}
+
+DependencyPattern dependency_pattern(Vector<Expression<Real>> const& f, List<RealAssignment> const& asg, RealSpace const& spc) {
+    IndexMap columns=space_columns(spc);
+    IndexMap assigned=assigned_indices(asg);
+    DependencyPattern through=resolve_assignments(asg,columns,assigned,spc.dimension());
+    PatternBuilder builder(spc.dimension(),f.size());
+    for(size_t i=0; i!=f.size(); ++i) {
+        for(auto id : f[i].argument_set()) {
+            auto aiter=assigned.find(id);
+            if(aiter!=assigned.end()) { builder.append(through.row(aiter->second)); continue; }
+            auto iter=columns.find(id);
+            if(iter!=columns.end()) { builder.push_back(iter->second); }
+        }
+        builder.end_row();
+    }
+    return builder.build();
+}
+
+} // namespace SymboliCore
@@ -54,6 +54,13 @@ template class Expression<String>;
 template class Expression<Integer>;
 template class Expression<Real>;
 
+template class PrefixExpressionWriter<Real>;
+template class InfixExpressionWriter<Real>;
+
+template const Expression<Real>& Expression<Kleenean>::cmp<Real>(Real*) const;
+template const Expression<Real>& Expression<Kleenean>::cmp1<Real>(Real*) const;
+template const Expression<Real>& Expression<Kleenean>::cmp2<Real>(Real*) const;
+
 template bool before<Real>(Expression<Real> const& e1, Expression<Real> const& e2);
 template size_t count_nodes<Real>(const Expression<Real>& e);
 template size_t count_distinct_nodes<Real>(const Expression<Real>& e);
@@ -272,6 +279,108 @@ Expression<Real> indicator(Expression<Kleenean> e, Sign sign) {
 }
 
 
+namespace {
+
+Real _unary(OperatorCode code, Real const& x) {
+    switch(code) {
+        case OperatorCode::NUL: return nul(x);
+        case OperatorCode::POS: return pos(x);
+        case OperatorCode::NEG: return neg(x);
+        case OperatorCode::HLF: return hlf(x);
+        case OperatorCode::REC: return rec(x);
+        case OperatorCode::SQR: return sqr(x);
+        case OperatorCode::SQRT: return sqrt(x);
+        case OperatorCode::EXP: return exp(x);
+        case OperatorCode::LOG: return log(x);
+        case OperatorCode::SIN: return sin(x);
+        case OperatorCode::COS: return cos(x);
+        case OperatorCode::TAN: return tan(x);
+        case OperatorCode::ASIN: return asin(x);
+        case OperatorCode::ACOS: return acos(x);
+        case OperatorCode::ATAN: return atan(x);
+        case OperatorCode::ABS: return abs(x);
+        default: HELPER_FAIL_MSG("Unhandled unary operator "<<code);
+    }
+}
+
+Real _binary(OperatorCode code, Real const& x1, Real const& x2) {
+    switch(code) {
+        case OperatorCode::ADD: return add(x1,x2);
+        case OperatorCode::SUB: return sub(x1,x2);
+        case OperatorCode::MUL: return mul(x1,x2);
+        case OperatorCode::DIV: return div(x1,x2);
+        case OperatorCode::MAX: return max(x1,x2);
+        case OperatorCode::MIN: return min(x1,x2);
+        default: HELPER_FAIL_MSG("Unhandled binary operator "<<code);
+    }
+}
+
+// The value of \a e, where the value of a variable is given by \a lookup.
+template<class F> Real _value(RE const& e, F const& lookup) {
+    switch(e.kind()) {
+        case OperatorKind::NULLARY: return e.val();
+        case OperatorKind::VARIABLE: return lookup(e.var());
+        case OperatorKind::UNARY: return _unary(e.code(),_value(e.arg(),lookup));
+        case OperatorKind::BINARY: { Real x1=_value(e.arg1(),lookup); return _binary(e.code(),x1,_value(e.arg2(),lookup)); }
+        case OperatorKind::GRADED: return pow(_value(e.arg(),lookup),e.num());
+        default: HELPER_FAIL_MSG("Unhandled operator kind "<<e.kind()<<" in expression "<<e);
+    }
+}
+
+// The logical value of \a p; conjunctions and disjunctions are short-circuited, which does not change their values.
+template<class F> LogicalValue _check(KE const& p, F const& lookup) {
+    switch(p.code()) {
+        case OperatorCode::CNST: return static_cast<LogicalValue>(p.val().check(Effort::get_default()));
+        case OperatorCode::NOT: return !_check(p.arg(),lookup);
+        case OperatorCode::AND: {
+            LogicalValue v1=_check(p.arg1(),lookup);
+            return Detail::possibly(v1) ? (v1 && _check(p.arg2(),lookup)) : v1; }
+        case OperatorCode::OR: {
+            LogicalValue v1=_check(p.arg1(),lookup);
+            return Detail::definitely(v1) ? v1 : (v1 || _check(p.arg2(),lookup)); }
+        case OperatorCode::SGN: {
+            Sign s=sgn(_value(p.cmp<Real>(),lookup));
+            return s==Sign::POSITIVE ? LogicalValue::TRUE : (s==Sign::NEGATIVE ? LogicalValue::FALSE : LogicalValue::INDETERMINATE); }
+        default: break;
+    }
+    HELPER_ASSERT_MSG(p.kind()==OperatorKind::COMPARISON,"Cannot check predicate "<<p<<" on real values");
+    Real x1=_value(p.cmp1<Real>(),lookup); Real x2=_value(p.cmp2<Real>(),lookup);
+    switch(p.code()) {
+        case OperatorCode::EQ: return static_cast<LogicalValue>(x1==x2);
+        case OperatorCode::NEQ: return static_cast<LogicalValue>(x1!=x2);
+        case OperatorCode::LEQ: return static_cast<LogicalValue>(x1<=x2);
+        case OperatorCode::GEQ: return static_cast<LogicalValue>(x1>=x2);
+        case OperatorCode::LT: return static_cast<LogicalValue>(x1<x2);
+        case OperatorCode::GT: return static_cast<LogicalValue>(x1>x2);
+        default: HELPER_FAIL_MSG("Unhandled comparison operator "<<p.code());
+    }
+}
+
+} // namespace
+
+LogicalValue check(Expression<Kleenean> const& p, Valuation<Real> const& x) {
+    Map<Identifier,Real> const& values=x.values();
+    return _check(p,[&values](Identifier const& name)->Real const&{return values[name];});
+}
+
+LogicalValue check(Expression<Kleenean> const& p, Vector<Real> const& x, RealSpace const& spc) {
+    HELPER_PRECONDITION(x.size()==spc.dimension());
+    return _check(p,[&x,&spc](Identifier const& name)->Real const&{return x[spc.index(name)];});
+}
+
+LogicalValue check(Expression<Kleenean> const& p, ValuationView<Real> const& x) {
+    return _check(p,[&x](Identifier const& name)->Real const&{return x[name];});
+}
+
+Real evaluate(Expression<Real> const& e, ValuationView<Real> const& x) {
+    return _value(e,[&x](Identifier const& name)->Real const&{return x[name];});
+}
+
+Real evaluate(Expression<Real> const& e, ValuationView<Real,double> const& x) {
+    return _value(e,[&x](Identifier const& name){return Real(x[name]);});
+}
+
+
 
 template bool is_constant(const Expression<Real>&, const Real&);
 template bool is_constant(const Expression<Kleenean>&, const Kleenean&);
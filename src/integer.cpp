@@ -26,7 +26,11 @@
  * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
 #include <limits>
+#include <vector>
 
 #include "helper/stdlib.hpp"
 #include "helper/macros.hpp"
@@ -40,42 +44,234 @@ using Helper::to_string;
 
 Comparison cmp(Integer const& z1, Integer const& z2);
 
-Integer::Integer() : _value(0) {}
-
-Integer::Integer(String const& str) : _value(std::atoi(c_str(str))) { }
-
-Integer::Integer(const Integer& z) : _value(z._value) { }
-
-long int const& Integer::value() const { return _value; }
+namespace Detail {
+
+//! \brief The sign-magnitude representation of an integer, with little-endian 64-bit limbs and no leading zero limbs.
+//! \details Used for the heap-allocated part of an Integer outside the range of <code>long int</code>,
+//! and as the working representation of the arithmetic spilling out of that range.
+struct IntegerLimbs {
+    typedef std::uint64_t Limb;
+    __extension__ typedef unsigned __int128 DoubleLimb;
+
+    bool negative;
+    std::vector<Limb> magnitude;
+
+    IntegerLimbs() : negative(false), magnitude() { }
+    IntegerLimbs(bool neg, std::vector<Limb> mag) : negative(neg), magnitude(std::move(mag)) { _normalise(); }
+
+    //! \brief The limbs of \a z, whether held inline or not.
+    static IntegerLimbs of(Integer const& z) {
+        if (z._limbs) { return *z._limbs; }
+        if (z._value==0) { return IntegerLimbs(); }
+        Limb m = z._value<0 ? Limb(0u)-static_cast<Limb>(z._value) : static_cast<Limb>(z._value);
+        return IntegerLimbs(z._value<0,{m});
+    }
+
+    //! \brief The Integer with limbs \a l, held inline if it fits in a <code>long int</code>.
+    static Integer make(IntegerLimbs&& l) {
+        Integer r;
+        if (l.magnitude.empty()) { return r; }
+        if (l.magnitude.size()==1u) {
+            Limb m=l.magnitude[0];
+            Limb lmax=static_cast<Limb>(std::numeric_limits<long int>::max());
+            if (!l.negative and m<=lmax) { r._value=static_cast<long int>(m); return r; }
+            if (l.negative and m<=lmax+1u) { r._value=static_cast<long int>(Limb(0u)-m); return r; }
+        }
+        r._limbs=new IntegerLimbs(std::move(l));
+        return r;
+    }
+
+    bool is_zero() const { return magnitude.empty(); }
+
+    void _normalise() {
+        while (!magnitude.empty() and magnitude.back()==0u) { magnitude.pop_back(); }
+        if (magnitude.empty()) { negative=false; }
+    }
+
+    static int compare_magnitude(std::vector<Limb> const& a, std::vector<Limb> const& b) {
+        if (a.size()!=b.size()) { return a.size()<b.size() ? -1 : +1; }
+        for (size_t i=a.size(); i!=0u; --i) {
+            if (a[i-1]!=b[i-1]) { return a[i-1]<b[i-1] ? -1 : +1; }
+        }
+        return 0;
+    }
+
+    static std::vector<Limb> add_magnitude(std::vector<Limb> const& a, std::vector<Limb> const& b) {
+        std::vector<Limb> const& l = a.size()>=b.size() ? a : b;
+        std::vector<Limb> const& s = a.size()>=b.size() ? b : a;
+        std::vector<Limb> r(l.size()+1u);
+        Limb carry=0u;
+        for (size_t i=0; i!=l.size(); ++i) {
+            DoubleLimb t=DoubleLimb(l[i])+(i<s.size()?s[i]:0u)+carry;
+            r[i]=static_cast<Limb>(t); carry=static_cast<Limb>(t>>64);
+        }
+        r[l.size()]=carry;
+        return r;
+    }
+
+    //! \brief The difference of magnitudes, assuming \a a is at least \a b.
+    static std::vector<Limb> sub_magnitude(std::vector<Limb> const& a, std::vector<Limb> const& b) {
+        std::vector<Limb> r(a.size());
+        Limb borrow=0u;
+        for (size_t i=0; i!=a.size(); ++i) {
+            Limb bi = i<b.size() ? b[i] : 0u;
+            Limb d=a[i]-bi-borrow;
+            borrow = (a[i]<bi or (a[i]==bi and borrow)) ? 1u : 0u;
+            r[i]=d;
+        }
+        return r;
+    }
+
+    static std::vector<Limb> mul_magnitude(std::vector<Limb> const& a, std::vector<Limb> const& b) {
+        if (a.empty() or b.empty()) { return std::vector<Limb>(); }
+        std::vector<Limb> r(a.size()+b.size(),0u);
+        for (size_t i=0; i!=a.size(); ++i) {
+            Limb carry=0u;
+            for (size_t j=0; j!=b.size(); ++j) {
+                DoubleLimb t=DoubleLimb(a[i])*b[j]+r[i+j]+carry;
+                r[i+j]=static_cast<Limb>(t); carry=static_cast<Limb>(t>>64);
+            }
+            r[i+b.size()]=carry;
+        }
+        return r;
+    }
+
+    //! \brief Divide the magnitude \a a by the single limb \a d in place, returning the remainder.
+    static Limb divide_magnitude(std::vector<Limb>& a, Limb d) {
+        DoubleLimb rem=0u;
+        for (size_t i=a.size(); i!=0u; --i) {
+            DoubleLimb t=(rem<<64)|a[i-1];
+            a[i-1]=static_cast<Limb>(t/d); rem=t%d;
+        }
+        return static_cast<Limb>(rem);
+    }
+
+    //! \brief Truncated division of magnitudes, setting the quotient \a q and remainder \a r.
+    static void divide_magnitude(std::vector<Limb> const& a, std::vector<Limb> const& b, std::vector<Limb>& q, std::vector<Limb>& r) {
+        HELPER_PRECONDITION(!b.empty());
+        if (compare_magnitude(a,b)<0) { q.clear(); r=a; return; }
+        if (b.size()==1u) { q=a; Limb rem=divide_magnitude(q,b[0]); r=std::vector<Limb>{rem}; return; }
+        // Binary long division; only reached for divisors of more than one limb
+        q.assign(a.size(),0u); r.clear();
+        for (size_t i=a.size()*64u; i!=0u; --i) {
+            size_t bit=i-1u;
+            r.insert(r.begin(),0u);
+            Limb carry=(a[bit/64u]>>(bit%64u))&1u;
+            for (size_t k=1; k!=r.size(); ++k) { Limb c=r[k]>>63; r[k]=(r[k]<<1)|carry; carry=c; }
+            r.erase(r.begin());
+            if (carry) { r.push_back(carry); }
+            while (!r.empty() and r.back()==0u) { r.pop_back(); }
+            if (compare_magnitude(r,b)>=0) {
+                r=sub_magnitude(r,b);
+                while (!r.empty() and r.back()==0u) { r.pop_back(); }
+                q[bit/64u]|=(Limb(1u)<<(bit%64u));
+            }
+        }
+    }
+
+    friend IntegerLimbs operator-(IntegerLimbs l) { l.negative=!l.negative; l._normalise(); return l; }
+    friend IntegerLimbs operator+(IntegerLimbs const& l1, IntegerLimbs const& l2) {
+        if (l1.negative==l2.negative) { return IntegerLimbs(l1.negative,add_magnitude(l1.magnitude,l2.magnitude)); }
+        int c=compare_magnitude(l1.magnitude,l2.magnitude);
+        if (c>=0) { return IntegerLimbs(l1.negative,sub_magnitude(l1.magnitude,l2.magnitude)); }
+        else { return IntegerLimbs(l2.negative,sub_magnitude(l2.magnitude,l1.magnitude)); }
+    }
+    friend IntegerLimbs operator*(IntegerLimbs const& l1, IntegerLimbs const& l2) {
+        return IntegerLimbs(l1.negative!=l2.negative,mul_magnitude(l1.magnitude,l2.magnitude));
+    }
+    friend int compare(IntegerLimbs const& l1, IntegerLimbs const& l2) {
+        if (l1.negative!=l2.negative) { return l1.negative ? -1 : +1; }
+        int c=compare_magnitude(l1.magnitude,l2.magnitude);
+        return l1.negative ? -c : c;
+    }
+};
+
+} // namespace Detail
+
+using Detail::IntegerLimbs;
+
+Integer::Integer() : _value(0), _limbs(nullptr) {}
+
+Integer::Integer(String const& str) : _value(0), _limbs(nullptr) {
+    size_t i=0u;
+    bool negative=false;
+    if (i<str.size() and (str[i]=='-' or str[i]=='+')) { negative=(str[i]=='-'); ++i; }
+    HELPER_PRECONDITION_MSG(i<str.size(),"Cannot convert string \""<<str<<"\" to an Integer");
+    IntegerLimbs l;
+    for ( ; i!=str.size(); ++i) {
+        HELPER_PRECONDITION_MSG(str[i]>='0' and str[i]<='9',"Cannot convert string \""<<str<<"\" to an Integer");
+        l=l*IntegerLimbs(false,{10u})+IntegerLimbs(false,{static_cast<IntegerLimbs::Limb>(str[i]-'0')});
+    }
+    if (negative) { l=-l; }
+    *this=IntegerLimbs::make(std::move(l));
+}
+
+void Integer::_set(unsigned long long int val) {
+    if (val<=static_cast<unsigned long long int>(std::numeric_limits<long int>::max())) { _value=static_cast<long int>(val); }
+    else { _limbs=new IntegerLimbs(false,{static_cast<IntegerLimbs::Limb>(val)}); }
+}
+
+bool Integer::_get_unsigned(unsigned long long int& val) const {
+    if (!_limbs) { val=static_cast<unsigned long long int>(_value); return _value>=0; }
+    if (_limbs->negative or _limbs->magnitude.size()!=1u) { return false; }
+    val=_limbs->magnitude[0]; return true;
+}
+
+IntegerLimbs* Integer::_copy(IntegerLimbs const* limbs) {
+    return new IntegerLimbs(*limbs);
+}
+
+void Integer::_destroy(IntegerLimbs* limbs) {
+    delete limbs;
+}
+
+long int const& Integer::value() const {
+    if (_limbs!=nullptr) {
+        HELPER_THROW(std::runtime_error,"Integer::value()","Integer "<<*this<<" does not fit in a long int");
+    }
+    return _value;
+}
+
+double Integer::get_d() const {
+    if (!_limbs) { return static_cast<double>(_value); }
+    double r=0.0;
+    for (size_t i=_limbs->magnitude.size(); i!=0u; --i) { r=std::ldexp(r,64)+static_cast<double>(_limbs->magnitude[i-1]); }
+    return _limbs->negative ? -r : r;
+}
 
 Integer& Integer::operator=(const Integer& z) {
-    _value = z._value;
+    if (this!=&z) {
+        if (_limbs) { _destroy(_limbs); _limbs=nullptr; }
+        _value = z._value;
+        if (z._limbs) { _limbs=_copy(z._limbs); }
+    }
     return *this;
 }
 
 Integer& operator++(Integer& z) {
-    z._value++;
-    return z;
+    return z+=Integer(1);
 }
 
 Integer& operator--(Integer& z) {
-    z._value--;
-    return z;
+    return z-=Integer(1);
 }
 
 Integer& operator+=(Integer& z1, Integer const& z2) {
-    z1._value += z2._value;
-    return z1;
+    long int r;
+    if (!z1._limbs and !z2._limbs and !__builtin_add_overflow(z1._value,z2._value,&r)) { z1._value=r; return z1; }
+    return z1=add(z1,z2);
 }
 
 Integer& operator-=(Integer& z1, Integer const& z2) {
-    z1._value -= z2._value;
-    return z1;
+    long int r;
+    if (!z1._limbs and !z2._limbs and !__builtin_sub_overflow(z1._value,z2._value,&r)) { z1._value=r; return z1; }
+    return z1=sub(z1,z2);
 }
 
 Integer& operator*=(Integer& z1, Integer const& z2) {
-    z1._value *= z2._value;
-    return z1;
+    long int r;
+    if (!z1._limbs and !z2._limbs and !__builtin_mul_overflow(z1._value,z2._value,&r)) { z1._value=r; return z1; }
+    return z1=mul(z1,z2);
 }
 
 Integer nul(Integer const&) {
@@ -87,36 +283,67 @@ Integer pos(Integer const& z) {
 }
 
 Integer neg(Integer const& z) {
-    return Integer(-z._value);
+    long int r;
+    if (!z._limbs and !__builtin_sub_overflow(0l,z._value,&r)) { return Integer(r); }
+    return IntegerLimbs::make(-IntegerLimbs::of(z));
 }
 
 Natural sqr(Integer const& z) {
-    return Natural(static_cast<unsigned long int>(z._value*z._value));
+    return Natural(mul(z,z));
 }
 
 Integer add(Integer const& z1, Integer const& z2) {
-    return Integer(z1._value+z2._value);
+    long int r;
+    if (!z1._limbs and !z2._limbs and !__builtin_add_overflow(z1._value,z2._value,&r)) { return Integer(r); }
+    return IntegerLimbs::make(IntegerLimbs::of(z1)+IntegerLimbs::of(z2));
 }
 
 Integer sub(Integer const& z1, Integer const& z2) {
-    return Integer(z1._value-z2._value);
+    long int r;
+    if (!z1._limbs and !z2._limbs and !__builtin_sub_overflow(z1._value,z2._value,&r)) { return Integer(r); }
+    return IntegerLimbs::make(IntegerLimbs::of(z1)+(-IntegerLimbs::of(z2)));
 }
 
 Integer mul(Integer const& z1, Integer const& z2) {
-    return Integer(z1._value*z2._value);
+    long int r;
+    if (!z1._limbs and !z2._limbs and !__builtin_mul_overflow(z1._value,z2._value,&r)) { return Integer(r); }
+    return IntegerLimbs::make(IntegerLimbs::of(z1)*IntegerLimbs::of(z2));
 }
 
 Integer quot(Integer const& z1, Integer const& z2) {
-    return Integer(z1._value/z2._value);
+    HELPER_PRECONDITION_MSG(!is_zero(z2),"Division of "<<z1<<" by zero");
+    if (!z1._limbs and !z2._limbs and z2._value!=-1) { return Integer(z1._value/z2._value); }
+    IntegerLimbs l1=IntegerLimbs::of(z1), l2=IntegerLimbs::of(z2);
+    std::vector<IntegerLimbs::Limb> q, r;
+    IntegerLimbs::divide_magnitude(l1.magnitude,l2.magnitude,q,r);
+    return IntegerLimbs::make(IntegerLimbs(l1.negative!=l2.negative,std::move(q)));
 }
 
 Integer rem(Integer const& z1, Integer const& z2) {
-    return Integer(z1._value % z2._value);
+    HELPER_PRECONDITION_MSG(!is_zero(z2),"Division of "<<z1<<" by zero");
+    if (!z1._limbs and !z2._limbs) { return Integer(z2._value==-1 ? 0l : z1._value % z2._value); }
+    IntegerLimbs l1=IntegerLimbs::of(z1), l2=IntegerLimbs::of(z2);
+    std::vector<IntegerLimbs::Limb> q, r;
+    IntegerLimbs::divide_magnitude(l1.magnitude,l2.magnitude,q,r);
+    return IntegerLimbs::make(IntegerLimbs(l1.negative,std::move(r)));
+}
+
+Integer operator/(Integer const& z1, Integer const& z2) {
+    return quot(z1,z2);
+}
+
+Integer operator%(Integer const& z1, Integer const& z2) {
+    return rem(z1,z2);
 }
 
 Integer pow(Integer const& z, unsigned int m) {
-    unsigned long int lm=m;
-    return Integer(static_cast<int>(std::pow(z._value,lm)));
+    Integer r(1), p(z);
+    while (m!=0u) {
+        if (m&1u) { r*=p; }
+        m>>=1;
+        if (m!=0u) { p*=p; }
+    }
+    return r;
 }
 
 Integer min(Integer const& z1,Integer const& z2) {
@@ -128,7 +355,7 @@ Integer max(Integer const& z1,Integer const& z2) {
 }
 
 Natural abs(Integer const& z) {
-    return Natural(static_cast<unsigned long int>(std::abs(z._value)));
+    return Natural(sgn(z)==Sign::NEGATIVE ? neg(z) : z);
 }
 
 Natural max(Natural const& z1,Natural const& z2) {
@@ -152,17 +379,20 @@ bool is_finite(Integer const&) {
 }
 
 bool is_zero(Integer const& z) {
-    return z._value==0;
+    return !z._limbs and z._value==0;
 }
 
 Sign sgn(Integer const& z) {
+    if (z._limbs) return z._limbs->negative ? Sign::NEGATIVE : Sign::POSITIVE;
     if (z._value > 0) return Sign::POSITIVE;
     else if (z._value < 0) return Sign::NEGATIVE;
     else return Sign::ZERO;
 }
 
 Comparison cmp(Integer const& z1, Integer const& z2) {
-    auto c=z1._value-z2._value;
+    int c;
+    if (!z1._limbs and !z2._limbs) { c = z1._value==z2._value ? 0 : (z1._value>z2._value ? +1 : -1); }
+    else { c=compare(IntegerLimbs::of(z1),IntegerLimbs::of(z2)); }
     return c==0 ? Comparison::EQUAL : (c>0?Comparison::GREATER:Comparison::LESS);
 }
 
@@ -171,15 +401,32 @@ Comparison cmp(Integer const& z1, int const& n2) {
 }
 
 Boolean eq(Integer const& z1, Integer const& z2) {
-    return z1._value==z2._value;
+    if (!z1._limbs and !z2._limbs) { return z1._value==z2._value; }
+    return cmp(z1,z2)==Comparison::EQUAL;
 }
 
 Boolean lt(Integer const& z1, Integer const& z2) {
-    return z1._value < z2._value;
+    if (!z1._limbs and !z2._limbs) { return z1._value < z2._value; }
+    return cmp(z1,z2)==Comparison::LESS;
 }
 
 String Integer::literal() const {
-    return to_string(_value);
+    if (!_limbs) { return to_string(_value); }
+    // Peel off blocks of 19 decimal digits, the largest power of ten fitting in a limb
+    IntegerLimbs::Limb const base=10000000000000000000ull;
+    std::vector<IntegerLimbs::Limb> m=_limbs->magnitude;
+    std::vector<IntegerLimbs::Limb> blocks;
+    while (!m.empty()) {
+        blocks.push_back(IntegerLimbs::divide_magnitude(m,base));
+        while (!m.empty() and m.back()==0u) { m.pop_back(); }
+    }
+    String r = _limbs->negative ? "-" : "";
+    r+=to_string(blocks.back());
+    for (size_t i=blocks.size()-1u; i!=0u; --i) {
+        String b=to_string(blocks[i-1]);
+        r+=String(19u-b.size(),'0')+b;
+    }
+    return r;
 }
 
 ostream& operator<<(ostream& os, Integer const& z) {
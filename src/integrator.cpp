@@ -0,0 +1,364 @@
+/***************************************************************************
+ *            integrator.cpp
+ *
+ *  Copyright  2023  Luca Geretti
+ *
+ ****************************************************************************/
+
+/*
+ * This file is part of SymboliCore, under the MIT license.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+/*! \file integrator.cpp
+ *  \brief Explicit Runge-Kutta integrators for ordinary differential equations.
+ */
+
+#include <cmath>
+#include <algorithm>
+
+#include "helper/macros.hpp"
+#include "integrator.hpp"
+
+namespace SymboliCore {
+
+ostream& operator<<(ostream& os, StepStatistics const& s) {
+    return os << "{time=" << s.time << ", step_size=" << s.step_size << ", error=" << s.error << ", accepted=" << s.accepted << "}";
+}
+
+ostream& operator<<(ostream& os, IntegrationStatistics const& s) {
+    return os << "{accepted_steps=" << s.accepted_steps << ", rejected_steps=" << s.rejected_steps
+              << ", function_evaluations=" << s.function_evaluations
+              << ", minimum_step_size=" << s.minimum_step_size << ", maximum_step_size=" << s.maximum_step_size << "}";
+}
+
+IntegratorSettings IntegratorSettings::default_settings() {
+    IntegratorSettings result;
+    result.relative_tolerance=1e-6;
+    result.absolute_tolerance=1e-9;
+    result.initial_step_size=0.0;
+    result.minimum_step_size=0.0;
+    result.maximum_step_size=std::numeric_limits<double>::infinity();
+    result.maximum_steps=1000000u;
+    return result;
+}
+
+namespace {
+
+void record_accepted(IntegrationStatistics& s, double h) {
+    ++s.accepted_steps;
+    s.minimum_step_size=std::min(s.minimum_step_size,h);
+    s.maximum_step_size=std::max(s.maximum_step_size,h);
+}
+
+size_t workspace_size(VectorField const& vf) {
+    return std::max(vf.workspace_size(),vf.batch_workspace_size());
+}
+
+// Coefficients of the Dormand-Prince 5(4) pair, as given by Hairer, Norsett and Wanner
+constexpr double a21=1.0/5;
+constexpr double a31=3.0/40, a32=9.0/40;
+constexpr double a41=44.0/45, a42=-56.0/15, a43=32.0/9;
+constexpr double a51=19372.0/6561, a52=-25360.0/2187, a53=64448.0/6561, a54=-212.0/729;
+constexpr double a61=9017.0/3168, a62=-355.0/33, a63=46732.0/5247, a64=49.0/176, a65=-5103.0/18656;
+constexpr double a71=35.0/384, a73=500.0/1113, a74=125.0/192, a75=-2187.0/6784, a76=11.0/84;
+constexpr double e1=71.0/57600, e3=-71.0/16695, e4=71.0/1920, e5=-17253.0/339200, e6=22.0/525, e7=-1.0/40;
+constexpr double d1=-12715105075.0/11282082432, d3=87487479700.0/32700410799, d4=-10690763975.0/1880347072,
+                 d5=701980252875.0/199316789632, d6=-1453857185.0/822651844, d7=69997945.0/29380423;
+
+// Bounds on the factor by which the step size changes
+constexpr double safety=0.9, facmin=0.2, facmax=10.0;
+
+} // namespace
+
+RungeKutta4Integrator::RungeKutta4Integrator(VectorField const& vf)
+    : _vf(vf), _statistics(), _k1(vf.dimension()), _k2(vf.dimension()), _k3(vf.dimension()), _k4(vf.dimension()), _y(vf.dimension()),
+      _w(workspace_size(vf))
+{
+}
+
+RungeKutta4Integrator::RungeKutta4Integrator(DottedRealAssignments const& dynamics, RealSpace const& spc)
+    : RungeKutta4Integrator(VectorField(dynamics,spc))
+{
+}
+
+void RungeKutta4Integrator::_evaluate(size_t count, const double* x, double* f) {
+    if (count==1u) { _vf(x,f,_w.data()); } else { _vf.batch(count,x,f,std::span<double>(_w)); }
+    ++_statistics.function_evaluations;
+}
+
+StepStatistics RungeKutta4Integrator::step(size_t count, double t, double* x, double h) {
+    size_t const N=count*this->dimension();
+    if (_k1.size()<N) { for (auto* v : {&_k1,&_k2,&_k3,&_k4,&_y}) { v->resize(N); } }
+    double* k1=_k1.data(); double* k2=_k2.data(); double* k3=_k3.data(); double* k4=_k4.data(); double* y=_y.data();
+    double const h2=h/2;
+
+    _evaluate(count,x,k1);
+    for (size_t i=0; i!=N; ++i) { y[i]=x[i]+h2*k1[i]; }
+    _evaluate(count,y,k2);
+    for (size_t i=0; i!=N; ++i) { y[i]=x[i]+h2*k2[i]; }
+    _evaluate(count,y,k3);
+    for (size_t i=0; i!=N; ++i) { y[i]=x[i]+h*k3[i]; }
+    _evaluate(count,y,k4);
+    double const h6=h/6;
+    for (size_t i=0; i!=N; ++i) { x[i]+=h6*((k1[i]+k4[i])+2*(k2[i]+k3[i])); }
+
+    record_accepted(_statistics,h);
+    return StepStatistics{t,h,0.0,true};
+}
+
+StepStatistics RungeKutta4Integrator::step(double t, double* x, double h) {
+    return this->step(1u,t,x,h);
+}
+
+void RungeKutta4Integrator::integrate(size_t count, double* x, double t0, double t1, double h, StepObserver const& observer) {
+    HELPER_PRECONDITION(h>0.0 && t1>=t0);
+    auto const steps=static_cast<size_t>(std::ceil((t1-t0)/h));
+    double const hs=(t1-t0)/static_cast<double>(steps);
+    for (size_t i=0; i!=steps; ++i) {
+        StepStatistics s=this->step(count,t0+static_cast<double>(i)*hs,x,hs);
+        if (observer) { observer(s); }
+    }
+}
+
+void RungeKutta4Integrator::integrate(double* x, double t0, double t1, double h, StepObserver const& observer) {
+    this->integrate(1u,x,t0,t1,h,observer);
+}
+
+Vector<Real> RungeKutta4Integrator::integrate(Vector<Real> const& x0, double t0, double t1, double h) {
+    HELPER_PRECONDITION(x0.size()==this->dimension());
+    std::vector<double> x(x0.size());
+    for (size_t i=0; i!=x.size(); ++i) { x[i]=x0[i].value(); }
+    this->integrate(x.data(),t0,t1,h);
+    return Vector<Real>(x.size(),[&x](size_t i){return Real(x[i]);});
+}
+
+DormandPrinceIntegrator::DormandPrinceIntegrator(VectorField const& vf, IntegratorSettings const& settings)
+    : _vf(vf), _settings(settings), _statistics(), _w(workspace_size(vf)),
+      _count(0u), _t_old(0.0), _h_old(0.0), _first_same_as_last(false), _facmax(facmax)
+{
+    this->_reserve(vf.dimension());
+}
+
+DormandPrinceIntegrator::DormandPrinceIntegrator(DottedRealAssignments const& dynamics, RealSpace const& spc, IntegratorSettings const& settings)
+    : DormandPrinceIntegrator(VectorField(dynamics,spc),settings)
+{
+}
+
+void DormandPrinceIntegrator::_reserve(size_t size) {
+    if (_k1.size()<size) {
+        for (auto* v : {&_k1,&_k2,&_k3,&_k4,&_k5,&_k6,&_k7,&_y,&_r1,&_r2,&_r3,&_r4,&_r5}) { v->resize(size); }
+        _first_same_as_last=false;
+        _h_old=0.0;
+    }
+}
+
+void DormandPrinceIntegrator::_evaluate(size_t count, const double* x, double* f) {
+    if (count==1u) { _vf(x,f,_w.data()); } else { _vf.batch(count,x,f,std::span<double>(_w)); }
+    ++_statistics.function_evaluations;
+}
+
+StepStatistics DormandPrinceIntegrator::step(size_t count, double& t, double* x, double& h) {
+    size_t const n=this->dimension();
+    size_t const N=count*n;
+    this->_reserve(N);
+    double* k1=_k1.data(); double* k2=_k2.data(); double* k3=_k3.data(); double* k4=_k4.data();
+    double* k5=_k5.data(); double* k6=_k6.data(); double* k7=_k7.data(); double* y=_y.data();
+
+    // The first stage is the last stage of the previous step, if that step ended at the current states
+    if (not (_first_same_as_last && count==_count && std::equal(x,x+N,y))) { _evaluate(count,x,k1); }
+
+    for (size_t i=0; i!=N; ++i) { y[i]=x[i]+h*(a21*k1[i]); }
+    _evaluate(count,y,k2);
+    for (size_t i=0; i!=N; ++i) { y[i]=x[i]+h*(a31*k1[i]+a32*k2[i]); }
+    _evaluate(count,y,k3);
+    for (size_t i=0; i!=N; ++i) { y[i]=x[i]+h*(a41*k1[i]+a42*k2[i]+a43*k3[i]); }
+    _evaluate(count,y,k4);
+    for (size_t i=0; i!=N; ++i) { y[i]=x[i]+h*(a51*k1[i]+a52*k2[i]+a53*k3[i]+a54*k4[i]); }
+    _evaluate(count,y,k5);
+    for (size_t i=0; i!=N; ++i) { y[i]=x[i]+h*(a61*k1[i]+a62*k2[i]+a63*k3[i]+a64*k4[i]+a65*k5[i]); }
+    _evaluate(count,y,k6);
+    for (size_t i=0; i!=N; ++i) { y[i]=x[i]+h*(a71*k1[i]+a73*k3[i]+a74*k4[i]+a75*k5[i]+a76*k6[i]); }
+    _evaluate(count,y,k7);
+
+    // The largest root-mean-square scaled error over the states
+    double error=0.0;
+    double const rtol=_settings.relative_tolerance, atol=_settings.absolute_tolerance;
+    for (size_t p=0; p!=count; ++p) {
+        double sum=0.0;
+        for (size_t i=p*n; i!=(p+1u)*n; ++i) {
+            double const e=h*(e1*k1[i]+e3*k3[i]+e4*k4[i]+e5*k5[i]+e6*k6[i]+e7*k7[i]);
+            double const sc=atol+rtol*std::max(std::abs(x[i]),std::abs(y[i]));
+            sum+=(e/sc)*(e/sc);
+        }
+        error=std::max(error,n==0u ? 0.0 : std::sqrt(sum/static_cast<double>(n)));
+    }
+    if (std::isnan(error)) { error=std::numeric_limits<double>::infinity(); }
+
+    StepStatistics result{t,h,error,error<=1.0};
+    double const fac=(error==0.0) ? _facmax : std::min(_facmax,std::max(facmin,safety*std::pow(error,-0.2)));
+    if (result.accepted) {
+        // Coefficients of the continuous extension over the step
+        for (size_t i=0; i!=N; ++i) {
+            double const ydiff=y[i]-x[i];
+            double const bspl=h*k1[i]-ydiff;
+            _r1[i]=x[i];
+            _r2[i]=ydiff;
+            _r3[i]=bspl;
+            _r4[i]=ydiff-h*k7[i]-bspl;
+            _r5[i]=h*(d1*k1[i]+d3*k3[i]+d4*k4[i]+d5*k5[i]+d6*k6[i]+d7*k7[i]);
+        }
+        std::copy(y,y+N,x);
+        std::swap(_k1,_k7);
+        _first_same_as_last=true;
+        _count=count;
+        _t_old=t;
+        _h_old=h;
+        t+=h;
+        _facmax=facmax;
+        record_accepted(_statistics,h);
+    } else {
+        // The first stage is still valid for the states, which are kept
+        std::copy(x,x+N,y);
+        _first_same_as_last=(count==_count);
+        // Do not increase the step size straight after a rejection
+        _facmax=1.0;
+        ++_statistics.rejected_steps;
+    }
+    h=std::min(h*fac,_settings.maximum_step_size);
+    return result;
+}
+
+StepStatistics DormandPrinceIntegrator::step(double& t, double* x, double& h) {
+    return this->step(1u,t,x,h);
+}
+
+double DormandPrinceIntegrator::_initial_step_size(size_t count, double t0, double t1, const double* x) {
+    if (_settings.initial_step_size>0.0) { return std::min(_settings.initial_step_size,_settings.maximum_step_size); }
+    size_t const N=count*this->dimension();
+    this->_reserve(N);
+    double* f0=_k1.data(); double* y1=_k2.data(); double* f1=_k3.data();
+    _evaluate(count,x,f0);
+    std::copy(x,x+N,_y.data());
+    _first_same_as_last=true;
+    _count=count;
+
+    // The estimate of Hairer, Norsett and Wanner, from the sizes of the state, the derivative and the second derivative
+    double const rtol=_settings.relative_tolerance, atol=_settings.absolute_tolerance;
+    auto rms=[&](auto const& g) {
+        double sum=0.0;
+        for (size_t i=0; i!=N; ++i) { double const r=g(i)/(atol+rtol*std::abs(x[i])); sum+=r*r; }
+        return N==0u ? 0.0 : std::sqrt(sum/static_cast<double>(N));
+    };
+    double const dx=rms([&](size_t i){return x[i];});
+    double const df=rms([&](size_t i){return f0[i];});
+    double h0=(dx<1e-5 || df<1e-5) ? 1e-6 : 0.01*dx/df;
+    h0=std::min({h0,t1-t0,_settings.maximum_step_size});
+    if (not (h0>0.0)) { return _settings.maximum_step_size; }
+    for (size_t i=0; i!=N; ++i) { y1[i]=x[i]+h0*f0[i]; }
+    _evaluate(count,y1,f1);
+    double const ddf=rms([&](size_t i){return f1[i]-f0[i];})/h0;
+    double const dmax=std::max(df,ddf);
+    double const h1=(dmax<=1e-15) ? std::max(1e-6,h0*1e-3) : std::pow(0.01/dmax,0.2);
+    return std::min({100*h0,h1,_settings.maximum_step_size});
+}
+
+void DormandPrinceIntegrator::_start(size_t count, double t0, const double* x) {
+    this->_reserve(count*this->dimension());
+    // Without a step, the dense output is the initial state
+    std::copy(x,x+count*this->dimension(),_r1.data());
+    for (auto* v : {&_r2,&_r3,&_r4,&_r5}) { std::fill(v->begin(),v->end(),0.0); }
+    _count=count;
+    _t_old=t0;
+    _h_old=0.0;
+    _facmax=facmax;
+}
+
+void DormandPrinceIntegrator::integrate(size_t count, double* x, double t0, double t1, StepObserver const& observer) {
+    HELPER_PRECONDITION(t1>=t0);
+    this->_start(count,t0,x);
+    double t=t0;
+    double h=this->_initial_step_size(count,t0,t1,x);
+    size_t steps=0u;
+    while (t<t1) {
+        double hs=std::min(h,t1-t);
+        bool const last=(hs==t1-t);
+        if ((hs<_settings.minimum_step_size && not last) || t+hs==t) {
+            HELPER_THROW(std::runtime_error,"DormandPrinceIntegrator::integrate(...)","Step size "<<hs<<" at time "<<t<<" is too small");
+        }
+        if (steps++==_settings.maximum_steps) {
+            HELPER_THROW(std::runtime_error,"DormandPrinceIntegrator::integrate(...)","Maximum number of steps "<<_settings.maximum_steps<<" reached at time "<<t);
+        }
+        StepStatistics s=this->step(count,t,x,hs);
+        if (s.accepted && last) { t=t1; }
+        h=hs;
+        if (observer) { observer(s); }
+    }
+}
+
+void DormandPrinceIntegrator::integrate(double* x, double t0, double t1, StepObserver const& observer) {
+    this->integrate(1u,x,t0,t1,observer);
+}
+
+void DormandPrinceIntegrator::integrate(double* x, double t0, List<double> const& times, double* y) {
+    size_t const n=this->dimension();
+    if (times.empty()) { return; }
+    double const t1=times.back();
+    HELPER_PRECONDITION(times.front()>=t0);
+    this->_start(1u,t0,x);
+    double t=t0;
+    double h=this->_initial_step_size(1u,t0,t1,x);
+    size_t steps=0u;
+    for (size_t k=0; k!=times.size(); ++k) {
+        HELPER_PRECONDITION(k==0u || times[k]>=times[k-1u]);
+        while (t<times[k]) {
+            double hs=std::min(h,t1-t);
+            bool const last=(hs==t1-t);
+            if ((hs<_settings.minimum_step_size && not last) || t+hs==t) {
+                HELPER_THROW(std::runtime_error,"DormandPrinceIntegrator::integrate(...)","Step size "<<hs<<" at time "<<t<<" is too small");
+            }
+            if (steps++==_settings.maximum_steps) {
+                HELPER_THROW(std::runtime_error,"DormandPrinceIntegrator::integrate(...)","Maximum number of steps "<<_settings.maximum_steps<<" reached at time "<<t);
+            }
+            StepStatistics s=this->step(1u,t,x,hs);
+            if (s.accepted && last) { t=t1; _h_old=t1-_t_old; }
+            h=hs;
+        }
+        if (times[k]==t) { std::copy(x,x+n,y+k*n); } else { this->dense_output(times[k],y+k*n); }
+    }
+}
+
+Vector<Real> DormandPrinceIntegrator::integrate(Vector<Real> const& x0, double t0, double t1) {
+    HELPER_PRECONDITION(x0.size()==this->dimension());
+    std::vector<double> x(x0.size());
+    for (size_t i=0; i!=x.size(); ++i) { x[i]=x0[i].value(); }
+    this->integrate(x.data(),t0,t1);
+    return Vector<Real>(x.size(),[&x](size_t i){return Real(x[i]);});
+}
+
+void DormandPrinceIntegrator::dense_output(double t, double* y) const {
+    HELPER_PRECONDITION_MSG(t>=_t_old && t<=_t_old+_h_old,"Time "<<t<<" is not within the last step ["<<_t_old<<":"<<_t_old+_h_old<<"]");
+    size_t const N=_count*this->dimension();
+    double const theta=(_h_old==0.0) ? 0.0 : (t-_t_old)/_h_old;
+    double const theta1=1.0-theta;
+    for (size_t i=0; i!=N; ++i) {
+        y[i]=_r1[i]+theta*(_r2[i]+theta1*(_r3[i]+theta*(_r4[i]+theta1*_r5[i])));
+    }
+}
+
+} // namespace SymboliCore
@@ -0,0 +1,372 @@
+/***************************************************************************
+ *            interval.cpp
+ *
+ *  Copyright  2023  Luca Geretti
+ *
+ ****************************************************************************/
+
+/*
+ * This file is part of SymboliCore, under the MIT license.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*! \file interval.cpp
+ *  \brief Intervals with outward-rounded arithmetic.
+ */
+
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+#include "interval.hpp"
+
+namespace SymboliCore {
+
+namespace {
+
+constexpr double inf = std::numeric_limits<double>::infinity();
+constexpr double pi = 3.141592653589793238;
+// Below this magnitude, the error terms computed by fma may underflow, so results are widened unconditionally.
+constexpr double tiny = 0x1p-960;
+
+inline double next_down(double x) { return std::nextafter(x,-inf); }
+inline double next_up(double x) { return std::nextafter(x,+inf); }
+
+// The algebraic operations use error-free transformations to find the sign of the rounding error,
+// so that exact results are not widened. The default round-to-nearest mode is assumed.
+inline bool both_finite(double a, double b) { return std::isfinite(a) && std::isfinite(b); }
+
+double add_down(double a, double b) {
+    double s=a+b;
+    if (!std::isfinite(s)) { return both_finite(a,b) ? next_down(s) : s; }
+    double bb=s-a; double e=(a-(s-bb))+(b-bb);
+    return e<0 ? next_down(s) : s;
+}
+double add_up(double a, double b) {
+    double s=a+b;
+    if (!std::isfinite(s)) { return both_finite(a,b) ? next_up(s) : s; }
+    double bb=s-a; double e=(a-(s-bb))+(b-bb);
+    return e>0 ? next_up(s) : s;
+}
+
+// Multiplication by zero gives zero even for infinite factors, as needed for bounds of intervals.
+double mul_down(double a, double b) {
+    if (a==0 || b==0) { return 0.0; }
+    double p=a*b;
+    if (!std::isfinite(p)) { return both_finite(a,b) ? next_down(p) : p; }
+    if (std::abs(p)<tiny) { return next_down(p); }
+    return std::fma(a,b,-p)<0 ? next_down(p) : p;
+}
+double mul_up(double a, double b) {
+    if (a==0 || b==0) { return 0.0; }
+    double p=a*b;
+    if (!std::isfinite(p)) { return both_finite(a,b) ? next_up(p) : p; }
+    if (std::abs(p)<tiny) { return next_up(p); }
+    return std::fma(a,b,-p)>0 ? next_up(p) : p;
+}
+
+// Requires finite a and b with b nonzero; the sign of the error a/b-q is the sign of (a-q*b)/b.
+double div_down(double a, double b) {
+    double q=a/b;
+    if (!std::isfinite(q)) { return next_down(q); }
+    if (std::abs(q)<tiny) { return next_down(q); }
+    double r=std::fma(-q,b,a);
+    return (b>0 ? r<0 : r>0) ? next_down(q) : q;
+}
+double div_up(double a, double b) {
+    double q=a/b;
+    if (!std::isfinite(q)) { return next_up(q); }
+    if (std::abs(q)<tiny) { return next_up(q); }
+    double r=std::fma(-q,b,a);
+    return (b>0 ? r>0 : r<0) ? next_up(q) : q;
+}
+
+double sqrt_down(double a) {
+    double s=std::sqrt(a);
+    if (!std::isfinite(s) || s==0) { return s; }
+    if (a<tiny) { return next_down(s); }
+    return std::fma(-s,s,a)<0 ? next_down(s) : s;
+}
+double sqrt_up(double a) {
+    double s=std::sqrt(a);
+    if (!std::isfinite(s) || s==0) { return s; }
+    if (a<tiny) { return next_up(s); }
+    return std::fma(-s,s,a)>0 ? next_up(s) : s;
+}
+
+// Powers of a nonnegative value, for which directed multiplication is monotone.
+double pow_down(double a, unsigned int n) {
+    double r=1.0;
+    while (n!=0) { if (n%2) { r=mul_down(r,a); } n/=2; if (n!=0) { a=mul_down(a,a); } }
+    return r;
+}
+double pow_up(double a, unsigned int n) {
+    double r=1.0;
+    while (n!=0) { if (n%2) { r=mul_up(r,a); } n/=2; if (n!=0) { a=mul_up(a,a); } }
+    return r;
+}
+
+// Values from the C library are widened by two units in the last place.
+inline double libm_down(double x) { return std::isnan(x) ? x : next_down(next_down(x)); }
+inline double libm_up(double x) { return std::isnan(x) ? x : next_up(next_up(x)); }
+
+inline RealInterval make_interval(double l, double u) { return RealInterval(Real(l),Real(u)); }
+inline RealInterval empty_interval() { return make_interval(+inf,-inf); }
+inline RealInterval entire_interval() { return make_interval(-inf,+inf); }
+
+//! \brief Tests whether some point \a c+k×p for integer \a k lies in \a [l,u], with \a c and \a p given as multiples of \a pi.
+//! \details A positive answer may be given for points very close to the interval, which only widens the results using it.
+bool contains_periodic_point(double l, double u, double c, double p) {
+    double tl=l/(p*pi)-c/p, tu=u/(p*pi)-c/p;
+    double dl=1e-12*std::max(1.0,std::abs(tl)), du=1e-12*std::max(1.0,std::abs(tu));
+    return std::floor(tu+du)>=std::ceil(tl-dl);
+}
+
+RealInterval clamp_unit(double l, double u) { return make_interval(std::max(l,-1.0),std::min(u,1.0)); }
+
+} // namespace
+
+Real midpoint(RealInterval const& ivl) {
+    double l=ivl.lower_bound().value(), u=ivl.upper_bound().value();
+    if (l==-inf && u==+inf) { return Real(0.0); }
+    if (l==-inf || u==+inf) { return Real(l==-inf ? u : l); }
+    return Real(l/2+u/2);
+}
+
+Real width(RealInterval const& ivl) {
+    if (ivl.is_empty()) { return Real(0.0); }
+    return Real(add_up(ivl.upper_bound().value(),-ivl.lower_bound().value()));
+}
+
+Real radius(RealInterval const& ivl) {
+    if (ivl.is_empty()) { return Real(0.0); }
+    double m=midpoint(ivl).value();
+    return Real(std::max(add_up(m,-ivl.lower_bound().value()),add_up(ivl.upper_bound().value(),-m)));
+}
+
+Real mag(RealInterval const& ivl) {
+    return Real(std::max(std::abs(ivl.lower_bound().value()),std::abs(ivl.upper_bound().value())));
+}
+
+RealInterval intersection(RealInterval const& ivl1, RealInterval const& ivl2) {
+    return make_interval(std::max(ivl1.lower_bound().value(),ivl2.lower_bound().value()),
+                         std::min(ivl1.upper_bound().value(),ivl2.upper_bound().value()));
+}
+
+RealInterval hull(RealInterval const& ivl1, RealInterval const& ivl2) {
+    if (ivl1.is_empty()) { return ivl2; }
+    if (ivl2.is_empty()) { return ivl1; }
+    return make_interval(std::min(ivl1.lower_bound().value(),ivl2.lower_bound().value()),
+                         std::max(ivl1.upper_bound().value(),ivl2.upper_bound().value()));
+}
+
+bool subset(RealInterval const& ivl1, RealInterval const& ivl2) {
+    return ivl1.is_empty() || (ivl2.lower_bound().value()<=ivl1.lower_bound().value() && ivl1.upper_bound().value()<=ivl2.upper_bound().value());
+}
+
+bool disjoint(RealInterval const& ivl1, RealInterval const& ivl2) {
+    return intersection(ivl1,ivl2).is_empty();
+}
+
+RealInterval nul(RealInterval const&) { return make_interval(0.0,0.0); }
+
+RealInterval pos(RealInterval const& ivl) { return ivl; }
+
+RealInterval neg(RealInterval const& ivl) {
+    return make_interval(-ivl.upper_bound().value(),-ivl.lower_bound().value());
+}
+
+RealInterval hlf(RealInterval const& ivl) {
+    return make_interval(mul_down(ivl.lower_bound().value(),0.5),mul_up(ivl.upper_bound().value(),0.5));
+}
+
+RealInterval sqr(RealInterval const& ivl) {
+    if (ivl.is_empty()) { return ivl; }
+    double l=ivl.lower_bound().value(), u=ivl.upper_bound().value();
+    if (l>=0) { return make_interval(mul_down(l,l),mul_up(u,u)); }
+    if (u<=0) { return make_interval(mul_down(u,u),mul_up(l,l)); }
+    return make_interval(0.0,std::max(mul_up(l,l),mul_up(u,u)));
+}
+
+RealInterval rec(RealInterval const& ivl) {
+    if (ivl.is_empty()) { return ivl; }
+    double l=ivl.lower_bound().value(), u=ivl.upper_bound().value();
+    if (l>0 || u<0) {
+        return make_interval(std::isinf(u) ? 0.0 : div_down(1.0,u),std::isinf(l) ? 0.0 : div_up(1.0,l));
+    }
+    if (l==0 && u>0) { return make_interval(std::isinf(u) ? 0.0 : div_down(1.0,u),+inf); }
+    if (u==0 && l<0) { return make_interval(-inf,std::isinf(l) ? 0.0 : div_up(1.0,l)); }
+    return entire_interval();
+}
+
+RealInterval add(RealInterval const& ivl1, RealInterval const& ivl2) {
+    if (ivl1.is_empty() || ivl2.is_empty()) { return empty_interval(); }
+    return make_interval(add_down(ivl1.lower_bound().value(),ivl2.lower_bound().value()),
+                         add_up(ivl1.upper_bound().value(),ivl2.upper_bound().value()));
+}
+
+RealInterval sub(RealInterval const& ivl1, RealInterval const& ivl2) {
+    if (ivl1.is_empty() || ivl2.is_empty()) { return empty_interval(); }
+    return make_interval(add_down(ivl1.lower_bound().value(),-ivl2.upper_bound().value()),
+                         add_up(ivl1.upper_bound().value(),-ivl2.lower_bound().value()));
+}
+
+RealInterval mul(RealInterval const& ivl1, RealInterval const& ivl2) {
+    if (ivl1.is_empty() || ivl2.is_empty()) { return empty_interval(); }
+    double l1=ivl1.lower_bound().value(), u1=ivl1.upper_bound().value();
+    double l2=ivl2.lower_bound().value(), u2=ivl2.upper_bound().value();
+    return make_interval(std::min({mul_down(l1,l2),mul_down(l1,u2),mul_down(u1,l2),mul_down(u1,u2)}),
+                         std::max({mul_up(l1,l2),mul_up(l1,u2),mul_up(u1,l2),mul_up(u1,u2)}));
+}
+
+RealInterval div(RealInterval const& ivl1, RealInterval const& ivl2) {
+    if (ivl1.is_empty() || ivl2.is_empty()) { return empty_interval(); }
+    double l1=ivl1.lower_bound().value(), u1=ivl1.upper_bound().value();
+    double l2=ivl2.lower_bound().value(), u2=ivl2.upper_bound().value();
+    if ((l2>0 || u2<0) && both_finite(l1,u1) && both_finite(l2,u2)) {
+        return make_interval(std::min({div_down(l1,l2),div_down(l1,u2),div_down(u1,l2),div_down(u1,u2)}),
+                             std::max({div_up(l1,l2),div_up(l1,u2),div_up(u1,l2),div_up(u1,u2)}));
+    }
+    return mul(ivl1,rec(ivl2));
+}
+
+RealInterval pow(RealInterval const& ivl, int n) {
+    if (n<0) { return rec(pow(ivl,-n)); }
+    if (ivl.is_empty()) { return ivl; }
+    unsigned int m=static_cast<unsigned int>(n);
+    double l=ivl.lower_bound().value(), u=ivl.upper_bound().value();
+    if (m%2==1) {
+        return make_interval(l>=0 ? pow_down(l,m) : -pow_up(-l,m), u>=0 ? pow_up(u,m) : -pow_down(-u,m));
+    }
+    if (l>=0) { return make_interval(pow_down(l,m),pow_up(u,m)); }
+    if (u<=0) { return make_interval(pow_down(-u,m),pow_up(-l,m)); }
+    return make_interval(m==0 ? 1.0 : 0.0,pow_up(std::max(-l,u),m));
+}
+
+RealInterval sqrt(RealInterval const& ivl) {
+    double l=ivl.lower_bound().value(), u=ivl.upper_bound().value();
+    if (ivl.is_empty() || u<0) { return empty_interval(); }
+    return make_interval(sqrt_down(std::max(l,0.0)),sqrt_up(u));
+}
+
+RealInterval exp(RealInterval const& ivl) {
+    if (ivl.is_empty()) { return ivl; }
+    double l=ivl.lower_bound().value(), u=ivl.upper_bound().value();
+    return make_interval(l==0 ? 1.0 : std::max(libm_down(std::exp(l)),0.0),u==0 ? 1.0 : libm_up(std::exp(u)));
+}
+
+RealInterval log(RealInterval const& ivl) {
+    double l=ivl.lower_bound().value(), u=ivl.upper_bound().value();
+    if (ivl.is_empty() || u<0) { return empty_interval(); }
+    return make_interval(l<=0 ? -inf : (l==1 ? 0.0 : libm_down(std::log(l))),u==1 ? 0.0 : libm_up(std::log(u)));
+}
+
+RealInterval sin(RealInterval const& ivl) {
+    if (ivl.is_empty()) { return ivl; }
+    double l=ivl.lower_bound().value(), u=ivl.upper_bound().value();
+    if (!both_finite(l,u) || u-l>=2*pi) { return make_interval(-1.0,+1.0); }
+    double sl=std::sin(l), su=std::sin(u);
+    double lower=contains_periodic_point(l,u,-0.5,2.0) ? -1.0 : libm_down(std::min(sl,su));
+    double upper=contains_periodic_point(l,u,+0.5,2.0) ? +1.0 : libm_up(std::max(sl,su));
+    return clamp_unit(lower,upper);
+}
+
+RealInterval cos(RealInterval const& ivl) {
+    if (ivl.is_empty()) { return ivl; }
+    double l=ivl.lower_bound().value(), u=ivl.upper_bound().value();
+    if (!both_finite(l,u) || u-l>=2*pi) { return make_interval(-1.0,+1.0); }
+    double cl=std::cos(l), cu=std::cos(u);
+    double lower=contains_periodic_point(l,u,1.0,2.0) ? -1.0 : libm_down(std::min(cl,cu));
+    double upper=contains_periodic_point(l,u,0.0,2.0) ? +1.0 : libm_up(std::max(cl,cu));
+    return clamp_unit(lower,upper);
+}
+
+RealInterval tan(RealInterval const& ivl) {
+    if (ivl.is_empty()) { return ivl; }
+    double l=ivl.lower_bound().value(), u=ivl.upper_bound().value();
+    if (!both_finite(l,u) || u-l>=pi || contains_periodic_point(l,u,0.5,1.0)) { return entire_interval(); }
+    return make_interval(libm_down(std::tan(l)),libm_up(std::tan(u)));
+}
+
+RealInterval asin(RealInterval const& ivl) {
+    double l=ivl.lower_bound().value(), u=ivl.upper_bound().value();
+    if (ivl.is_empty() || u<-1 || l>1) { return empty_interval(); }
+    return make_interval(libm_down(std::asin(std::max(l,-1.0))),libm_up(std::asin(std::min(u,1.0))));
+}
+
+RealInterval acos(RealInterval const& ivl) {
+    double l=ivl.lower_bound().value(), u=ivl.upper_bound().value();
+    if (ivl.is_empty() || u<-1 || l>1) { return empty_interval(); }
+    return make_interval(std::max(libm_down(std::acos(std::min(u,1.0))),0.0),libm_up(std::acos(std::max(l,-1.0))));
+}
+
+RealInterval atan(RealInterval const& ivl) {
+    if (ivl.is_empty()) { return ivl; }
+    return make_interval(libm_down(std::atan(ivl.lower_bound().value())),libm_up(std::atan(ivl.upper_bound().value())));
+}
+
+RealInterval abs(RealInterval const& ivl) {
+    if (ivl.is_empty()) { return ivl; }
+    double l=ivl.lower_bound().value(), u=ivl.upper_bound().value();
+    if (l>=0) { return ivl; }
+    if (u<=0) { return neg(ivl); }
+    return make_interval(0.0,std::max(-l,u));
+}
+
+RealInterval max(RealInterval const& ivl1, RealInterval const& ivl2) {
+    if (ivl1.is_empty() || ivl2.is_empty()) { return empty_interval(); }
+    return make_interval(std::max(ivl1.lower_bound().value(),ivl2.lower_bound().value()),
+                         std::max(ivl1.upper_bound().value(),ivl2.upper_bound().value()));
+}
+
+RealInterval min(RealInterval const& ivl1, RealInterval const& ivl2) {
+    if (ivl1.is_empty() || ivl2.is_empty()) { return empty_interval(); }
+    return make_interval(std::min(ivl1.lower_bound().value(),ivl2.lower_bound().value()),
+                         std::min(ivl1.upper_bound().value(),ivl2.upper_bound().value()));
+}
+
+ValidatedKleenean leq(RealInterval const& ivl1, RealInterval const& ivl2) {
+    if (ivl1.is_empty() || ivl2.is_empty()) { return ValidatedKleenean(LogicalValue::INDETERMINATE); }
+    if (ivl1.upper_bound().value()<=ivl2.lower_bound().value()) { return ValidatedKleenean(LogicalValue::TRUE); }
+    if (ivl1.lower_bound().value()>ivl2.upper_bound().value()) { return ValidatedKleenean(LogicalValue::FALSE); }
+    return ValidatedKleenean(LogicalValue::INDETERMINATE);
+}
+
+ValidatedKleenean lt(RealInterval const& ivl1, RealInterval const& ivl2) {
+    if (ivl1.is_empty() || ivl2.is_empty()) { return ValidatedKleenean(LogicalValue::INDETERMINATE); }
+    if (ivl1.upper_bound().value()<ivl2.lower_bound().value()) { return ValidatedKleenean(LogicalValue::TRUE); }
+    if (ivl1.lower_bound().value()>=ivl2.upper_bound().value()) { return ValidatedKleenean(LogicalValue::FALSE); }
+    return ValidatedKleenean(LogicalValue::INDETERMINATE);
+}
+
+ValidatedKleenean eq(RealInterval const& ivl1, RealInterval const& ivl2) {
+    if (ivl1.is_empty() || ivl2.is_empty()) { return ValidatedKleenean(LogicalValue::INDETERMINATE); }
+    if (disjoint(ivl1,ivl2)) { return ValidatedKleenean(LogicalValue::FALSE); }
+    if (ivl1.is_singleton() && ivl2.is_singleton()) { return ValidatedKleenean(LogicalValue::TRUE); }
+    return ValidatedKleenean(LogicalValue::INDETERMINATE);
+}
+
+ValidatedKleenean sgn(RealInterval const& ivl) {
+    if (ivl.is_empty()) { return ValidatedKleenean(LogicalValue::INDETERMINATE); }
+    if (ivl.lower_bound().value()>0) { return ValidatedKleenean(LogicalValue::TRUE); }
+    if (ivl.upper_bound().value()<0) { return ValidatedKleenean(LogicalValue::FALSE); }
+    return ValidatedKleenean(LogicalValue::INDETERMINATE);
+}
+
+} // namespace SymboliCore
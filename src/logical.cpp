@@ -30,6 +30,14 @@
  *  \brief
  */
 
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <vector>
+
 #include "helper/stdlib.hpp"
 #include "helper/string.hpp"
 #include "helper/macros.hpp"
@@ -48,13 +56,104 @@ inline LogicalValue check(LogicalValue l, Effort) { return l; }
 template<class OP, class ARG> decltype(auto) check(Symbolic<OP,ARG> const& s, Effort e) { return s._op(check(s._arg,e)); }
 template<class OP, class ARG1, class ARG2> decltype(auto) check(Symbolic<OP,ARG1,ARG2> const& s, Effort e) { return s._op(check(s._arg1,e),check(s._arg2,e)); }
 
+//! \brief A single-entry cache of the value of a lazy logical node at the last effort checked.
+//! \details A determinate value never changes at higher effort, so it is returned for any higher effort once found.
+//! The effort and value are packed into one atomic word so that shared nodes may be checked concurrently.
+class LogicalMemo {
+    mutable std::atomic<std::uint64_t> _entry;
+    static std::uint64_t _pack(Effort e, LogicalValue v) {
+        return (static_cast<std::uint64_t>(e.work())<<8) | static_cast<std::uint64_t>(static_cast<int>(v)+3); }
+  public:
+    LogicalMemo() : _entry(0u) { }
+    LogicalMemo(LogicalMemo const& other) : _entry(other._entry.load(std::memory_order_relaxed)) { }
+    LogicalMemo& operator=(LogicalMemo const& other) { _entry.store(other._entry.load(std::memory_order_relaxed),std::memory_order_relaxed); return *this; }
+
+    template<class F> LogicalValue operator()(Effort e, F const& f) const {
+        if (!LogicalHandle::memoisation()) { return f(e); }
+        std::uint64_t entry=_entry.load(std::memory_order_acquire);
+        if (entry!=0u) {
+            LogicalValue v=static_cast<LogicalValue>(static_cast<int>(entry&0xffu)-3);
+            if ((entry>>8)==e.work() or (is_determinate(v) and (entry>>8)<e.work())) { return v; }
+        }
+        LogicalValue v=f(e);
+        _entry.store(_pack(e,v),std::memory_order_release);
+        return v;
+    }
+};
+
+//! \brief Steps a node by re-checking it at each effort level.
+class LogicalCheckStepper : public LogicalStepperInterface {
+    LogicalInterface const* _ptr;
+    unsigned int _effort;
+  public:
+    LogicalCheckStepper(LogicalInterface const* ptr) : _ptr(ptr), _effort(0u) { }
+    LogicalValue _step() { return _ptr->_check(Effort(_effort++)); }
+};
+
+LogicalStepperInterface* LogicalInterface::_new_stepper() const {
+    return new LogicalCheckStepper(this);
+}
+
+LogicalStepper::LogicalStepper(LogicalHandle const& l)
+    : _handle(l), _ptr(l.is_constant() ? nullptr : l.pointer()->_new_stepper()), _effort(0u)
+    , _value(_ptr ? _ptr->_step() : l.value())
+{
+}
+
+LogicalValue LogicalStepper::step() {
+    ++_effort;
+    if (_ptr) { _value=_ptr->_step(); }
+    return _value;
+}
+
+LogicalValue check(LogicalHandle const& l, Deadline d, Effort& reached) {
+    LogicalStepper stepper(l);
+    while (not l.is_constant() and not is_determinate(stepper.value()) and not d.expired()) { stepper.step(); }
+    reached=stepper.effort();
+    return stepper.value();
+}
+
+//! \brief Steps a symbolic node by stepping its arguments, stopping once the value is determinate.
+template<class OP, class... ARGS> class LogicalSymbolicStepper;
+
+template<class OP> class LogicalSymbolicStepper<OP,LogicalHandle> : public LogicalStepperInterface {
+    OP _op; LogicalStepper _arg; bool _started; LogicalValue _value;
+  public:
+    LogicalSymbolicStepper(Symbolic<OP,LogicalHandle> const& s)
+        : _op(s._op), _arg(s._arg), _started(false), _value(LogicalValue::INDETERMINATE) { }
+    LogicalValue _step() {
+        if (not _started) { _started=true; _value=_op(_arg.value()); }
+        else if (not is_determinate(_value)) { _value=_op(_arg.step()); }
+        return _value;
+    }
+};
+
+template<class OP> class LogicalSymbolicStepper<OP,LogicalHandle,LogicalHandle> : public LogicalStepperInterface {
+    OP _op; LogicalStepper _arg1; LogicalStepper _arg2; bool _started; LogicalValue _value;
+  public:
+    LogicalSymbolicStepper(Symbolic<OP,LogicalHandle,LogicalHandle> const& s)
+        : _op(s._op), _arg1(s._arg1), _arg2(s._arg2), _started(false), _value(LogicalValue::INDETERMINATE) { }
+    LogicalValue _step() {
+        if (not _started) { _started=true; _value=_op(_arg1.value(),_arg2.value()); }
+        else if (not is_determinate(_value)) { _value=_op(_arg1.step(),_arg2.step()); }
+        return _value;
+    }
+};
+
+template<class OP, class... ARGS> LogicalStepperInterface* new_symbolic_stepper(Symbolic<OP,ARGS...> const& s) {
+    return new LogicalSymbolicStepper<OP,ARGS...>(s);
+}
+
 template<class L> class LogicalWrapper
     : public virtual LogicalInterface, public L
 {
     using L::L;
   private:
+    LogicalMemo _memo;
     virtual LogicalInterface* clone() const { return new LogicalWrapper<L>(*this); }
-    virtual LogicalValue _check(Effort e) const { return check(static_cast<L const&>(*this),e); }
+    virtual LogicalValue _check(Effort e) const {
+        return _memo(e,[this](Effort eff){return check(static_cast<L const&>(*this),eff);}); }
+    virtual LogicalStepperInterface* _new_stepper() const { return new_symbolic_stepper(static_cast<L const&>(*this)); }
     virtual ostream& _write(ostream& os) const { return os << static_cast<L const&>(*this); }
 };
 
@@ -69,6 +168,7 @@ template<> class LogicalWrapper<LogicalValue>
     virtual LogicalInterface* clone() const { return new LogicalWrapper<LogicalValue>(*this); }
     virtual LogicalValue _check(Effort) const { return this->_v; }
     virtual ostream& _write(ostream& os) const { return os << this->_v; }
+    virtual bool _is_constant() const { return true; }
 };
 
 
@@ -86,54 +186,65 @@ LogicalInterface* new_logical_pointer_from_value(LogicalValue v) {
 }
 
 LogicalValue logical_value_from_pointer(LogicalInterface* ptr) {
-    auto vlptr=dynamic_cast<LogicalWrapper<LogicalValue>*>(ptr);
-    if (!vlptr) { throw std::runtime_error("logical_type_from_pointer: No conversion from abstract to concrete logical value"); }
-    return *vlptr;
+    if (!ptr or !ptr->_is_constant()) { throw std::runtime_error("logical_type_from_pointer: No conversion from abstract to concrete logical value"); }
+    return ptr->_check(Effort(0u));
 }
 
-LogicalHandle LogicalHandle::constant(LogicalValue l) {
-    return LogicalHandle(make_handle<LogicalConstant>(l));
+LogicalValue logical_value_from_handle(LogicalHandle const& l) {
+    if (l.is_constant()) { return l.value(); }
+    return logical_value_from_pointer(const_cast<LogicalInterface*>(l.pointer()));
+}
+
+// Operations on two inline constants are folded immediately, so only lazy operands build an expression
+template<class OP> LogicalHandle _make_logical_handle(OP op, LogicalHandle const& l) {
+    if (l.is_constant()) { return LogicalHandle::constant(op(l.value())); }
+    return LogicalHandle(make_handle<LogicalExpression<OP,LogicalHandle>>(op,l));
+}
+
+template<class OP> LogicalHandle _make_logical_handle(OP op, LogicalHandle const& l1, LogicalHandle const& l2) {
+    if (l1.is_constant() and l2.is_constant()) { return LogicalHandle::constant(op(l1.value(),l2.value())); }
+    return LogicalHandle(make_handle<LogicalExpression<OP,LogicalHandle,LogicalHandle>>(op,l1,l2));
 }
 
 LogicalHandle operator&&(LogicalHandle l1, LogicalHandle l2) {
-    return LogicalHandle(make_handle<LogicalExpression<AndOp,LogicalHandle,LogicalHandle>>(AndOp(),l1,l2));
+    return _make_logical_handle(AndOp(),l1,l2);
 }
 
 LogicalHandle operator||(LogicalHandle l1, LogicalHandle l2) {
-    return LogicalHandle(make_handle<LogicalExpression<OrOp,LogicalHandle,LogicalHandle>>(OrOp(),l1,l2));
+    return _make_logical_handle(OrOp(),l1,l2);
 }
 
 LogicalHandle operator==(LogicalHandle l1, LogicalHandle l2) {
-    return LogicalHandle(make_handle<LogicalExpression<Equal,LogicalHandle,LogicalHandle>>(Equal(),l1,l2));
+    return _make_logical_handle(Equal(),l1,l2);
 }
 
 LogicalHandle operator^(LogicalHandle l1, LogicalHandle l2) {
-    return LogicalHandle(make_handle<LogicalExpression<XOrOp,LogicalHandle,LogicalHandle>>(XOrOp(),l1,l2));
+    return _make_logical_handle(XOrOp(),l1,l2);
 }
 
 LogicalHandle operator!(LogicalHandle l) {
-    return LogicalHandle(make_handle<LogicalExpression<NotOp,LogicalHandle>>(NotOp(),l));
+    return _make_logical_handle(NotOp(),l);
 }
 
 LogicalHandle conjunction(LogicalHandle l1, LogicalHandle l2) {
-    return LogicalHandle(make_handle<LogicalExpression<AndOp,LogicalHandle,LogicalHandle>>(AndOp(),l1,l2));
+    return _make_logical_handle(AndOp(),l1,l2);
 }
 
 LogicalHandle disjunction(LogicalHandle l1, LogicalHandle l2) {
-    return LogicalHandle(make_handle<LogicalExpression<OrOp,LogicalHandle,LogicalHandle>>(OrOp(),l1,l2));
+    return _make_logical_handle(OrOp(),l1,l2);
 }
 
 LogicalHandle negation(LogicalHandle l) {
-    return LogicalHandle(make_handle<LogicalExpression<NotOp,LogicalHandle>>(NotOp(),l));
+    return _make_logical_handle(NotOp(),l);
 }
 
 LogicalHandle equality(LogicalHandle l1, LogicalHandle l2) {
-    return LogicalHandle(make_handle<LogicalExpression<Equal,LogicalHandle,LogicalHandle>>(Equal(),l1,l2));
+    return _make_logical_handle(Equal(),l1,l2);
 }
 
 
 LogicalHandle exclusive(LogicalHandle l1, LogicalHandle l2) {
-    return LogicalHandle(make_handle<LogicalExpression<XOrOp,LogicalHandle,LogicalHandle>>(XOrOp(),l1,l2));
+    return _make_logical_handle(XOrOp(),l1,l2);
 }
 
 
@@ -166,34 +277,78 @@ ostream& operator<<(ostream& os, LogicalValue l) {
     return os;
 }
 
-template<> struct LogicalExpression<OrOp,Sequence<LowerKleenean>> : public LogicalInterface {
-    Sequence<LowerKleenean> _seq;
+//! \brief Steps a disjunction (or conjunction) of a sequence, where at effort \a e the first \a e terms are checked with effort \a e.
+//! \details Each term is taken from the sequence once and refined from its previous effort.
+//! Terms which can never decide the result are dropped, and stepping stops once the value is determinate.
+template<class L, LogicalValue DECISIVE> class LogicalSequenceStepper : public LogicalStepperInterface {
+    Sequence<L> _seq;
+    std::vector<LogicalStepper> _terms;
+    unsigned int _levels;
+    LogicalValue _value;
+    static bool _is(LogicalValue v, LogicalValue w) { return static_cast<int>(v)==static_cast<int>(w); }
   public:
-    LogicalExpression(OrOp, Sequence<LowerKleenean> seq) : _seq(seq) { }
-    LogicalInterface* clone() const { return new LogicalExpression<OrOp,Sequence<LowerKleenean>>(*this); }
-    LogicalValue _check(Effort eff) const {
-        for(unsigned int k=0u; k!=eff.work(); ++k) {
-            if ( definitely(_seq[k].check(eff)) ) { return LogicalValue::TRUE; }
+    LogicalSequenceStepper(Sequence<L> const& seq) : _seq(seq), _terms(), _levels(0u), _value(LogicalValue::INDETERMINATE) { }
+    //! \brief The number of effort levels computed so far.
+    unsigned int levels() const { return _levels; }
+    LogicalValue value() const { return _value; }
+    LogicalValue _step() {
+        unsigned int eff=_levels++;
+        if (eff==0u or is_determinate(_value)) { return _value; }
+        _terms.emplace_back(_seq[eff-1u].repr());
+        _terms.back().step_to(Effort(eff-1u));
+        size_t n=0u;
+        for (size_t i=0u; i!=_terms.size(); ++i) {
+            LogicalValue v=_terms[i].step();
+            if (_is(v,DECISIVE)) { _value=DECISIVE; _terms.clear(); return _value; }
+            if (not _is(v,!DECISIVE)) { if (n!=i) { _terms[n]=std::move(_terms[i]); } ++n; }
         }
-        return LogicalValue::INDETERMINATE;
+        _terms.erase(_terms.begin()+static_cast<std::ptrdiff_t>(n),_terms.end());
+        return _value;
     }
-    ostream& _write(ostream& os) const {
-        return os << "disjunction(" << _seq[0u] << "," << _seq[1u] << "," << _seq[2u] << ",...)";
+    LogicalValue _step_to(Effort eff) {
+        while (_levels<=eff.work()) { this->_step(); }
+        return _value;
     }
 };
 
-
-template<> struct LogicalExpression<AndOp,Sequence<UpperKleenean>> : public LogicalInterface {
-    Sequence<UpperKleenean> _seq;
+//! \brief A lazy disjunction or conjunction of a sequence, resuming from the work done at the highest effort checked so far.
+template<class OP, class L, LogicalValue DECISIVE> class LogicalSequenceExpression : public LogicalInterface {
+    typedef LogicalSequenceStepper<L,DECISIVE> StepperType;
+    LogicalMemo _memo;
+    mutable std::mutex _mutex;
+    mutable std::unique_ptr<StepperType> _resume;
+  protected:
+    Sequence<L> _seq;
   public:
-    LogicalExpression(AndOp, Sequence<UpperKleenean> seq) : _seq(seq) { }
-    LogicalInterface* clone() const { return new LogicalExpression<AndOp,Sequence<UpperKleenean>>(*this); }
-    LogicalValue _check(Effort eff) const {
-        for(unsigned int k=0u; k!=eff.work(); ++k) {
-            if ( definitely(not _seq[k].check(eff)) ) { return LogicalValue::FALSE; }
+    LogicalSequenceExpression(Sequence<L> seq) : _memo(), _mutex(), _resume(), _seq(CachedSequence<L>(seq)) { }
+    LogicalSequenceExpression(LogicalSequenceExpression const& other) : LogicalInterface(), _memo(), _mutex(), _resume(), _seq(other._seq) { }
+    LogicalValue _check(Effort eff) const { return _memo(eff,[this](Effort e){return this->_compute(e);}); }
+    LogicalStepperInterface* _new_stepper() const { return new StepperType(_seq); }
+  private:
+    LogicalValue _compute(Effort eff) const {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (!_resume or _resume->levels()>eff.work()+1u) {
+            _resume.reset(new StepperType(_seq));
         }
-        return LogicalValue::INDETERMINATE;
+        return _resume->_step_to(eff);
     }
+};
+
+template<> struct LogicalExpression<OrOp,Sequence<LowerKleenean>>
+    : public LogicalSequenceExpression<OrOp,LowerKleenean,LogicalValue::TRUE>
+{
+    LogicalExpression(OrOp, Sequence<LowerKleenean> seq) : LogicalSequenceExpression(seq) { }
+    LogicalInterface* clone() const { return new LogicalExpression<OrOp,Sequence<LowerKleenean>>(*this); }
+    ostream& _write(ostream& os) const {
+        return os << "disjunction(" << _seq[0u] << "," << _seq[1u] << "," << _seq[2u] << ",...)";
+    }
+};
+
+template<> struct LogicalExpression<AndOp,Sequence<UpperKleenean>>
+    : public LogicalSequenceExpression<AndOp,UpperKleenean,LogicalValue::FALSE>
+{
+    LogicalExpression(AndOp, Sequence<UpperKleenean> seq) : LogicalSequenceExpression(seq) { }
+    LogicalInterface* clone() const { return new LogicalExpression<AndOp,Sequence<UpperKleenean>>(*this); }
     ostream& _write(ostream& os) const {
         return os << "conjunction(" << _seq[0u] << "," << _seq[1u] << "," << _seq[2u] << ",...)";
     }
@@ -210,18 +365,23 @@ UpperKleenean conjunction(Sequence<UpperKleenean> const& l) {
 }
 
 unsigned int Effort::_default = 0u;
+std::atomic<bool> Detail::LogicalHandle::_memoisation(true);
 
 const Indeterminate indeterminate = Indeterminate();
 
 bool NondeterministicBoolean::_choose(LowerKleenean p1, LowerKleenean p2) {
-    Effort eff(0u);
+    LogicalStepper s1(p1.repr()), s2(p2.repr());
     while(true) {
-        if(definitely(p1.check(eff))) { return true; }
-        if(definitely(p2.check(eff))) { return false; }
-        ++eff;
+        if(Detail::definitely(s1.value())) { return true; }
+        if(Detail::definitely(s2.value())) { return false; }
+        s1.step(); s2.step();
     }
 }
 
+bool NondeterministicBoolean::_choose(LowerKleenean p1, LowerKleenean p2, unsigned int concurrency) {
+    return nondeterministic_choose_index(Array<LowerKleenean>({p1,p2}),concurrency)==0u;
+}
+
 template<> String class_name<ExactTag>() { return "Exact"; }
 template<> String class_name<EffectiveTag>() { return "Effective"; }
 template<> String class_name<ValidatedTag>() { return "Validated"; }
@@ -250,13 +410,77 @@ template<> String class_name<ApproximateKleenean>() { return "ApproximateKleenea
 namespace SymboliCore {
 
 size_t nondeterministic_choose_index(Array<LowerKleenean> const& p) {
-    Effort eff(0u);
+    std::vector<LogicalStepper> steppers;
+    steppers.reserve(p.size());
+    for (size_t i=0; i!=p.size(); ++i) { steppers.emplace_back(p[i].repr()); }
     while(true) {
         for (size_t i=0; i!=p.size(); ++i) {
-            if(definitely(p[i].check(eff))) { return i; }
+            if(Detail::definitely(steppers[i].value())) { return i; }
         }
-        ++eff;
+        for (auto& stepper : steppers) { stepper.step(); }
+    }
+}
+
+size_t nondeterministic_choose_index(Array<LowerKleenean> const& p, unsigned int concurrency) {
+    if (concurrency==0u) { concurrency=std::max(1u,std::thread::hardware_concurrency()); }
+    size_t const num_threads=std::max(std::min(static_cast<size_t>(concurrency),p.size()),size_t(1u));
+
+    size_t const none=std::numeric_limits<size_t>::max();
+    std::atomic<size_t> result(none);
+    std::atomic<bool> cancelled(false);
+    std::mutex exception_mutex;
+    std::exception_ptr exception;
+
+    // Each thread steps the predicates with index congruent to its own modulo the number of threads,
+    // hence owns a single predicate whenever the concurrency is at least the number of predicates
+    auto race=[&](size_t id) {
+        try {
+            std::vector<size_t> indices;
+            std::vector<LogicalStepper> steppers;
+            for (size_t i=id; i<p.size(); i+=num_threads) { indices.push_back(i); steppers.emplace_back(p[i].repr()); }
+            while (not steppers.empty()) {
+                size_t n=0u;
+                for (size_t j=0u; j!=steppers.size(); ++j) {
+                    if (Detail::definitely(steppers[j].value())) {
+                        size_t expected=none;
+                        result.compare_exchange_strong(expected,indices[j]);
+                        cancelled.store(true);
+                        return;
+                    }
+                    if (Detail::possibly(steppers[j].value())) {
+                        if (n!=j) { indices[n]=indices[j]; steppers[n]=std::move(steppers[j]); }
+                        ++n;
+                    }
+                }
+                indices.resize(n);
+                steppers.erase(steppers.begin()+static_cast<std::ptrdiff_t>(n),steppers.end());
+                for (auto& stepper : steppers) {
+                    if (cancelled.load(std::memory_order_relaxed)) { return; }
+                    stepper.step();
+                }
+            }
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(exception_mutex);
+            if (!exception) { exception=std::current_exception(); }
+            cancelled.store(true);
+        }
+    };
+
+    // A single racer runs on the calling thread, stepping the predicates in the order of the serial version
+    if (num_threads==1u) {
+        race(0u);
+    } else {
+        std::vector<std::thread> threads;
+        threads.reserve(num_threads);
+        for (size_t i=0; i!=num_threads; ++i) { threads.emplace_back(race,i); }
+        for (auto& thread : threads) { thread.join(); }
+    }
+
+    if (exception) { std::rethrow_exception(exception); }
+    if (result.load()==none) {
+        HELPER_THROW(std::runtime_error,"nondeterministic_choose_index(Array<LowerKleenean>,unsigned int)","No predicate can be verified, since all are definitely false.");
     }
+    return result.load();
 }
 
 } // namespace SymboliCore
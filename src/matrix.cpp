@@ -0,0 +1,244 @@
+/***************************************************************************
+ *            matrix.cpp
+ *
+ *  Copyright  2023  Luca Geretti
+ *
+ ****************************************************************************/
+
+/*
+ * This file is part of SymboliCore, under the MIT license.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <cmath>
+#include <algorithm>
+#include <vector>
+
+#include "matrix.hpp"
+#include "expression.hpp"
+#include "space.hpp"
+#include "valuation.hpp"
+
+namespace SymboliCore {
+
+namespace {
+
+// Number of independent partial sums in the row dot products; sequential accumulation would prevent vectorisation
+constexpr size_t LANES = 8;
+// Block sizes (in elements) chosen so that the reused panel of the right operand stays in the L2 cache,
+// and the current row segment of the result in the L1 cache
+constexpr size_t KC = 128;
+constexpr size_t NC = 256;
+constexpr size_t MC = 64;
+// Number of columns of the matrix-vector product handled at once, keeping the corresponding part of the vector in the L1 cache
+constexpr size_t VC = 2048;
+
+inline double dot(Real const* a, Real const* b, size_t n) {
+    double acc[LANES] = { };
+    size_t k=0;
+    for (; k+LANES<=n; k+=LANES) {
+        for (size_t l=0; l!=LANES; ++l) { acc[l]+=a[k+l].value()*b[k+l].value(); }
+    }
+    for (; k!=n; ++k) { acc[0]+=a[k].value()*b[k].value(); }
+    double r=acc[0];
+    for (size_t l=1; l!=LANES; ++l) { r+=acc[l]; }
+    return r;
+}
+
+// y[0:n] += s*x[0:n]
+inline void axpy(double s, Real const* x, double* y, size_t n) {
+    for (size_t j=0; j!=n; ++j) { y[j]+=s*x[j].value(); }
+}
+
+// In-place LU decomposition with partial pivoting of the n x n row-major matrix a, recording the row permutation in p
+// and its parity in odd; returns the first column with no nonzero pivot, left on the diagonal, or n if there is none
+size_t lu_factorise(Real* a, size_t n, Array<size_t>& p, bool& odd) {
+    for (size_t k=0; k!=n; ++k) {
+        size_t q=k;
+        double pmax=std::abs(a[k*n+k].value());
+        for (size_t i=k+1; i!=n; ++i) {
+            double ai=std::abs(a[i*n+k].value());
+            if (ai>pmax) { pmax=ai; q=i; }
+        }
+        if (pmax==0.0 || std::isnan(pmax)) { return k; }
+        if (q!=k) {
+            std::swap_ranges(a+k*n,a+k*n+n,a+q*n);
+            std::swap(p[k],p[q]);
+            odd=!odd;
+        }
+        double akk=a[k*n+k].value();
+        for (size_t i=k+1; i!=n; ++i) {
+            double lik=a[i*n+k].value()/akk;
+            a[i*n+k]=Real(lik);
+            Real* ai=a+i*n;
+            Real const* ak=a+k*n;
+            for (size_t j=k+1; j!=n; ++j) { ai[j]=Real(ai[j].value()-lik*ak[j].value()); }
+        }
+    }
+    return n;
+}
+
+} // namespace
+
+Real operator*(Covector<Real> const& u, Vector<Real> const& v) {
+    HELPER_PRECONDITION(u.size()==v.size());
+    return dot(u.transpose(),v);
+}
+
+Vector<Real> operator*(Matrix<Real> const& A, Vector<Real> const& v) {
+    HELPER_PRECONDITION(A.column_size()==v.size());
+    size_t m=A.row_size(), n=A.column_size();
+    Real const* a=A.elements().data();
+    Real const* x=v.data();
+    std::vector<double> y(m,0.0);
+    for (size_t kk=0; kk<n; kk+=VC) {
+        size_t kn=std::min(VC,n-kk);
+        for (size_t i=0; i!=m; ++i) { y[i]+=dot(a+i*n+kk,x+kk,kn); }
+    }
+    return Vector<Real>(m,[&y](size_t i){return Real(y[i]);});
+}
+
+Covector<Real> operator*(Covector<Real> const& u, Matrix<Real> const& A) {
+    HELPER_PRECONDITION(u.size()==A.row_size());
+    size_t m=A.row_size(), n=A.column_size();
+    Real const* a=A.elements().data();
+    std::vector<double> r(n,0.0);
+    for (size_t jj=0; jj<n; jj+=NC) {
+        size_t jn=std::min(NC,n-jj);
+        for (size_t i=0; i!=m; ++i) { axpy(u[i].value(),a+i*n+jj,r.data()+jj,jn); }
+    }
+    return Covector<Real>(n,[&r](size_t j){return Real(r[j]);});
+}
+
+Matrix<Real> operator*(Matrix<Real> const& A1, Matrix<Real> const& A2) {
+    HELPER_PRECONDITION(A1.column_size()==A2.row_size());
+    size_t m=A1.row_size(), l=A1.column_size(), n=A2.column_size();
+    Real const* a=A1.elements().data();
+    Real const* b=A2.elements().data();
+    std::vector<double> c(m*n,0.0);
+    for (size_t jj=0; jj<n; jj+=NC) {
+        size_t jn=std::min(NC,n-jj);
+        for (size_t kk=0; kk<l; kk+=KC) {
+            size_t kn=std::min(KC,l-kk);
+            for (size_t ii=0; ii<m; ii+=MC) {
+                size_t in=std::min(MC,m-ii);
+                for (size_t i=ii; i!=ii+in; ++i) {
+                    double* ci=c.data()+i*n+jj;
+                    for (size_t k=kk; k!=kk+kn; ++k) { axpy(a[i*l+k].value(),b+k*n+jj,ci,jn); }
+                }
+            }
+        }
+    }
+    return Matrix<Real>(m,n,Vector<Real>(m*n,[&c](size_t k){return Real(c[k]);}));
+}
+
+LUDecomposition::LUDecomposition(Matrix<Real> const& A)
+    : _lu(), _p(A.row_size(),[](size_t i){return i;}), _odd(false)
+{
+    HELPER_PRECONDITION_MSG(A.row_size()==A.column_size(),"Only a square matrix has an LU decomposition, but A is "<<A.row_size()<<"x"<<A.column_size()<<".");
+    size_t n=A.row_size();
+    Vector<Real> lu=A.elements();
+    size_t k=lu_factorise(lu.data(),n,_p,_odd);
+    if (k!=n)
+        HELPER_THROW(std::runtime_error,"LUDecomposition(Matrix<Real>)","The matrix is singular, with no nonzero pivot in column "<<k<<".");
+    _lu=Matrix<Real>(n,n,std::move(lu));
+}
+
+Matrix<Real> LUDecomposition::solve(Matrix<Real> const& B) const {
+    size_t n=size(), r=B.column_size();
+    HELPER_PRECONDITION_MSG(B.row_size()==n,"The right-hand side has "<<B.row_size()<<" rows, but the system has size "<<n<<".");
+    Real const* a=_lu.elements().data();
+    Real const* b=B.elements().data();
+    std::vector<double> x(n*r);
+    for (size_t i=0; i!=n; ++i) {
+        for (size_t j=0; j!=r; ++j) { x[i*r+j]=b[_p[i]*r+j].value(); }
+    }
+    // Forward substitution with the unit lower factor, operating on whole rows of the right-hand sides
+    for (size_t i=1; i<n; ++i) {
+        double* xi=x.data()+i*r;
+        for (size_t k=0; k!=i; ++k) {
+            double lik=a[i*n+k].value();
+            double const* xk=x.data()+k*r;
+            for (size_t j=0; j!=r; ++j) { xi[j]-=lik*xk[j]; }
+        }
+    }
+    // Back substitution with the upper factor
+    for (size_t i=n; i--!=0; ) {
+        double* xi=x.data()+i*r;
+        for (size_t k=i+1; k!=n; ++k) {
+            double uik=a[i*n+k].value();
+            double const* xk=x.data()+k*r;
+            for (size_t j=0; j!=r; ++j) { xi[j]-=uik*xk[j]; }
+        }
+        double uii=a[i*n+i].value();
+        for (size_t j=0; j!=r; ++j) { xi[j]/=uii; }
+    }
+    return Matrix<Real>(n,r,Vector<Real>(n*r,[&x](size_t k){return Real(x[k]);}));
+}
+
+Vector<Real> LUDecomposition::solve(Vector<Real> const& b) const {
+    HELPER_PRECONDITION_MSG(b.size()==size(),"The right-hand side has size "<<b.size()<<", but the system has size "<<size()<<".");
+    return solve(Matrix<Real>(b.size(),1u,b)).elements();
+}
+
+Real LUDecomposition::determinant() const {
+    double r = _odd ? -1.0 : 1.0;
+    for (size_t i=0; i!=size(); ++i) { r*=_lu.get(i,i).value(); }
+    return Real(r);
+}
+
+Matrix<Real> LUDecomposition::inverse() const {
+    return solve(Matrix<Real>::identity(size()));
+}
+
+Vector<Real> solve(Matrix<Real> const& A, Vector<Real> const& b) {
+    return LUDecomposition(A).solve(b);
+}
+
+Matrix<Real> solve(Matrix<Real> const& A, Matrix<Real> const& B) {
+    return LUDecomposition(A).solve(B);
+}
+
+Matrix<Real> inverse(Matrix<Real> const& A) {
+    return LUDecomposition(A).inverse();
+}
+
+Real determinant(Matrix<Real> const& A) {
+    HELPER_PRECONDITION(A.row_size()==A.column_size());
+    size_t n=A.row_size();
+    Vector<Real> lu=A.elements();
+    Array<size_t> p(n,[](size_t i){return i;});
+    bool odd=false;
+    size_t k=lu_factorise(lu.data(),n,p,odd);
+    // A column with no nonzero pivot makes the matrix singular, unless the pivot is NaN, which propagates
+    if (k!=n) { return std::isnan(lu[k*n+k].value()) ? lu[k*n+k] : Real(0.0); }
+    double r = odd ? -1.0 : 1.0;
+    for (size_t i=0; i!=n; ++i) { r*=lu[i*n+i].value(); }
+    return Real(r);
+}
+
+Matrix<Expression<Real>> jacobian(Vector<Expression<Real>> const& f, Space<Real> const& spc) {
+    return Matrix<Expression<Real>>(f.size(),spc.dimension(),[&f,&spc](size_t i, size_t j){return derivative(f[i],spc.variable(j));});
+}
+
+Matrix<Real> evaluate(Matrix<Expression<Real>> const& A, Valuation<Real> const& x) {
+    return Matrix<Real>(A.row_size(),A.column_size(),[&A,&x](size_t i, size_t j){return evaluate(A.get(i,j),x);});
+}
+
+} // namespace SymboliCore
@@ -0,0 +1,220 @@
+/***************************************************************************
+ *            paver.cpp
+ *
+ *  Copyright  2023  Luca Geretti
+ *
+ ****************************************************************************/
+
+/*
+ * This file is part of SymboliCore, under the MIT license.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*! \file paver.cpp
+ *  \brief Paving of sets defined by constraints.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "helper/macros.hpp"
+#include "paver.hpp"
+
+namespace SymboliCore {
+
+namespace {
+
+struct Task { RealVariablesBox box; unsigned int depth; };
+
+//! \brief The pending tasks of one thread, which takes from the back while other threads steal from the front.
+class TaskQueue {
+  public:
+    void push(Task&& task) { std::lock_guard<std::mutex> lock(_mutex); _tasks.push_back(std::move(task)); }
+    bool pop(Task& task) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_tasks.empty()) { return false; }
+        task=std::move(_tasks.back()); _tasks.pop_back(); return true; }
+    bool steal(Task& task) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_tasks.empty()) { return false; }
+        task=std::move(_tasks.front()); _tasks.pop_front(); return true; }
+  private:
+    std::mutex _mutex;
+    std::deque<Task> _tasks;
+};
+
+Expression<Kleenean> conjunction(List<Expression<Kleenean>> const& ps) {
+    HELPER_PRECONDITION(!ps.empty());
+    Expression<Kleenean> r=ps[0];
+    for (size_t i=1; i!=ps.size(); ++i) { r = r && ps[i]; }
+    return r;
+}
+
+List<Identifier> argument_list(Expression<Kleenean> const& p) {
+    List<Identifier> r;
+    for (auto const& id : arguments(p)) { r.push_back(id); }
+    return r;
+}
+
+} // namespace
+
+ostream& operator<<(ostream& os, PavingClass const& cls) {
+    switch(cls) {
+        case PavingClass::INSIDE: os << "INSIDE"; break;
+        case PavingClass::OUTSIDE: os << "OUTSIDE"; break;
+        case PavingClass::UNDECIDED: os << "UNDECIDED"; break;
+        default: HELPER_FAIL_MSG("Unhandled PavingClass for output streaming.");
+    }
+    return os;
+}
+
+PaverSettings PaverSettings::default_settings() {
+    return PaverSettings({1e-3,32u,0u,true});
+}
+
+Paver::Paver(Expression<Kleenean> const& p, PaverSettings const& settings)
+    : _predicate(p), _variables(argument_list(p)), _contractor(p), _settings(settings)
+{ }
+
+Paver::Paver(List<Expression<Kleenean>> const& ps, PaverSettings const& settings)
+    : _predicate(conjunction(ps)), _variables(argument_list(_predicate)), _contractor(ps), _settings(settings)
+{ }
+
+void Paver::pave(RealVariablesBox const& bx, ConsumerType const& consumer) const {
+    size_t concurrency = _settings.concurrency>0 ? _settings.concurrency : std::max(1u,std::thread::hardware_concurrency());
+
+    std::vector<TaskQueue> queues(concurrency);
+    std::atomic<size_t> pending(1u);
+    std::atomic<bool> failed(false);
+    std::exception_ptr failure;
+    std::mutex output_mutex;
+
+    // Idle workers sleep until a task is pushed, the paving completes or a failure occurs,
+    // each of which advances the generation under the mutex so that no wakeup is lost
+    std::mutex idle_mutex;
+    std::condition_variable idle;
+    std::atomic<size_t> generation(0u);
+    auto wake=[&]() {
+        { std::lock_guard<std::mutex> lock(idle_mutex); ++generation; }
+        idle.notify_all();
+    };
+
+    auto emit=[&](RealVariablesBox const& b, PavingClass cls) {
+        std::lock_guard<std::mutex> lock(output_mutex);
+        consumer(b,cls);
+    };
+
+    auto refine=[&](Task const& task, TaskQueue& queue) {
+        RealVariablesBox b=task.box;
+        if (_settings.contract) {
+            RealVariablesBox cb=_contractor.contract(b);
+            if (cb.is_empty()) { emit(b,PavingClass::OUTSIDE); return; }
+            // The parts removed by the contraction are cut off as slabs, one variable at a time
+            for (auto const& id : _contractor.variables()) {
+                RealVariable v(id);
+                RealInterval ivl=b[v], civl=cb[v];
+                if (ivl.lower_bound().value()<civl.lower_bound().value()) {
+                    RealVariablesBox slab=b; slab[v]=RealInterval(ivl.lower_bound(),civl.lower_bound()); emit(slab,PavingClass::OUTSIDE); }
+                if (civl.upper_bound().value()<ivl.upper_bound().value()) {
+                    RealVariablesBox slab=b; slab[v]=RealInterval(civl.upper_bound(),ivl.upper_bound()); emit(slab,PavingClass::OUTSIDE); }
+                b[v]=civl;
+            }
+        }
+
+        ValidatedKleenean satisfied=evaluate(_predicate,b);
+        if (definitely(satisfied)) { emit(b,PavingClass::INSIDE); return; }
+        if (definitely(!satisfied)) { emit(b,PavingClass::OUTSIDE); return; }
+
+        Identifier const* widest=nullptr; double widest_width=0.0;
+        for (auto const& id : _variables) {
+            double w=width(b[id]).value();
+            if (w>widest_width) { widest=&id; widest_width=w; }
+        }
+        if (widest==nullptr || !(widest_width>_settings.minimum_width) || task.depth>=_settings.maximum_depth) {
+            emit(b,PavingClass::UNDECIDED); return;
+        }
+
+        RealVariable v(*widest);
+        RealInterval ivl=b[v]; Real m=midpoint(ivl);
+        RealVariablesBox b1=b, b2=b;
+        b1[v]=RealInterval(ivl.lower_bound(),m); b2[v]=RealInterval(m,ivl.upper_bound());
+        pending+=2;
+        // The lower half is pushed last, so that it is refined next
+        queue.push(Task({std::move(b2),task.depth+1}));
+        queue.push(Task({std::move(b1),task.depth+1}));
+        wake();
+    };
+
+    auto work=[&](size_t id) {
+        Task task;
+        while (!failed) {
+            size_t const observed=generation.load();
+            bool found=queues[id].pop(task);
+            for (size_t k=1; !found && k!=concurrency; ++k) { found=queues[(id+k)%concurrency].steal(task); }
+            if (found) {
+                try { refine(task,queues[id]); }
+                catch (...) {
+                    {
+                        std::lock_guard<std::mutex> lock(output_mutex);
+                        if (!failure) { failure=std::current_exception(); }
+                    }
+                    failed=true;
+                    wake();
+                }
+                if (--pending==0) { wake(); }
+            } else if (pending==0) {
+                break;
+            } else {
+                std::unique_lock<std::mutex> lock(idle_mutex);
+                idle.wait(lock,[&]{ return generation.load()!=observed || pending==0 || failed; });
+            }
+        }
+    };
+
+    queues[0].push(Task({bx,0u}));
+    if (concurrency==1) {
+        work(0);
+    } else {
+        std::vector<std::thread> threads;
+        for (size_t i=0; i!=concurrency; ++i) { threads.emplace_back(work,i); }
+        for (auto& thread : threads) { thread.join(); }
+    }
+    if (failure) { std::rethrow_exception(failure); }
+}
+
+Paving Paver::pave(RealVariablesBox const& bx) const {
+    Paving result;
+    this->pave(bx,[&result](RealVariablesBox const& b, PavingClass cls) {
+        switch(cls) {
+            case PavingClass::INSIDE: result.inside.push_back(b); break;
+            case PavingClass::OUTSIDE: result.outside.push_back(b); break;
+            case PavingClass::UNDECIDED: result.undecided.push_back(b); break;
+            default: HELPER_FAIL_MSG("Unhandled PavingClass "<<cls);
+        }
+    });
+    return result;
+}
+
+} // namespace SymboliCore
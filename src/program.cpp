@@ -0,0 +1,406 @@
+/***************************************************************************
+ *            program.cpp
+ *
+ *  Copyright  2023  Luca Geretti
+ *
+ ****************************************************************************/
+
+/*
+ * This file is part of SymboliCore, under the MIT license.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+/*! \file program.cpp
+ *  \brief Straight-line register programs computing blocks of assignments.
+ */
+
+#include <cmath>
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <exception>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <tuple>
+#include <unordered_map>
+
+#include "helper/macros.hpp"
+#include "helper/container.hpp"
+#include "program.hpp"
+
+namespace SymboliCore {
+
+namespace {
+
+typedef RegisterProgram::Instruction Instruction;
+
+// The order of the arguments of max and min matters for signed zeros and NaN
+bool is_commutative(OperatorCode code) {
+    return code==OperatorCode::ADD || code==OperatorCode::MUL;
+}
+
+//! \brief Translates expressions into instructions on virtual registers, numbering each distinct value once.
+//! \details Registers below the number of arguments hold the arguments; the others are either constants or temporaries.
+class ProgramBuilder {
+    RealSpace const& _spc;
+    std::unordered_map<Identifier,unsigned int,std::hash<std::string>> _bindings;
+    std::unordered_map<void const*,unsigned int> _by_pointer;
+    std::map<std::tuple<OperatorCode,unsigned int,unsigned int,int>,unsigned int> _by_structure;
+    std::unordered_map<std::uint64_t,unsigned int> _by_constant;
+  public:
+    std::vector<Instruction> instructions;
+    std::vector<double> constants;
+    std::vector<bool> is_constant;
+
+    ProgramBuilder(RealSpace const& spc) : _spc(spc), is_constant(spc.dimension(),false) {
+        for (size_t i=0; i!=spc.dimension(); ++i) { _bindings.emplace(spc.variable(i).name(),static_cast<unsigned int>(i)); }
+    }
+
+    void assign(RealAssignment const& a) {
+        unsigned int r=operand(a.rhs);
+        if (not _bindings.emplace(a.lhs.name(),r).second) {
+            HELPER_THROW(std::runtime_error,"RegisterProgram(List<RealAssignment>,RealSpace)",
+                         "Variable "<<a.lhs<<" is assigned more than once, or is in the argument space "<<_spc);
+        }
+    }
+
+    unsigned int lookup(Identifier const& name) const {
+        auto iter=_bindings.find(name);
+        if (iter==_bindings.end()) {
+            HELPER_THROW(std::runtime_error,"RegisterProgram(List<RealAssignment>,RealSpace)",
+                         "Variable "<<name<<" is used before it is assigned, and is not in the argument space "<<_spc);
+        }
+        return iter->second;
+    }
+
+    unsigned int operand(Expression<Real> const& e) {
+        auto piter=_by_pointer.find(e.node_raw_ptr());
+        if (piter!=_by_pointer.end()) { return piter->second; }
+
+        unsigned int r;
+        switch(e.kind()) {
+            case OperatorKind::NULLARY: r=_constant(e.val().value()); break;
+            case OperatorKind::VARIABLE: r=lookup(e.var()); break;
+            case OperatorKind::UNARY: r=_emit(e.code(),operand(e.arg()),0u,0); break;
+            case OperatorKind::BINARY: { unsigned int a1=operand(e.arg1()); r=_emit(e.code(),a1,operand(e.arg2()),0); break; }
+            case OperatorKind::GRADED: r=_emit(OperatorCode::POW,operand(e.arg()),0u,e.num()); break;
+            default: HELPER_FAIL_MSG("Cannot compile expression "<<e);
+        }
+        _by_pointer.emplace(e.node_raw_ptr(),r);
+        return r;
+    }
+  private:
+    unsigned int _new_register(bool constant) {
+        is_constant.push_back(constant);
+        return static_cast<unsigned int>(is_constant.size()-1u);
+    }
+
+    unsigned int _constant(double v) {
+        auto iter=_by_constant.find(std::bit_cast<std::uint64_t>(v));
+        if (iter!=_by_constant.end()) { return iter->second; }
+        unsigned int r=_new_register(true);
+        constants.push_back(v);
+        _by_constant.emplace(std::bit_cast<std::uint64_t>(v),r);
+        return r;
+    }
+
+    unsigned int _emit(OperatorCode code, unsigned int a1, unsigned int a2, int n) {
+        if (is_commutative(code) && a2<a1) { std::swap(a1,a2); }
+        auto key=std::make_tuple(code,a1,a2,n);
+        auto iter=_by_structure.find(key);
+        if (iter!=_by_structure.end()) { return iter->second; }
+        unsigned int r=_new_register(false);
+        instructions.push_back(Instruction{code,r,a1,a2,n});
+        _by_structure.emplace(key,r);
+        return r;
+    }
+};
+
+bool is_unary(OperatorCode code) {
+    switch(code) {
+        case OperatorCode::ADD: case OperatorCode::SUB: case OperatorCode::MUL: case OperatorCode::DIV:
+        case OperatorCode::MAX: case OperatorCode::MIN: return false;
+        default: return true;
+    }
+}
+
+//! \brief Execute the instructions on registers holding \a B lanes each, stored consecutively.
+//! \details The operations are those used to evaluate Real, so that the results are identical.
+template<size_t B> void execute(std::vector<Instruction> const& instructions, double* w) {
+    for (auto const& ins : instructions) {
+        double* r=w+static_cast<size_t>(ins.result)*B;
+        const double* x1=w+static_cast<size_t>(ins.arg1)*B;
+        const double* x2=w+static_cast<size_t>(ins.arg2)*B;
+        switch(ins.code) {
+            case OperatorCode::NUL: for (size_t l=0; l!=B; ++l) { r[l]=0.0; } break;
+            case OperatorCode::POS: for (size_t l=0; l!=B; ++l) { r[l]=x1[l]; } break;
+            case OperatorCode::NEG: for (size_t l=0; l!=B; ++l) { r[l]=-x1[l]; } break;
+            case OperatorCode::HLF: for (size_t l=0; l!=B; ++l) { r[l]=x1[l]/2; } break;
+            case OperatorCode::REC: for (size_t l=0; l!=B; ++l) { r[l]=1.0/x1[l]; } break;
+            case OperatorCode::SQR: for (size_t l=0; l!=B; ++l) { r[l]=x1[l]*x1[l]; } break;
+            case OperatorCode::SQRT: for (size_t l=0; l!=B; ++l) { r[l]=std::sqrt(x1[l]); } break;
+            case OperatorCode::EXP: for (size_t l=0; l!=B; ++l) { r[l]=std::exp(x1[l]); } break;
+            case OperatorCode::LOG: for (size_t l=0; l!=B; ++l) { r[l]=std::log(x1[l]); } break;
+            case OperatorCode::SIN: for (size_t l=0; l!=B; ++l) { r[l]=std::sin(x1[l]); } break;
+            case OperatorCode::COS: for (size_t l=0; l!=B; ++l) { r[l]=std::cos(x1[l]); } break;
+            case OperatorCode::TAN: for (size_t l=0; l!=B; ++l) { r[l]=std::tan(x1[l]); } break;
+            case OperatorCode::ASIN: for (size_t l=0; l!=B; ++l) { r[l]=std::asin(x1[l]); } break;
+            case OperatorCode::ACOS: for (size_t l=0; l!=B; ++l) { r[l]=std::acos(x1[l]); } break;
+            case OperatorCode::ATAN: for (size_t l=0; l!=B; ++l) { r[l]=std::atan(x1[l]); } break;
+            case OperatorCode::ABS: for (size_t l=0; l!=B; ++l) { r[l]=std::abs(x1[l]); } break;
+            case OperatorCode::ADD: for (size_t l=0; l!=B; ++l) { r[l]=x1[l]+x2[l]; } break;
+            case OperatorCode::SUB: for (size_t l=0; l!=B; ++l) { r[l]=x1[l]-x2[l]; } break;
+            case OperatorCode::MUL: for (size_t l=0; l!=B; ++l) { r[l]=x1[l]*x2[l]; } break;
+            case OperatorCode::DIV: for (size_t l=0; l!=B; ++l) { r[l]=x1[l]/x2[l]; } break;
+            case OperatorCode::MAX: for (size_t l=0; l!=B; ++l) { r[l]=std::max(x1[l],x2[l]); } break;
+            case OperatorCode::MIN: for (size_t l=0; l!=B; ++l) { r[l]=std::min(x1[l],x2[l]); } break;
+            case OperatorCode::POW: {
+                // Same conversion of the exponent as pow(Real,int)
+                double n=static_cast<double>(static_cast<unsigned long int>(ins.num));
+                for (size_t l=0; l!=B; ++l) { r[l]=std::pow(x1[l],n); }
+                break;
+            }
+            default: HELPER_FAIL_MSG("Unhandled operator "<<ins.code);
+        }
+    }
+}
+
+} // namespace
+
+RegisterProgram::RegisterProgram(List<RealAssignment> const& assignments, RealSpace const& spc)
+    : RegisterProgram(assignments,spc,elementwise([](RealAssignment const& a){return a.lhs;},assignments))
+{
+}
+
+RegisterProgram::RegisterProgram(List<RealAssignment> const& assignments, RealSpace const& spc, List<RealVariable> const& outputs)
+    : _argument_space(spc), _results(elementwise([](RealVariable const& v){return RealExpression(v);},outputs)), _register_size(0u)
+{
+    this->_compile(assignments);
+}
+
+RegisterProgram::RegisterProgram(Vector<RealExpression> const& results, List<RealAssignment> const& assignments, RealSpace const& spc)
+    : _argument_space(spc), _results(results.array().begin(),results.array().end()), _register_size(0u)
+{
+    this->_compile(assignments);
+}
+
+void RegisterProgram::_compile(List<RealAssignment> const& assignments) {
+    ProgramBuilder builder(_argument_space);
+    for (auto const& a : assignments) { builder.assign(a); }
+    std::vector<unsigned int> results;
+    results.reserve(_results.size());
+    for (auto const& e : _results) { results.push_back(builder.operand(e)); }
+
+    size_t const nv=builder.is_constant.size();
+    unsigned int const na=static_cast<unsigned int>(this->argument_size());
+
+    // Mark the registers read, directly or indirectly, by the results; each register has a single defining instruction
+    std::vector<bool> live(nv,false);
+    for (auto r : results) { live[r]=true; }
+    for (auto iter=builder.instructions.rbegin(); iter!=builder.instructions.rend(); ++iter) {
+        if (live[iter->result]) {
+            live[iter->arg1]=true;
+            if (not is_unary(iter->code)) { live[iter->arg2]=true; }
+        }
+    }
+    std::vector<Instruction> code;
+    for (auto const& ins : builder.instructions) { if (live[ins.result]) { code.push_back(ins); } }
+
+    // Place the arguments first, then the constants which are used
+    std::vector<unsigned int> physical(nv,std::numeric_limits<unsigned int>::max());
+    for (unsigned int r=0; r!=na; ++r) { physical[r]=r; }
+    unsigned int next=na;
+    for (size_t r=na, c=0; r!=nv; ++r) {
+        if (builder.is_constant[r]) {
+            if (live[r]) { physical[r]=next++; _constants.push_back(builder.constants[c]); }
+            ++c;
+        }
+    }
+
+    // Allocate the temporaries, reusing a register once the last instruction reading it has been executed
+    size_t const never=std::numeric_limits<size_t>::max();
+    std::vector<size_t> last_use(nv,0u);
+    for (size_t i=0; i!=code.size(); ++i) {
+        last_use[code[i].arg1]=i;
+        if (not is_unary(code[i].code)) { last_use[code[i].arg2]=i; }
+    }
+    for (auto r : results) { last_use[r]=never; }
+    std::vector<unsigned int> free_registers;
+    for (size_t i=0; i!=code.size(); ++i) {
+        Instruction& ins=code[i];
+        unsigned int a1=ins.arg1, a2=ins.arg2;
+        bool const unary=is_unary(ins.code);
+        ins.arg1=physical[a1];
+        ins.arg2=unary ? ins.arg1 : physical[a2];
+        if (a1>=na && not builder.is_constant[a1] && last_use[a1]==i) { free_registers.push_back(physical[a1]); }
+        if (not unary && a2!=a1 && a2>=na && not builder.is_constant[a2] && last_use[a2]==i) { free_registers.push_back(physical[a2]); }
+        unsigned int r;
+        if (free_registers.empty()) { r=next++; } else { r=free_registers.back(); free_registers.pop_back(); }
+        physical[ins.result]=r;
+        ins.result=r;
+    }
+
+    _instructions=std::move(code);
+    for (auto r : results) { _outputs.push_back(physical[r]); }
+    _register_size=next;
+}
+
+void RegisterProgram::operator()(const double* x, double* y, double* w) const {
+    size_t const n=this->argument_size();
+    std::copy(x,x+n,w);
+    std::copy(_constants.begin(),_constants.end(),w+n);
+    execute<1u>(_instructions,w);
+    for (size_t k=0; k!=_outputs.size(); ++k) { y[k]=w[_outputs[k]]; }
+}
+
+void RegisterProgram::operator()(const double* x, double* y) const {
+    std::vector<double> w(_register_size);
+    (*this)(x,y,w.data());
+}
+
+Vector<Real> RegisterProgram::operator()(Vector<Real> const& x) const {
+    HELPER_PRECONDITION(x.size()==this->argument_size());
+    std::vector<double> xa(x.size());
+    for (size_t i=0; i!=x.size(); ++i) { xa[i]=x[i].value(); }
+    std::vector<double> ya(this->result_size());
+    (*this)(xa.data(),ya.data());
+    return Vector<Real>(ya.size(),[&ya](size_t i){return Real(ya[i]);});
+}
+
+Vector<Real> evaluate(RegisterProgram const& p, Valuation<Real> const& x) {
+    RealSpace const& spc=p.argument_space();
+    return p(Vector<Real>(spc.dimension(),[&](size_t i){return x.values()[spc.variable(i).name()];}));
+}
+
+void RegisterProgram::_batch(size_t begin, size_t end, const double* x, double* y, double* w) const {
+    size_t const B=BLOCK_SIZE;
+    size_t const n=this->argument_size();
+    size_t const m=this->result_size();
+    for (size_t c=0; c!=_constants.size(); ++c) { std::fill_n(w+(n+c)*B,B,_constants[c]); }
+    for (size_t p=begin; p<end; p+=B) {
+        size_t const lanes=std::min(B,end-p);
+        for (size_t j=0; j!=n; ++j) {
+            for (size_t l=0; l!=lanes; ++l) { w[j*B+l]=x[(p+l)*n+j]; }
+            // Lanes past the last point of a partial block are computed but never stored
+            std::fill(w+j*B+lanes,w+(j+1u)*B,0.0);
+        }
+        execute<B>(_instructions,w);
+        for (size_t k=0; k!=m; ++k) {
+            const double* r=w+static_cast<size_t>(_outputs[k])*B;
+            for (size_t l=0; l!=lanes; ++l) { y[(p+l)*m+k]=r[l]; }
+        }
+    }
+}
+
+void RegisterProgram::batch(size_t count, const double* x, double* y, unsigned int concurrency) const {
+    if (concurrency==0u) { concurrency=std::max(1u,std::thread::hardware_concurrency()); }
+    size_t const blocks=(count+BLOCK_SIZE-1u)/BLOCK_SIZE;
+    size_t const num_threads=std::min(static_cast<size_t>(concurrency),blocks);
+    if (num_threads<=1u) {
+        std::vector<double> w(this->batch_workspace_size());
+        this->_batch(0u,count,x,y,w.data());
+        return;
+    }
+
+    std::mutex exception_mutex;
+    std::exception_ptr exception;
+    // Each thread evaluates a contiguous range of whole blocks
+    auto run=[&](size_t id) {
+        try {
+            size_t const begin=std::min(count,(blocks*id/num_threads)*BLOCK_SIZE);
+            size_t const end=std::min(count,(blocks*(id+1u)/num_threads)*BLOCK_SIZE);
+            std::vector<double> w(this->batch_workspace_size());
+            this->_batch(begin,end,x,y,w.data());
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(exception_mutex);
+            if (!exception) { exception=std::current_exception(); }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(num_threads);
+    for (size_t i=0; i!=num_threads; ++i) { threads.emplace_back(run,i); }
+    for (auto& thread : threads) { thread.join(); }
+    if (exception) { std::rethrow_exception(exception); }
+}
+
+namespace {
+
+// The new values of the variables of the state space, which are their old values unless reset
+Vector<RealExpression> reset_results(PrimedRealAssignments const& resets, RealSpace const& spc) {
+    Vector<RealExpression> results(spc.dimension(),[&spc](size_t i){return RealExpression(spc.variable(i));});
+    std::vector<bool> reset(spc.dimension(),false);
+    for (auto const& a : resets) {
+        RealVariable v=a.lhs.base();
+        if (not spc.contains(v)) {
+            HELPER_THROW(std::runtime_error,"ResetMap(PrimedRealAssignments,RealSpace)","Variable "<<v<<" is not in the state space "<<spc);
+        }
+        size_t i=spc.index(v);
+        if (reset[i]) {
+            HELPER_THROW(std::runtime_error,"ResetMap(PrimedRealAssignments,RealSpace)","Variable "<<v<<" is reset more than once");
+        }
+        reset[i]=true;
+        results[i]=a.rhs;
+    }
+    return results;
+}
+
+} // namespace
+
+ResetMap::ResetMap(PrimedRealAssignments const& resets, RealSpace const& spc)
+    : ResetMap(List<RealAssignment>(),resets,spc)
+{
+}
+
+ResetMap::ResetMap(List<RealAssignment> const& auxiliary, PrimedRealAssignments const& resets, RealSpace const& spc)
+    : _program(reset_results(resets,spc),auxiliary,spc)
+{
+}
+
+Valuation<Real> evaluate(ResetMap const& r, Valuation<Real> const& x) {
+    RealSpace const& spc=r.state_space();
+    Vector<Real> y=r(Vector<Real>(spc.dimension(),[&](size_t i){return x.values()[spc.variable(i).name()];}));
+    Valuation<Real> result(x);
+    for (size_t i=0; i!=spc.dimension(); ++i) { result.set(spc.variable(i),y[i]); }
+    return result;
+}
+
+void RegisterProgram::batch(size_t count, const double* x, double* y, std::span<double> w) const {
+    HELPER_PRECONDITION(w.size()>=this->batch_workspace_size());
+    this->_batch(0u,count,x,y,w.data());
+}
+
+ostream& operator<<(ostream& os, RegisterProgram const& p) {
+    os << "RegisterProgram(arguments=" << p._argument_space << ", constants=[";
+    for (size_t c=0; c!=p._constants.size(); ++c) { os << (c==0?"":",") << "r" << p.argument_size()+c << "=" << p._constants[c]; }
+    os << "], instructions=[";
+    for (size_t i=0; i!=p._instructions.size(); ++i) {
+        auto const& ins=p._instructions[i];
+        os << (i==0?"":"; ") << "r" << ins.result << "=" << ins.code << "(r" << ins.arg1;
+        if (ins.code==OperatorCode::POW) { os << "," << ins.num; }
+        else if (not is_unary(ins.code)) { os << ",r" << ins.arg2; }
+        os << ")";
+    }
+    os << "], results=[";
+    for (size_t k=0; k!=p._outputs.size(); ++k) { os << (k==0?"":",") << p._results[k] << "=r" << p._outputs[k]; }
+    return os << "])";
+}
+
+} // namespace SymboliCore
@@ -43,23 +43,12 @@ Comparison cmp(Real const& r1, Real const& r2);
 
 Real::Real() : _value(0.0) { }
 
-Real::Real(double val) : _value(val) { }
-
 Real::Real(String const& str) {
     size_t sz;
     _value = stod(str,&sz);
 }
 
-Real::Real(Integer const& i) : _value(static_cast<double>(i.value())) { }
-
-Real::Real(const Real& r) : _value(r._value) { }
-
-double const& Real::value() const { return _value; }
-
-Real& Real::operator=(const Real& r) {
-    _value = r._value;
-    return *this;
-}
+Real::Real(Integer const& i) : _value(i.get_d()) { }
 
 Real& operator+=(Real& r1, Real const& r2) {
     r1._value += r2._value;
@@ -0,0 +1,438 @@
+/***************************************************************************
+ *            real_kernels.cpp
+ *
+ *  Copyright  2023  Luca Geretti
+ *
+ ****************************************************************************/
+
+/*
+ * This file is part of SymboliCore, under the MIT license.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+#include "helper/macros.hpp"
+#include "real_kernels.hpp"
+
+namespace SymboliCore {
+
+ostream& operator<<(ostream& os, KernelAccuracy acc) {
+    switch (acc) {
+        case KernelAccuracy::FAST: return os << "FAST";
+        case KernelAccuracy::ACCURATE: return os << "ACCURATE";
+        case KernelAccuracy::LIBM: return os << "LIBM";
+        default: HELPER_FAIL_MSG("Unhandled kernel accuracy for output streaming.");
+    }
+}
+
+namespace {
+
+using std::uint64_t;
+using std::int64_t;
+
+// Values are processed in blocks copied to contiguous storage, so that the kernels run on plain doubles
+constexpr size_t BLOCK_SIZE = 256;
+
+// Adding and subtracting this value rounds a double of magnitude below 2^51 to the nearest integer,
+// whose value can also be read from the low bits of the sum
+constexpr double ROUNDING_SHIFTER = 0x1.8p52;
+
+inline uint64_t bits(double x) { return std::bit_cast<uint64_t>(x); }
+inline double from_bits(uint64_t u) { return std::bit_cast<double>(u); }
+
+inline int64_t rounded_integer(double shifted) {
+    return static_cast<int64_t>(bits(shifted)-bits(ROUNDING_SHIFTER)); }
+
+inline double power_of_two(int64_t n) { return from_bits(static_cast<uint64_t>(n+1023)<<52); }
+
+/************ Exponential ************************************************/
+
+constexpr double LN2_HI = 6.93147180369123816490e-01;
+constexpr double LN2_LO = 1.90821492927058770002e-10;
+constexpr double INV_LN2 = 1.44269504088896338700e+00;
+
+// Remez coefficients of the rational approximation of exp on [-ln2/2,ln2/2]
+constexpr double EXP_P1 = 1.66666666666666019037e-01;
+constexpr double EXP_P2 = -2.77777777770155933842e-03;
+constexpr double EXP_P3 = 6.61375632143793436117e-05;
+constexpr double EXP_P4 = -1.65339022054652515390e-06;
+constexpr double EXP_P5 = 4.13813679705723846039e-08;
+
+template<KernelAccuracy A> inline double exp_kernel(double x) {
+    // Clamping keeps the scaling exponent representable while preserving overflow and underflow; NaN passes through
+    double xc = x < -746.0 ? -746.0 : (x > 710.0 ? 710.0 : x);
+    double shifted = xc*INV_LN2 + ROUNDING_SHIFTER;
+    double k = shifted - ROUNDING_SHIFTER;
+    double hi = xc - k*LN2_HI;
+    double lo = k*LN2_LO;
+    double r = hi - lo;
+    double y;
+    if constexpr (A == KernelAccuracy::ACCURATE) {
+        double t = r*r;
+        double c = r - t*(EXP_P1+t*(EXP_P2+t*(EXP_P3+t*(EXP_P4+t*EXP_P5))));
+        y = 1.0 - ((lo - (r*c)/(2.0-c)) - hi);
+    } else {
+        y = 1.0+r*(1.0+r*(1.0/2+r*(1.0/6+r*(1.0/24+r*(1.0/120+r*(1.0/720+r*(1.0/5040+r*(1.0/40320
+            +r*(1.0/362880+r*(1.0/3628800+r*(1.0/39916800+r*(1.0/479001600))))))))))));
+    }
+    // Scaling in two steps gives correct overflow to infinity and gradual underflow to subnormals
+    int64_t n = rounded_integer(shifted);
+    int64_t n1 = n/2;
+    return y*power_of_two(n1)*power_of_two(n-n1);
+}
+
+/************ Logarithm ************************************************/
+
+// Remez coefficients of the approximation of log(1+f) in terms of s=f/(2+f)
+constexpr double LG1 = 6.666666666666735130e-01;
+constexpr double LG2 = 3.999999999940941908e-01;
+constexpr double LG3 = 2.857142874366239149e-01;
+constexpr double LG4 = 2.222219843214978396e-01;
+constexpr double LG5 = 1.818357216161805012e-01;
+constexpr double LG6 = 1.531383769920937332e-01;
+constexpr double LG7 = 1.479819860511658591e-01;
+
+template<KernelAccuracy A> inline double log_kernel(double x) {
+    double xs = x;
+    double kadj = 0.0;
+    if constexpr (A == KernelAccuracy::ACCURATE) {
+        bool subnormal = x < 0x1p-1022;
+        double scaled = x*0x1p54;
+        xs = subnormal ? scaled : x;
+        kadj = subnormal ? -54.0 : 0.0;
+    }
+    // Split xs=2^k*m with m in [sqrt(2)/2,sqrt(2)); the exponent is converted through the bits of 2^52+e,
+    // since there is no vector conversion from 64-bit integers on most targets
+    uint64_t u = bits(xs) + (uint64_t(0x3ff00000-0x3fe6a09e)<<32);
+    double dk = (from_bits(bits(0x1p52) | (u>>52)) - 0x1p52) - 1023.0 + kadj;
+    u = (u & 0x000fffffffffffffull) + (uint64_t(0x3fe6a09e)<<32);
+    double f = from_bits(u) - 1.0;
+    double hfsq = 0.5*f*f;
+    double s = f/(2.0+f);
+    double z = s*s;
+    double w = z*z;
+    double t1 = w*(LG2+w*(LG4+w*LG6));
+    double t2 = z*(LG1+w*(LG3+w*(LG5+w*LG7)));
+    double y = s*(hfsq+(t1+t2)) + dk*LN2_LO - hfsq + f + dk*LN2_HI;
+    double twice = x+x;
+    y = x == 0.0 ? -HUGE_VAL : y;
+    y = x < 0.0 ? std::numeric_limits<double>::quiet_NaN() : y;
+    return x == HUGE_VAL || x != x ? twice : y;
+}
+
+/************ Trigonometric functions ************************************************/
+
+constexpr double TWO_OVER_PI = 6.36619772367581382433e-01;
+// Splitting of pi/2 into pieces of 33 bits, so that n*PIO2_1 and n*PIO2_2 are exact for n<2^20
+constexpr double PIO2_1 = 1.57079632673412561417e+00;
+constexpr double PIO2_1T = 6.07710050650619224932e-11;
+constexpr double PIO2_2 = 6.07710050630396597660e-11;
+constexpr double PIO2_2T = 2.02226624879595063154e-21;
+// Arguments beyond which the reduction is delegated to the C library
+constexpr double TRIGONOMETRIC_REDUCTION_LIMIT = 0x1p19*1.57079632679489661923;
+
+constexpr double S1 = -1.66666666666666324348e-01;
+constexpr double S2 = 8.33333333332248946124e-03;
+constexpr double S3 = -1.98412698298579493134e-04;
+constexpr double S4 = 2.75573137070700676789e-06;
+constexpr double S5 = -2.50507602534068634195e-08;
+constexpr double S6 = 1.58969099521155010221e-10;
+
+constexpr double C1 = 4.16666666666666019037e-02;
+constexpr double C2 = -1.38888888888741095749e-03;
+constexpr double C3 = 2.48015872894767294178e-05;
+constexpr double C4 = -2.75573143513906633035e-07;
+constexpr double C5 = 2.08757232129817482790e-09;
+constexpr double C6 = -1.13596475577881948265e-11;
+
+// Reduces x to r+rlo in [-pi/4,pi/4] with x=r+rlo+n*pi/2, returning n modulo 4
+template<KernelAccuracy A> inline uint64_t reduce_half_pi(double x, double& r, double& rlo) {
+    double shifted = x*TWO_OVER_PI + ROUNDING_SHIFTER;
+    double n = shifted - ROUNDING_SHIFTER;
+    if constexpr (A == KernelAccuracy::ACCURATE) {
+        double y = x - n*PIO2_1;
+        double w = n*PIO2_2;
+        double rh = y - w;
+        double rl = ((y - rh) - w) - n*PIO2_2T;
+        r = rh + rl;
+        rlo = rl - (r - rh);
+    } else {
+        r = (x - n*PIO2_1) - n*PIO2_1T;
+        rlo = 0.0;
+    }
+    return bits(shifted) & 3u;
+}
+
+inline double sin_polynomial(double r, double rlo) {
+    double z = r*r;
+    double v = z*r;
+    double p = S2+z*(S3+z*(S4+z*(S5+z*S6)));
+    return r - ((z*(0.5*rlo-v*p)-rlo)-v*S1);
+}
+
+inline double cos_polynomial(double r, double rlo) {
+    double z = r*r;
+    double hz = 0.5*z;
+    double w = 1.0-hz;
+    return w + (((1.0-w)-hz) + (z*z*(C1+z*(C2+z*(C3+z*(C4+z*(C5+z*C6))))) - r*rlo));
+}
+
+template<KernelAccuracy A> inline double sin_kernel(double x) {
+    double r, rlo;
+    uint64_t q = reduce_half_pi<A>(x,r,rlo);
+    double s = sin_polynomial(r,rlo);
+    double c = cos_polynomial(r,rlo);
+    double y = (q & 1u) ? c : s;
+    double ny = -y;
+    return (q & 2u) ? ny : y;
+}
+
+template<KernelAccuracy A> inline double cos_kernel(double x) {
+    double r, rlo;
+    uint64_t q = reduce_half_pi<A>(x,r,rlo);
+    double s = sin_polynomial(r,rlo);
+    double c = cos_polynomial(r,rlo);
+    double y = (q & 1u) ? s : c;
+    double ny = -y;
+    return ((q+1u) & 2u) ? ny : y;
+}
+
+template<KernelAccuracy A> inline double tan_kernel(double x) {
+    double r, rlo;
+    uint64_t q = reduce_half_pi<A>(x,r,rlo);
+    double s = sin_polynomial(r,rlo);
+    double c = cos_polynomial(r,rlo);
+    double t = s/c;
+    double nt = -c/s;
+    return (q & 1u) ? nt : t;
+}
+
+/************ Inverse trigonometric functions ************************************************/
+
+// Values of atan(c) for the reduction points c in {1/2,1,3/2,infinity}, split into high and low parts
+constexpr double ATAN_HALF_HI = 4.63647609000806093515e-01;
+constexpr double ATAN_HALF_LO = 2.26987774529616870924e-17;
+constexpr double ATAN_ONE_HI = 7.85398163397448278999e-01;
+constexpr double ATAN_ONE_LO = 3.06161699786838301793e-17;
+constexpr double ATAN_THREE_HALVES_HI = 9.82793723247329054082e-01;
+constexpr double ATAN_THREE_HALVES_LO = 1.39033110312309984516e-17;
+constexpr double PIO2_HI = 1.57079632679489655800e+00;
+constexpr double PIO2_LO = 6.12323399573676603587e-17;
+
+constexpr double AT0 = 3.33333333333329318027e-01;
+constexpr double AT1 = -1.99999999998764832476e-01;
+constexpr double AT2 = 1.42857142725034663711e-01;
+constexpr double AT3 = -1.11111104054623557880e-01;
+constexpr double AT4 = 9.09088713343650656196e-02;
+constexpr double AT5 = -7.69187620504482999495e-02;
+constexpr double AT6 = 6.66107313738753120669e-02;
+constexpr double AT7 = -5.83357013379057348645e-02;
+constexpr double AT8 = 4.97687799461593236017e-02;
+constexpr double AT9 = -3.65315727442169155270e-02;
+constexpr double AT10 = 1.62858201153657823623e-02;
+
+// Arctangent of a non-negative argument, possibly infinite, using atan(t)=atan(c)+atan((t-c)/(1+c*t))
+inline double atan_nonnegative(double t) {
+    bool small = t < 0.4375;
+    bool half = t >= 0.4375 && t < 0.6875;
+    bool one = t >= 0.6875 && t < 1.1875;
+    bool three_halves = t >= 1.1875 && t < 2.4375;
+    bool large = t >= 2.4375;
+    double c = half ? 0.5 : (one ? 1.0 : (three_halves ? 1.5 : 0.0));
+    double ui = -1.0/t;
+    double ur = (t-c)/(1.0+c*t);
+    double u = large ? ui : ur;
+    double z = u*u;
+    double w = z*z;
+    double s1 = z*(AT0+w*(AT2+w*(AT4+w*(AT6+w*(AT8+w*AT10)))));
+    double s2 = w*(AT1+w*(AT3+w*(AT5+w*(AT7+w*AT9))));
+    double hi = half ? ATAN_HALF_HI : (one ? ATAN_ONE_HI : (three_halves ? ATAN_THREE_HALVES_HI : PIO2_HI));
+    double lo = half ? ATAN_HALF_LO : (one ? ATAN_ONE_LO : (three_halves ? ATAN_THREE_HALVES_LO : PIO2_LO));
+    double p = u*(s1+s2);
+    double ys = u - p;
+    double yl = hi - ((p - lo) - u);
+    return small ? ys : yl;
+}
+
+inline double atan_kernel(double x) {
+    double y = atan_nonnegative(std::abs(x));
+    double ny = -y;
+    double twice = x+x;
+    return x < 0.0 ? ny : (x != x ? twice : y);
+}
+
+inline double asin_kernel(double x) {
+    double a = std::abs(x);
+    double y = atan_nonnegative(a/std::sqrt((1.0-a)*(1.0+a)));
+    double ny = -y;
+    return x < 0.0 ? ny : (x != x || a > 1.0 ? std::numeric_limits<double>::quiet_NaN() : y);
+}
+
+inline double acos_kernel(double x) {
+    double y = 2.0*atan_nonnegative(std::sqrt((1.0-x)/(1.0+x)));
+    return x != x || std::abs(x) > 1.0 ? std::numeric_limits<double>::quiet_NaN() : y;
+}
+
+/************ Block evaluation ************************************************/
+
+template<class K> void apply_kernel(std::span<const Real> x, std::span<Real> r, K const& k) {
+    HELPER_PRECONDITION_MSG(x.size()==r.size(),"The argument and result of a batch operation must have the same size.");
+    double xb[BLOCK_SIZE];
+    double rb[BLOCK_SIZE];
+    for (size_t i=0; i<x.size(); i+=BLOCK_SIZE) {
+        size_t m=std::min(BLOCK_SIZE,x.size()-i);
+        for (size_t j=0; j!=m; ++j) xb[j]=x[i+j].value();
+        for (size_t j=0; j!=m; ++j) rb[j]=k(xb[j]);
+        for (size_t j=0; j!=m; ++j) r[i+j]=Real(rb[j]);
+    }
+}
+
+template<class K> void apply_kernel(std::span<const Real> x1, std::span<const Real> x2, std::span<Real> r, K const& k) {
+    HELPER_PRECONDITION_MSG(x1.size()==r.size() && x2.size()==r.size(),"The arguments and result of a batch operation must have the same size.");
+    double xb1[BLOCK_SIZE];
+    double xb2[BLOCK_SIZE];
+    double rb[BLOCK_SIZE];
+    for (size_t i=0; i<r.size(); i+=BLOCK_SIZE) {
+        size_t m=std::min(BLOCK_SIZE,r.size()-i);
+        for (size_t j=0; j!=m; ++j) xb1[j]=x1[i+j].value();
+        for (size_t j=0; j!=m; ++j) xb2[j]=x2[i+j].value();
+        for (size_t j=0; j!=m; ++j) rb[j]=k(xb1[j],xb2[j]);
+        for (size_t j=0; j!=m; ++j) r[i+j]=Real(rb[j]);
+    }
+}
+
+// Trigonometric kernels are only valid up to the reduction limit; larger arguments are handled by a scalar pass
+template<class K, class F> void apply_trigonometric_kernel(std::span<const Real> x, std::span<Real> r, K const& k, F const& f) {
+    HELPER_PRECONDITION_MSG(x.size()==r.size(),"The argument and result of a batch operation must have the same size.");
+    double xb[BLOCK_SIZE];
+    double rb[BLOCK_SIZE];
+    for (size_t i=0; i<x.size(); i+=BLOCK_SIZE) {
+        size_t m=std::min(BLOCK_SIZE,x.size()-i);
+        bool reducible=true;
+        for (size_t j=0; j!=m; ++j) xb[j]=x[i+j].value();
+        for (size_t j=0; j!=m; ++j) reducible &= std::abs(xb[j]) <= TRIGONOMETRIC_REDUCTION_LIMIT;
+        for (size_t j=0; j!=m; ++j) rb[j]=k(xb[j]);
+        if (not reducible) {
+            for (size_t j=0; j!=m; ++j) if (not (std::abs(xb[j]) <= TRIGONOMETRIC_REDUCTION_LIMIT)) rb[j]=f(xb[j]);
+        }
+        for (size_t j=0; j!=m; ++j) r[i+j]=Real(rb[j]);
+    }
+}
+
+template<class F> void apply_libm(std::span<const Real> x, std::span<Real> r, F const& f) {
+    apply_kernel(x,r,[&f](double v){ return f(v); });
+}
+
+} // namespace
+
+void nul(std::span<const Real> x, std::span<Real> r) { apply_kernel(x,r,[](double){ return 0.0; }); }
+void pos(std::span<const Real> x, std::span<Real> r) { apply_kernel(x,r,[](double v){ return v; }); }
+void neg(std::span<const Real> x, std::span<Real> r) { apply_kernel(x,r,[](double v){ return -v; }); }
+void hlf(std::span<const Real> x, std::span<Real> r) { apply_kernel(x,r,[](double v){ return v/2; }); }
+void sqr(std::span<const Real> x, std::span<Real> r) { apply_kernel(x,r,[](double v){ return v*v; }); }
+void rec(std::span<const Real> x, std::span<Real> r) { apply_kernel(x,r,[](double v){ return 1.0/v; }); }
+void abs(std::span<const Real> x, std::span<Real> r) { apply_kernel(x,r,[](double v){ return std::abs(v); }); }
+void sqrt(std::span<const Real> x, std::span<Real> r) { apply_kernel(x,r,[](double v){ return std::sqrt(v); }); }
+
+void add(std::span<const Real> x1, std::span<const Real> x2, std::span<Real> r) {
+    apply_kernel(x1,x2,r,[](double v1, double v2){ return v1+v2; }); }
+void sub(std::span<const Real> x1, std::span<const Real> x2, std::span<Real> r) {
+    apply_kernel(x1,x2,r,[](double v1, double v2){ return v1-v2; }); }
+void mul(std::span<const Real> x1, std::span<const Real> x2, std::span<Real> r) {
+    apply_kernel(x1,x2,r,[](double v1, double v2){ return v1*v2; }); }
+void div(std::span<const Real> x1, std::span<const Real> x2, std::span<Real> r) {
+    apply_kernel(x1,x2,r,[](double v1, double v2){ return v1/v2; }); }
+void min(std::span<const Real> x1, std::span<const Real> x2, std::span<Real> r) {
+    apply_kernel(x1,x2,r,[](double v1, double v2){ return std::min(v1,v2); }); }
+void max(std::span<const Real> x1, std::span<const Real> x2, std::span<Real> r) {
+    apply_kernel(x1,x2,r,[](double v1, double v2){ return std::max(v1,v2); }); }
+
+void pow(std::span<const Real> x, int n, std::span<Real> r) {
+    HELPER_PRECONDITION_MSG(x.size()==r.size(),"The argument and result of a batch operation must have the same size.");
+    for (size_t i=0; i!=x.size(); ++i) r[i]=pow(x[i],n);
+}
+
+void exp(std::span<const Real> x, std::span<Real> r, KernelAccuracy acc) {
+    switch (acc) {
+        case KernelAccuracy::ACCURATE: apply_kernel(x,r,[](double v){ return exp_kernel<KernelAccuracy::ACCURATE>(v); }); break;
+        case KernelAccuracy::FAST: apply_kernel(x,r,[](double v){ return exp_kernel<KernelAccuracy::FAST>(v); }); break;
+        case KernelAccuracy::LIBM: apply_libm(x,r,[](double v){ return std::exp(v); }); break;
+        default: HELPER_FAIL_MSG("Unhandled kernel accuracy " << acc << ".");
+    }
+}
+
+void log(std::span<const Real> x, std::span<Real> r, KernelAccuracy acc) {
+    switch (acc) {
+        case KernelAccuracy::ACCURATE: apply_kernel(x,r,[](double v){ return log_kernel<KernelAccuracy::ACCURATE>(v); }); break;
+        case KernelAccuracy::FAST: apply_kernel(x,r,[](double v){ return log_kernel<KernelAccuracy::FAST>(v); }); break;
+        case KernelAccuracy::LIBM: apply_libm(x,r,[](double v){ return std::log(v); }); break;
+        default: HELPER_FAIL_MSG("Unhandled kernel accuracy " << acc << ".");
+    }
+}
+
+void sin(std::span<const Real> x, std::span<Real> r, KernelAccuracy acc) {
+    auto f=[](double v){ return std::sin(v); };
+    switch (acc) {
+        case KernelAccuracy::ACCURATE: apply_trigonometric_kernel(x,r,[](double v){ return sin_kernel<KernelAccuracy::ACCURATE>(v); },f); break;
+        case KernelAccuracy::FAST: apply_trigonometric_kernel(x,r,[](double v){ return sin_kernel<KernelAccuracy::FAST>(v); },f); break;
+        case KernelAccuracy::LIBM: apply_libm(x,r,f); break;
+        default: HELPER_FAIL_MSG("Unhandled kernel accuracy " << acc << ".");
+    }
+}
+
+void cos(std::span<const Real> x, std::span<Real> r, KernelAccuracy acc) {
+    auto f=[](double v){ return std::cos(v); };
+    switch (acc) {
+        case KernelAccuracy::ACCURATE: apply_trigonometric_kernel(x,r,[](double v){ return cos_kernel<KernelAccuracy::ACCURATE>(v); },f); break;
+        case KernelAccuracy::FAST: apply_trigonometric_kernel(x,r,[](double v){ return cos_kernel<KernelAccuracy::FAST>(v); },f); break;
+        case KernelAccuracy::LIBM: apply_libm(x,r,f); break;
+        default: HELPER_FAIL_MSG("Unhandled kernel accuracy " << acc << ".");
+    }
+}
+
+void tan(std::span<const Real> x, std::span<Real> r, KernelAccuracy acc) {
+    auto f=[](double v){ return std::tan(v); };
+    switch (acc) {
+        case KernelAccuracy::ACCURATE: apply_trigonometric_kernel(x,r,[](double v){ return tan_kernel<KernelAccuracy::ACCURATE>(v); },f); break;
+        case KernelAccuracy::FAST: apply_trigonometric_kernel(x,r,[](double v){ return tan_kernel<KernelAccuracy::FAST>(v); },f); break;
+        case KernelAccuracy::LIBM: apply_libm(x,r,f); break;
+        default: HELPER_FAIL_MSG("Unhandled kernel accuracy " << acc << ".");
+    }
+}
+
+void asin(std::span<const Real> x, std::span<Real> r, KernelAccuracy acc) {
+    if (acc == KernelAccuracy::LIBM) { apply_libm(x,r,[](double v){ return std::asin(v); }); }
+    else { apply_kernel(x,r,[](double v){ return asin_kernel(v); }); }
+}
+
+void acos(std::span<const Real> x, std::span<Real> r, KernelAccuracy acc) {
+    if (acc == KernelAccuracy::LIBM) { apply_libm(x,r,[](double v){ return std::acos(v); }); }
+    else { apply_kernel(x,r,[](double v){ return acos_kernel(v); }); }
+}
+
+void atan(std::span<const Real> x, std::span<Real> r, KernelAccuracy acc) {
+    if (acc == KernelAccuracy::LIBM) { apply_libm(x,r,[](double v){ return std::atan(v); }); }
+    else { apply_kernel(x,r,[](double v){ return atan_kernel(v); }); }
+}
+
+} // namespace SymboliCore
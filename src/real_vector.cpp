@@ -0,0 +1,82 @@
+/***************************************************************************
+ *            real_vector.cpp
+ *
+ *  Copyright  2023  Luca Geretti
+ *
+ ****************************************************************************/
+
+/*
+ * This file is part of SymboliCore, under the MIT license.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <cmath>
+
+#include "real_vector.hpp"
+
+namespace SymboliCore {
+
+namespace {
+
+// Number of independent partial results in the reductions; sequential accumulation would prevent vectorisation
+constexpr size_t LANES = 8;
+
+template<class F, class M> double reduce(size_t n, F const& f, M const& merge) {
+    double acc[LANES] = { };
+    size_t i=0;
+    for (; i+LANES<=n; i+=LANES) {
+        for (size_t k=0; k!=LANES; ++k) { acc[k]=merge(acc[k],f(i+k)); }
+    }
+    for (; i!=n; ++i) { acc[0]=merge(acc[0],f(i)); }
+    double r=acc[0];
+    for (size_t k=1; k!=LANES; ++k) { r=merge(r,acc[k]); }
+    return r;
+}
+
+inline double add(double a1, double a2) { return a1+a2; }
+inline double max(double a1, double a2) { return a1<a2 ? a2 : a1; }
+
+} // namespace
+
+Real dot(Vector<Real> const& v1, Vector<Real> const& v2) {
+    HELPER_PRECONDITION(v1.size()==v2.size());
+    Real const* p1=v1.data(); Real const* p2=v2.data();
+    return Real(reduce(v1.size(),[p1,p2](size_t i){return p1[i].value()*p2[i].value();},add));
+}
+
+Real norm(Vector<Real> const& v) {
+    Real const* p=v.data();
+    return Real(reduce(v.size(),[p](size_t i){return std::abs(p[i].value());},max));
+}
+
+Real sup_norm(Vector<Real> const& v) {
+    return norm(v);
+}
+
+Real two_norm(Vector<Real> const& v) {
+    Real const* p=v.data();
+    return Real(std::sqrt(reduce(v.size(),[p](size_t i){return p[i].value()*p[i].value();},add)));
+}
+
+Vector<Real> join(Vector<Real> const& v1, Vector<Real> const& v2) {
+    size_t n1=v1.size();
+    return Vector<Real>(n1+v2.size(),[&v1,&v2,n1](size_t i){return i<n1 ? v1[i] : v2[i-n1];});
+}
+
+} // namespace SymboliCore
@@ -41,21 +41,24 @@ namespace SymboliCore {
 
 using Helper::List;
 
-template<class T> Space<T>::Space() : _variables() { }
+template<class T> Space<T>::Space() : _variables(), _indices() { }
 
 template<class T> Space<T>::Space(const List<VariableType>& vl) {
+    _variables.reserve(vl.size()); _indices.reserve(vl.size());
     for(size_t i=0; i!=vl.size(); ++i) {
         this->append(vl[i]);
     }
 }
 
 template<class T> Space<T>::Space(const List<Identifier>& vl) {
+    _variables.reserve(vl.size()); _indices.reserve(vl.size());
     for(size_t i=0; i!=vl.size(); ++i) {
         this->append(VariableType(vl[i]));
     }
 }
 
 template<class T> Space<T>::Space(const initializer_list<VariableType>& vl) {
+    _variables.reserve(vl.size()); _indices.reserve(vl.size());
     for(size_t i=0; i!=vl.size(); ++i) {
         this->append(vl.begin()[i]);
     }
@@ -86,26 +89,29 @@ template<class T> List<typename Space<T>::VariableType> Space<T>::variables() co
     return List<VariableType>(this->_variables); }
 
 template<class T> Map<Identifier,size_t> Space<T>::indices_from_names() const {
-    Map<Identifier,size_t> indices;
-    for(size_t i=0; i!=this->_variables.size(); ++i) {
-        HELPER_ASSERT_MSG(!indices.has_key(_variables[i]),"Repeated variable "<<_variables[i]<<" in space "<<_variables)
-            indices.insert(this->_variables[i],i);
-    }
-    return indices;
+    if(_maps==nullptr) { return Map<Identifier,size_t>(); }
+    std::call_once(_maps->names_built,[this](){
+        _maps->requested=true;
+        for(auto const& entry : _indices) { _maps->names.insert(entry.first,entry.second); }
+    });
+    return _maps->names;
 }
 template<class T> Map<typename Space<T>::VariableType,size_t> Space<T>::indices() const {
-    Map<VariableType,size_t> indices;
-    for(size_t i=0; i!=this->_variables.size(); ++i) {
-        HELPER_ASSERT_MSG(!indices.has_key(VariableType(_variables[i])),"Repeated variable "<<_variables[i]<<" in space "<<_variables)
-        indices.insert(VariableType(this->_variables[i]),i);
-    }
-    return indices;
+    if(_maps==nullptr) { return Map<VariableType,size_t>(); }
+    std::call_once(_maps->variables_built,[this](){
+        _maps->requested=true;
+        for(auto const& entry : _indices) { _maps->variables.insert(VariableType(entry.first),entry.second); }
+    });
+    return _maps->variables;
+}
+
+template<class T> void Space<T>::_modified() {
+    // The maps are only reused if not built yet and not shared, since other copies may still refer to them
+    if(_maps==nullptr || _maps->requested || _maps.use_count()>1) { _maps=std::make_shared<IndexMaps>(); }
 }
 
 template<class T> bool Space<T>::contains(const typename Space<T>::VariableType& v) const {
-    for(size_t i=0; i!=_variables.size(); ++i) {
-        if(v.name()==_variables[i]) { return true; } }
-    return false; }
+    return _indices.find(v.name())!=_indices.end(); }
 template<class T> bool Space<T>::contains(const Set<typename Space<T>::VariableType>& vs) const {
     for(auto v : vs) {
         if(!this->contains(v)) { return false; } }
@@ -115,30 +121,30 @@ template<class T> size_t Space<T>::operator[](const typename Space<T>::VariableT
 template<class T> size_t Space<T>::operator[](const Identifier& n) const {
     return this->index(n); }
 template<class T> size_t Space<T>::index(const typename Space<T>::VariableType& v) const {
-    for(size_t i=0; i!=_variables.size(); ++i) {
-        if(v.name()==_variables[i]) { return i; } }
-    HELPER_ASSERT_MSG(false,"Variable "<<v<<" is not in the Space "<<*this);
-    return _variables.size(); }
+    auto iter=_indices.find(v.name());
+    HELPER_ASSERT_MSG(iter!=_indices.end(),"Variable "<<v<<" is not in the Space "<<*this);
+    return iter==_indices.end() ? _variables.size() : iter->second; }
 template<class T> size_t Space<T>::index(const Identifier& n) const {
-    for(size_t i=0; i!=_variables.size(); ++i) {
-        if(n==_variables[i]) { return i; } }
-    HELPER_ASSERT_MSG(false,"Variable named "<<n<<" is not in the Space "<<*this);
-    return _variables.size(); }
+    auto iter=_indices.find(n);
+    HELPER_ASSERT_MSG(iter!=_indices.end(),"Variable named "<<n<<" is not in the Space "<<*this);
+    return iter==_indices.end() ? _variables.size() : iter->second; }
 template<class T> Space<T>& Space<T>::insert(const typename Space<T>::VariableType& v) {
-    for(size_t i=0; i!=_variables.size(); ++i) {
-        if(_variables[i]==v.name()) { return *this; } }
-    _variables.push_back(v.name()); return *this; }
+    if(_indices.emplace(v.name(),_variables.size()).second) { _variables.push_back(v.name()); this->_modified(); }
+    return *this; }
 
 template<class T> Space<T>& Space<T>::adjoin(const Space<T>& spc) {
-    for(size_t i=0; i!=spc._variables.size(); ++i) { this->insert(VariableType(spc._variables[i])); }
+    _indices.reserve(_variables.size()+spc._variables.size());
+    for(size_t i=0; i!=spc._variables.size(); ++i) {
+        if(_indices.emplace(spc._variables[i],_variables.size()).second) { _variables.push_back(spc._variables[i]); this->_modified(); }
+    }
     return *this;
 }
 
 template<class T> Space<T>& Space<T>::append(const VariableType& v) {
-    for(size_t i=0; i!=_variables.size(); ++i) {
-        HELPER_ASSERT_MSG(_variables[i]!=v.name(),"Variable "<<v<<" is already a variable of the StateSpace "<<*this);
-    }
-    _variables.push_back(v.name()); return *this;
+    bool inserted=_indices.emplace(v.name(),_variables.size()).second;
+    HELPER_ASSERT_MSG(inserted,"Variable "<<v<<" is already a variable of the StateSpace "<<*this);
+    if(inserted) { _variables.push_back(v.name()); this->_modified(); }
+    return *this;
 }
 
 template class Space<Real>;
@@ -0,0 +1,137 @@
+/***************************************************************************
+ *            variable.cpp
+ *
+ *  Copyright  2023  Luca Geretti
+ *
+ ****************************************************************************/
+
+/*
+ * This file is part of SymboliCore, under the MIT license.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*! \file variable.cpp
+ *  \brief Internal variables
+ */
+
+#include <algorithm>
+#include <deque>
+#include <iterator>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
+#include "integer.hpp"
+#include "real.hpp"
+#include "variable.hpp"
+
+namespace SymboliCore {
+
+namespace {
+
+struct UntypedVariableHash {
+    size_t operator()(UntypedVariable const& v) const {
+        return std::hash<std::string>()(v.name())*31u+static_cast<size_t>(v.type()); }
+};
+
+// The table of the variables used in expressions; entries are never removed, so indices stay valid.
+// Lookups only take a shared lock, so that queries from several threads do not serialise;
+// the exclusive lock is taken only when a variable is interned for the first time.
+class VariableTable {
+    std::shared_mutex _mutex;
+    std::deque<UntypedVariable> _variables;
+    std::unordered_map<UntypedVariable,VariableIndex,UntypedVariableHash> _indices;
+  public:
+    VariableIndex intern(UntypedVariable const& v) {
+        VariableIndex i;
+        if(find(v,i)) { return i; }
+        std::unique_lock<std::shared_mutex> lock(_mutex);
+        auto iter=_indices.emplace(v,static_cast<VariableIndex>(_variables.size()));
+        if(iter.second) { _variables.push_back(v); }
+        return iter.first->second;
+    }
+    bool find(UntypedVariable const& v, VariableIndex& i) {
+        std::shared_lock<std::shared_mutex> lock(_mutex);
+        auto iter=_indices.find(v);
+        if(iter==_indices.end()) { return false; }
+        i=iter->second; return true;
+    }
+    template<class F> void with_variables(F const& f) {
+        std::shared_lock<std::shared_mutex> lock(_mutex);
+        f(static_cast<std::deque<UntypedVariable> const&>(_variables));
+    }
+};
+
+VariableTable& variable_table() {
+    static VariableTable table;
+    return table;
+}
+
+} // namespace
+
+VariableIndex intern(UntypedVariable const& v) {
+    return variable_table().intern(v);
+}
+
+UntypedVariable interned_variable(VariableIndex i) {
+    UntypedVariable const* r=nullptr;
+    variable_table().with_variables([&](std::deque<UntypedVariable> const& vars){
+        HELPER_PRECONDITION_MSG(i<vars.size(),"No variable has index "<<i);
+        r=&vars[i]; });
+    return *r;
+}
+
+ArgumentSet::ArgumentSet(UntypedVariable const& v)
+    : _ids(std::make_shared<const std::vector<VariableIndex>>(1u,intern(v))) { }
+
+bool ArgumentSet::contains(VariableIndex i) const {
+    return std::binary_search(begin(),end(),i);
+}
+
+bool ArgumentSet::contains(UntypedVariable const& v) const {
+    VariableIndex i;
+    return !empty() && variable_table().find(v,i) && contains(i);
+}
+
+Set<UntypedVariable> ArgumentSet::variables() const {
+    Set<UntypedVariable> r;
+    variable_table().with_variables([&](std::deque<UntypedVariable> const& vars){
+        for(auto i : *this) { r.insert(vars[i]); } });
+    return r;
+}
+
+ArgumentSet join(ArgumentSet const& as1, ArgumentSet const& as2) {
+    if(as2.empty() || as1._ids==as2._ids) { return as1; }
+    if(as1.empty()) { return as2; }
+    std::vector<VariableIndex> ids; ids.reserve(as1.size()+as2.size());
+    std::set_union(as1.begin(),as1.end(),as2.begin(),as2.end(),std::back_inserter(ids));
+    if(ids.size()==as1.size()) { return as1; }
+    if(ids.size()==as2.size()) { return as2; }
+    return ArgumentSet(std::make_shared<const std::vector<VariableIndex>>(std::move(ids)));
+}
+
+bool operator==(ArgumentSet const& as1, ArgumentSet const& as2) {
+    return as1._ids==as2._ids || std::equal(as1.begin(),as1.end(),as2.begin(),as2.end());
+}
+
+ostream& operator<<(ostream& os, ArgumentSet const& as) {
+    return os << as.variables();
+}
+
+} // namespace SymboliCore
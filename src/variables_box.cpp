@@ -0,0 +1,229 @@
+/***************************************************************************
+ *            variables_box.cpp
+ *
+ *  Copyright  2023  Luca Geretti
+ *
+ ****************************************************************************/
+
+/*
+ * This file is part of SymboliCore, under the MIT license.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*! \file variables_box.cpp
+ *  \brief Boxes in named real variables, and their evaluation on expressions.
+ */
+
+#include <map>
+
+#include "helper/macros.hpp"
+#include "variables_box.hpp"
+
+namespace SymboliCore {
+
+namespace {
+
+//! \brief A linear form of an expression, in which each distinct node is an instruction writing to its own slot.
+//! \details Real-valued instructions are recorded in dependency order, followed by the logical instructions of a predicate.
+class IntervalTape {
+    struct Instruction { OperatorCode code; OperatorKind kind; size_t arg1; size_t arg2; int num; };
+  public:
+    //! \brief Record the real expression \a e, returning its slot.
+    size_t record(Expression<Real> const& e);
+    //! \brief Record the predicate \a p, returning its slot in the logical values.
+    size_t record(Expression<Kleenean> const& p);
+    //! \brief Compute all real slots on the box \a bx.
+    void execute(RealVariablesBox const& bx, List<RealInterval>& values) const;
+    //! \brief Compute all logical slots, using the real slots \a values.
+    void execute(List<RealInterval> const& values, List<LogicalValue>& logical_values) const;
+    size_t size() const { return _instructions.size(); }
+    size_t logical_size() const { return _logical_instructions.size(); }
+  private:
+    List<Instruction> _instructions;
+    List<RealInterval> _constants;
+    List<Identifier> _variables;
+    List<Instruction> _logical_instructions;
+    List<LogicalValue> _logical_constants;
+    std::map<void const*,size_t> _real_slots;
+    std::map<void const*,size_t> _logical_slots;
+};
+
+size_t IntervalTape::record(Expression<Real> const& e) {
+    auto iter=_real_slots.find(e.node_raw_ptr());
+    if (iter!=_real_slots.end()) { return iter->second; }
+
+    Instruction instruction({e.code(),e.kind(),0u,0u,0});
+    switch(e.kind()) {
+        case OperatorKind::NULLARY:
+        case OperatorKind::VARIABLE:
+            if (e.code()==OperatorCode::CNST) {
+                instruction.arg1=_constants.size(); _constants.push_back(RealInterval(e.val()));
+            } else {
+                instruction.arg1=_variables.size(); _variables.push_back(e.var());
+            }
+            break;
+        case OperatorKind::UNARY: instruction.arg1=record(e.arg()); break;
+        case OperatorKind::BINARY: instruction.arg1=record(e.arg1()); instruction.arg2=record(e.arg2()); break;
+        case OperatorKind::GRADED: instruction.arg1=record(e.arg()); instruction.num=e.num(); break;
+        default: HELPER_FAIL_MSG("Cannot evaluate expression "<<e<<" over a box");
+    }
+    size_t slot=_instructions.size();
+    _instructions.push_back(instruction);
+    _real_slots.insert(std::make_pair(e.node_raw_ptr(),slot));
+    return slot;
+}
+
+size_t IntervalTape::record(Expression<Kleenean> const& p) {
+    auto iter=_logical_slots.find(p.node_raw_ptr());
+    if (iter!=_logical_slots.end()) { return iter->second; }
+
+    Instruction instruction({p.code(),p.kind(),0u,0u,0});
+    switch(p.code()) {
+        case OperatorCode::CNST:
+            instruction.arg1=_logical_constants.size();
+            _logical_constants.push_back(static_cast<LogicalValue>(p.val().check(Effort::get_default())));
+            break;
+        case OperatorCode::NOT: instruction.arg1=record(p.arg()); break;
+        case OperatorCode::AND: case OperatorCode::OR: instruction.arg1=record(p.arg1()); instruction.arg2=record(p.arg2()); break;
+        case OperatorCode::SGN: instruction.arg1=record(p.cmp<Real>()); break;
+        case OperatorCode::EQ: case OperatorCode::NEQ: case OperatorCode::LEQ: case OperatorCode::GEQ: case OperatorCode::LT: case OperatorCode::GT:
+            instruction.arg1=record(p.cmp1<Real>()); instruction.arg2=record(p.cmp2<Real>()); break;
+        default: HELPER_FAIL_MSG("Cannot check predicate "<<p<<" over a box");
+    }
+    size_t slot=_logical_instructions.size();
+    _logical_instructions.push_back(instruction);
+    _logical_slots.insert(std::make_pair(p.node_raw_ptr(),slot));
+    return slot;
+}
+
+RealInterval unary(OperatorCode code, RealInterval const& a) {
+    switch(code) {
+        case OperatorCode::NUL: return nul(a);
+        case OperatorCode::POS: return pos(a);
+        case OperatorCode::NEG: return neg(a);
+        case OperatorCode::HLF: return hlf(a);
+        case OperatorCode::REC: return rec(a);
+        case OperatorCode::SQR: return sqr(a);
+        case OperatorCode::SQRT: return sqrt(a);
+        case OperatorCode::EXP: return exp(a);
+        case OperatorCode::LOG: return log(a);
+        case OperatorCode::SIN: return sin(a);
+        case OperatorCode::COS: return cos(a);
+        case OperatorCode::TAN: return tan(a);
+        case OperatorCode::ASIN: return asin(a);
+        case OperatorCode::ACOS: return acos(a);
+        case OperatorCode::ATAN: return atan(a);
+        case OperatorCode::ABS: return abs(a);
+        default: HELPER_FAIL_MSG("Cannot evaluate unary operator "<<code<<" on intervals");
+    }
+}
+
+RealInterval binary(OperatorCode code, RealInterval const& a1, RealInterval const& a2) {
+    switch(code) {
+        case OperatorCode::ADD: return add(a1,a2);
+        case OperatorCode::SUB: return sub(a1,a2);
+        case OperatorCode::MUL: return mul(a1,a2);
+        case OperatorCode::DIV: return div(a1,a2);
+        case OperatorCode::MAX: return max(a1,a2);
+        case OperatorCode::MIN: return min(a1,a2);
+        default: HELPER_FAIL_MSG("Cannot evaluate binary operator "<<code<<" on intervals");
+    }
+}
+
+void IntervalTape::execute(RealVariablesBox const& bx, List<RealInterval>& values) const {
+    values.resize(_instructions.size());
+    for (size_t i=0; i!=_instructions.size(); ++i) {
+        Instruction const& instruction=_instructions[i];
+        switch(instruction.kind) {
+            case OperatorKind::NULLARY:
+            case OperatorKind::VARIABLE:
+                values[i] = (instruction.code==OperatorCode::CNST) ? _constants[instruction.arg1] : bx[_variables[instruction.arg1]];
+                break;
+            case OperatorKind::UNARY: values[i]=unary(instruction.code,values[instruction.arg1]); break;
+            case OperatorKind::BINARY: values[i]=binary(instruction.code,values[instruction.arg1],values[instruction.arg2]); break;
+            case OperatorKind::GRADED: values[i]=pow(values[instruction.arg1],instruction.num); break;
+            default: HELPER_FAIL_MSG("Unhandled operator kind "<<instruction.kind);
+        }
+    }
+}
+
+void IntervalTape::execute(List<RealInterval> const& values, List<LogicalValue>& logical_values) const {
+    logical_values.resize(_logical_instructions.size());
+    for (size_t i=0; i!=_logical_instructions.size(); ++i) {
+        Instruction const& instruction=_logical_instructions[i];
+        LogicalValue& r=logical_values[i];
+        switch(instruction.code) {
+            case OperatorCode::CNST: r=_logical_constants[instruction.arg1]; break;
+            case OperatorCode::NOT: r=!logical_values[instruction.arg1]; break;
+            case OperatorCode::AND: r=logical_values[instruction.arg1] && logical_values[instruction.arg2]; break;
+            case OperatorCode::OR: r=logical_values[instruction.arg1] || logical_values[instruction.arg2]; break;
+            case OperatorCode::SGN: r=static_cast<LogicalValue>(sgn(values[instruction.arg1])); break;
+            case OperatorCode::EQ: r=static_cast<LogicalValue>(eq(values[instruction.arg1],values[instruction.arg2])); break;
+            case OperatorCode::NEQ: r=!static_cast<LogicalValue>(eq(values[instruction.arg1],values[instruction.arg2])); break;
+            case OperatorCode::LEQ: r=static_cast<LogicalValue>(leq(values[instruction.arg1],values[instruction.arg2])); break;
+            case OperatorCode::GEQ: r=static_cast<LogicalValue>(leq(values[instruction.arg2],values[instruction.arg1])); break;
+            case OperatorCode::LT: r=static_cast<LogicalValue>(lt(values[instruction.arg1],values[instruction.arg2])); break;
+            case OperatorCode::GT: r=static_cast<LogicalValue>(lt(values[instruction.arg2],values[instruction.arg1])); break;
+            default: HELPER_FAIL_MSG("Unhandled logical operator "<<instruction.code);
+        }
+    }
+}
+
+} // namespace
+
+RealInterval evaluate(Expression<Real> const& e, RealVariablesBox const& bx) {
+    IntervalTape tape; size_t slot=tape.record(e);
+    List<RealInterval> values;
+    tape.execute(bx,values);
+    return values[slot];
+}
+
+ValidatedKleenean evaluate(Expression<Kleenean> const& p, RealVariablesBox const& bx) {
+    IntervalTape tape; size_t slot=tape.record(p);
+    List<RealInterval> values; List<LogicalValue> logical_values;
+    tape.execute(bx,values);
+    tape.execute(values,logical_values);
+    return ValidatedKleenean(logical_values[slot]);
+}
+
+List<RealInterval> evaluate(Expression<Real> const& e, List<RealVariablesBox> const& bxs) {
+    IntervalTape tape; size_t slot=tape.record(e);
+    List<RealInterval> values; values.reserve(tape.size());
+    List<RealInterval> result; result.reserve(bxs.size());
+    for (auto const& bx : bxs) {
+        tape.execute(bx,values);
+        result.push_back(values[slot]);
+    }
+    return result;
+}
+
+List<ValidatedKleenean> evaluate(Expression<Kleenean> const& p, List<RealVariablesBox> const& bxs) {
+    IntervalTape tape; size_t slot=tape.record(p);
+    List<RealInterval> values; values.reserve(tape.size());
+    List<LogicalValue> logical_values; logical_values.reserve(tape.logical_size());
+    List<ValidatedKleenean> result; result.reserve(bxs.size());
+    for (auto const& bx : bxs) {
+        tape.execute(bx,values);
+        tape.execute(values,logical_values);
+        result.push_back(ValidatedKleenean(logical_values[slot]));
+    }
+    return result;
+}
+
+} // namespace SymboliCore
@@ -0,0 +1,166 @@
+/***************************************************************************
+ *            vector_field.cpp
+ *
+ *  Copyright  2023  Luca Geretti
+ *
+ ****************************************************************************/
+
+/*
+ * This file is part of SymboliCore, under the MIT license.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+/*! \file vector_field.cpp
+ *  \brief Compiled vector fields of ordinary differential equations.
+ */
+
+#include <algorithm>
+#include <map>
+#include <unordered_map>
+
+#include "helper/macros.hpp"
+#include "helper/container.hpp"
+#include "vector_field.hpp"
+
+namespace SymboliCore {
+
+namespace {
+
+typedef std::map<size_t,RealExpression> SparseGradient;
+
+// The right-hand sides of the dynamics, ordered as the state space
+Vector<RealExpression> dynamics_expressions(DottedRealAssignments const& dynamics, RealSpace const& spc) {
+    Vector<RealExpression> results(spc.dimension(),RealExpression::constant(Real(0)));
+    std::vector<bool> given(spc.dimension(),false);
+    for (auto const& a : dynamics) {
+        RealVariable v=a.lhs.base();
+        if (not spc.contains(v)) {
+            HELPER_THROW(std::runtime_error,"VectorField(DottedRealAssignments,RealSpace)","Variable "<<v<<" is not in the state space "<<spc);
+        }
+        size_t i=spc.index(v);
+        if (given[i]) {
+            HELPER_THROW(std::runtime_error,"VectorField(DottedRealAssignments,RealSpace)","The derivative of variable "<<v<<" is given more than once");
+        }
+        given[i]=true;
+        results[i]=a.rhs;
+    }
+    for (size_t i=0; i!=spc.dimension(); ++i) {
+        if (not given[i]) {
+            HELPER_THROW(std::runtime_error,"VectorField(DottedRealAssignments,RealSpace)","The derivative of variable "<<spc.variable(i)<<" is not given");
+        }
+    }
+    return results;
+}
+
+// Add the gradient of e with respect to the state, by the chain rule through the gradients of its arguments
+void accumulate_gradient(RealExpression const& e, std::unordered_map<VariableIndex,SparseGradient> const& gradients, SparseGradient& result) {
+    for (auto id : e.argument_set()) {
+        auto giter=gradients.find(id);
+        if (giter==gradients.end()) { continue; }
+        RealExpression d=simplify(derivative(e,RealVariable(interned_variable(id).name())));
+        if (is_constant(d,Real(0))) { continue; }
+        for (auto const& [j,g] : giter->second) {
+            RealExpression t=is_constant(g,Real(1)) ? d : d*g;
+            auto riter=result.find(j);
+            if (riter==result.end()) { result.emplace(j,t); } else { riter->second=riter->second+t; }
+        }
+    }
+}
+
+// The values of the field followed by the nonzero entries of the Jacobian, row by row
+Vector<RealExpression> jacobian_results(Vector<RealExpression> const& f, DependencyPattern const& pattern,
+                                        List<RealAssignment> const& auxiliary, RealSpace const& spc) {
+    std::unordered_map<VariableIndex,SparseGradient> gradients;
+    for (size_t j=0; j!=spc.dimension(); ++j) {
+        gradients[intern(spc.variable(j))].emplace(j,RealExpression::constant(Real(1)));
+    }
+    for (auto const& a : auxiliary) {
+        SparseGradient g;
+        accumulate_gradient(a.rhs,gradients,g);
+        gradients.insert_or_assign(intern(a.lhs),std::move(g));
+    }
+
+    List<RealExpression> results(f.array().begin(),f.array().end());
+    results.reserve(f.size()+pattern.number_of_nonzeros());
+    for (size_t i=0; i!=f.size(); ++i) {
+        SparseGradient g;
+        accumulate_gradient(f[i],gradients,g);
+        for (auto j : pattern.row(i)) {
+            auto iter=g.find(j);
+            results.push_back(iter==g.end() ? RealExpression::constant(Real(0)) : simplify(iter->second));
+        }
+    }
+    return Vector<RealExpression>(results);
+}
+
+} // namespace
+
+VectorField::VectorField(DottedRealAssignments const& dynamics, RealSpace const& spc)
+    : VectorField(List<RealAssignment>(),dynamics,spc)
+{
+}
+
+VectorField::VectorField(List<RealAssignment> const& auxiliary, DottedRealAssignments const& dynamics, RealSpace const& spc)
+    : _expressions(dynamics_expressions(dynamics,spc))
+    , _pattern(dependency_pattern(_expressions,auxiliary,spc))
+    , _field(_expressions,auxiliary,spc)
+    , _fused(jacobian_results(_expressions,_pattern,auxiliary,spc),auxiliary,spc)
+{
+}
+
+size_t VectorField::workspace_size() const {
+    return std::max(_field.register_size(),_fused.register_size()+_fused.result_size());
+}
+
+void VectorField::sparse_jacobian(const double* x, double* f, double* values, double* w) const {
+    // The results are written after the registers, then split into the value and the Jacobian
+    size_t const n=this->dimension();
+    double* r=w+_fused.register_size();
+    _fused(x,r,w);
+    std::copy(r,r+n,f);
+    std::copy(r+n,r+_fused.result_size(),values);
+}
+
+void VectorField::jacobian(const double* x, double* f, double* df, double* w) const {
+    size_t const n=this->dimension();
+    double* r=w+_fused.register_size();
+    _fused(x,r,w);
+    std::copy(r,r+n,f);
+    std::fill(df,df+n*n,0.0);
+    double const* values=r+n;
+    for (size_t i=0; i!=n; ++i) {
+        for (auto j : _pattern.row(i)) { df[i*n+j]=*values++; }
+    }
+}
+
+Matrix<Real> VectorField::jacobian(Vector<Real> const& x) const {
+    HELPER_PRECONDITION(x.size()==this->dimension());
+    size_t const n=this->dimension();
+    std::vector<double> xa(n), fa(n), dfa(n*n), wa(this->workspace_size());
+    for (size_t i=0; i!=n; ++i) { xa[i]=x[i].value(); }
+    this->jacobian(xa.data(),fa.data(),dfa.data(),wa.data());
+    return Matrix<Real>(n,n,[&dfa,n](size_t i, size_t j){return Real(dfa[i*n+j]);});
+}
+
+ostream& operator<<(ostream& os, VectorField const& vf) {
+    os << "VectorField(";
+    for (size_t i=0; i!=vf.dimension(); ++i) { os << (i==0?"":", ") << "dot(" << vf.state_space().variable(i) << ")=" << vf._expressions[i]; }
+    return os << ")";
+}
+
+} // namespace SymboliCore
@@ -0,0 +1,107 @@
+/***************************************************************************
+ *            allocation_counter.cpp
+ *
+ *  Copyright  2023  Luca Geretti
+ *
+ ****************************************************************************/
+
+/*
+ * This file is part of SymboliCore, under the MIT license.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*! \file allocation_counter.cpp
+ *  \brief Replacement of the global allocation functions with malloc-backed counting ones
+ */
+
+#include <cstdlib>
+#include <new>
+
+#include "allocation_counter.hpp"
+
+// Every pointer handed out below comes from malloc (or the aligned variant), so the matching
+// free is correct; GCC cannot see this once the replacements are inlined into a caller
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+namespace SymboliCore {
+
+namespace {
+thread_local std::size_t _allocation_count=0u;
+thread_local std::size_t _allocated_bytes=0u;
+
+void* _allocate(std::size_t n) noexcept {
+    ++_allocation_count;
+    _allocated_bytes+=n;
+    return std::malloc(n>0u ? n : 1u);
+}
+
+void* _allocate(std::size_t n, std::align_val_t a) noexcept {
+    ++_allocation_count;
+    _allocated_bytes+=n;
+    auto const al=static_cast<std::size_t>(a);
+#if defined(_WIN32)
+    return _aligned_malloc(n>0u ? n : 1u,al);
+#else
+    // aligned_alloc requires a size that is a multiple of the alignment
+    return std::aligned_alloc(al,n>0u ? (n+al-1u)/al*al : al);
+#endif
+}
+
+void _deallocate(void* p) noexcept { std::free(p); }
+
+void _deallocate(void* p, std::align_val_t) noexcept {
+#if defined(_WIN32)
+    _aligned_free(p);
+#else
+    std::free(p);
+#endif
+}
+} // namespace
+
+std::size_t allocation_count() { return _allocation_count; }
+std::size_t allocated_bytes() { return _allocated_bytes; }
+
+} // namespace SymboliCore
+
+using SymboliCore::_allocate;
+using SymboliCore::_deallocate;
+
+void* operator new(std::size_t n) { if (void* p=_allocate(n)) { return p; } throw std::bad_alloc(); }
+void* operator new[](std::size_t n) { if (void* p=_allocate(n)) { return p; } throw std::bad_alloc(); }
+void* operator new(std::size_t n, std::nothrow_t const&) noexcept { return _allocate(n); }
+void* operator new[](std::size_t n, std::nothrow_t const&) noexcept { return _allocate(n); }
+void* operator new(std::size_t n, std::align_val_t a) { if (void* p=_allocate(n,a)) { return p; } throw std::bad_alloc(); }
+void* operator new[](std::size_t n, std::align_val_t a) { if (void* p=_allocate(n,a)) { return p; } throw std::bad_alloc(); }
+void* operator new(std::size_t n, std::align_val_t a, std::nothrow_t const&) noexcept { return _allocate(n,a); }
+void* operator new[](std::size_t n, std::align_val_t a, std::nothrow_t const&) noexcept { return _allocate(n,a); }
+
+void operator delete(void* p) noexcept { _deallocate(p); }
+void operator delete[](void* p) noexcept { _deallocate(p); }
+void operator delete(void* p, std::size_t) noexcept { _deallocate(p); }
+void operator delete[](void* p, std::size_t) noexcept { _deallocate(p); }
+void operator delete(void* p, std::nothrow_t const&) noexcept { _deallocate(p); }
+void operator delete[](void* p, std::nothrow_t const&) noexcept { _deallocate(p); }
+void operator delete(void* p, std::align_val_t a) noexcept { _deallocate(p,a); }
+void operator delete[](void* p, std::align_val_t a) noexcept { _deallocate(p,a); }
+void operator delete(void* p, std::size_t, std::align_val_t a) noexcept { _deallocate(p,a); }
+void operator delete[](void* p, std::size_t, std::align_val_t a) noexcept { _deallocate(p,a); }
+void operator delete(void* p, std::align_val_t a, std::nothrow_t const&) noexcept { _deallocate(p,a); }
+void operator delete[](void* p, std::align_val_t a, std::nothrow_t const&) noexcept { _deallocate(p,a); }
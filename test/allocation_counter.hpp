@@ -0,0 +1,50 @@
+/***************************************************************************
+ *            allocation_counter.hpp
+ *
+ *  Copyright  2023  Luca Geretti
+ *
+ ****************************************************************************/
+
+/*
+ * This file is part of SymboliCore, under the MIT license.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/*! \file allocation_counter.hpp
+ *  \brief Counting of the global allocations made by the calling thread, for tests and benchmarks
+ */
+
+#ifndef SYMBOLICORE_ALLOCATION_COUNTER_HPP
+#define SYMBOLICORE_ALLOCATION_COUNTER_HPP
+
+#include <cstddef>
+
+namespace SymboliCore {
+
+//! \brief The number of global operator new calls made so far by the calling thread
+//! \details Only available when allocation_counter.cpp is linked into the executable,
+//! since it replaces every form of the global allocation and deallocation functions.
+std::size_t allocation_count();
+
+//! \brief The number of bytes requested so far through global operator new by the calling thread
+std::size_t allocated_bytes();
+
+} // namespace SymboliCore
+
+#endif // SYMBOLICORE_ALLOCATION_COUNTER_HPP
@@ -0,0 +1,55 @@
+/***************************************************************************
+ *            indexed_name.hpp
+ *
+ *  Copyright  2023  Luca Geretti
+ *
+ ****************************************************************************/
+
+/*
+ * This file is part of SymboliCore, under the MIT license.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+/*! \file indexed_name.hpp
+ *  \brief Generation of indexed variable names for tests and benchmarks
+ */
+
+#ifndef SYMBOLICORE_INDEXED_NAME_HPP
+#define SYMBOLICORE_INDEXED_NAME_HPP
+
+#include <cstddef>
+#include <string>
+
+#include "helper/string.hpp"
+
+namespace SymboliCore {
+
+using Helper::String;
+
+//! \brief The name \a base followed by the indices \a i, \a is... separated by underscores, e.g. "v3_14"
+//! \details The name is built by appending to a copy of \a base, since concatenating a string literal
+//! with a std::string temporary trips a -Wrestrict false positive inside libstdc++ 12 at -O3.
+template<class... IS> String indexed_name(String base, std::size_t i, IS... is) {
+    base.append(std::to_string(i));
+    ((base.append("_").append(std::to_string(is))), ...);
+    return base;
+}
+
+} // namespace SymboliCore
+
+#endif // SYMBOLICORE_INDEXED_NAME_HPP
@@ -0,0 +1,120 @@
+/***************************************************************************
+ *            test_assignment.cpp
+ *
+ *  Copyright  2023  Luca Geretti
+ *
+ ****************************************************************************/
+
+/*
+ * This file is part of SymboliCore, under the MIT license.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "helper/test.hpp"
+#include "real.hpp"
+#include "vector.hpp"
+#include "expression.hpp"
+#include "assignment.hpp"
+#include "indexed_name.hpp"
+
+using namespace SymboliCore;
+using namespace Helper;
+
+class TestAssignment {
+    RealVariable x,y,u,v,w;
+  public:
+    TestAssignment() : x("x"), y("y"), u("u"), v("v"), w("w") { }
+
+    void test_algebraic_sort() {
+        List<RealAssignment> asg={let(w)=u+v, let(v)=u*y, let(u)=x+1};
+        List<RealAssignment> sorted=algebraic_sort(asg);
+        HELPER_TEST_PRINT(sorted);
+        HELPER_TEST_EQUALS(sorted.size(),3);
+        HELPER_TEST_EQUALS(sorted[0].lhs,u);
+        HELPER_TEST_EQUALS(sorted[1].lhs,v);
+        HELPER_TEST_EQUALS(sorted[2].lhs,w);
+
+        // A sorted list is left unchanged
+        List<RealAssignment> independent={let(w)=x*2, let(u)=y+1, let(v)=u*w};
+        List<RealAssignment> unchanged=algebraic_sort(independent);
+        for(size_t i=0; i!=independent.size(); ++i) { HELPER_TEST_EQUALS(unchanged[i].lhs,independent[i].lhs); }
+
+        HELPER_TEST_EQUALS(algebraic_sort(List<RealAssignment>()).size(),0);
+        try {
+            algebraic_sort({let(u)=x, let(u)=y});
+            HELPER_TEST_FAIL("Assigning a variable twice should fail.");
+        } catch (std::exception const&) { }
+    }
+
+    void test_algebraic_loops() {
+        RealVariable a("a"), b("b"), c("c");
+        List<RealAssignment> asg={let(a)=b+x, let(u)=a*2, let(b)=c*a, let(c)=exp(b), let(v)=v+1, let(w)=y};
+        List<List<RealVariable>> loops=algebraic_loops(asg);
+        HELPER_TEST_PRINT(loops);
+        HELPER_TEST_EQUALS(loops.size(),2);
+        HELPER_TEST_EQUALS(loops[0].size(),3);
+        HELPER_TEST_EQUALS(loops[1].size(),1);
+        HELPER_TEST_EQUALS(loops[1][0],v);
+        try {
+            algebraic_sort(asg);
+            HELPER_TEST_FAIL("Sorting assignments with algebraic loops should fail.");
+        } catch (std::runtime_error const& e) {
+            HELPER_TEST_PRINT(e.what());
+        }
+        HELPER_TEST_EQUALS(algebraic_loops({let(u)=x+1, let(v)=u}).size(),0);
+    }
+
+    void test_algebraic_levels() {
+        List<RealAssignment> asg={let(w)=u+v, let(v)=u*y, let(u)=x+1, let(RealVariable("z"))=y*y};
+        List<List<RealAssignment>> levels=algebraic_levels(asg);
+        HELPER_TEST_PRINT(levels);
+        HELPER_TEST_EQUALS(levels.size(),3);
+        HELPER_TEST_EQUALS(levels[0].size(),2);
+        HELPER_TEST_EQUALS(levels[1][0].lhs,v);
+        HELPER_TEST_EQUALS(levels[2][0].lhs,w);
+    }
+
+    void test_large() {
+        // A reversed chain of length n, which must be fully reordered
+        size_t n=100000;
+        List<RealVariable> vs;
+        for(size_t k=0; k!=n; ++k) { vs.push_back(RealVariable(indexed_name("v",k))); }
+        List<RealAssignment> asg;
+        for(size_t k=n-1; k!=0; --k) { asg.push_back(let(vs[k])=vs[k-1]+vs[k/2]); }
+        asg.push_back(let(vs[0])=RealExpression(x));
+        List<RealAssignment> sorted=algebraic_sort(asg);
+        HELPER_TEST_EQUALS(sorted.size(),n);
+        bool ordered=true;
+        for(size_t k=0; k!=n; ++k) { ordered = ordered && sorted[k].lhs==vs[k]; }
+        HELPER_TEST_ASSERT(ordered);
+        HELPER_TEST_EQUALS(algebraic_levels(asg).size(),n);
+    }
+
+    void test() {
+        HELPER_TEST_CALL(test_algebraic_sort());
+        HELPER_TEST_CALL(test_algebraic_loops());
+        HELPER_TEST_CALL(test_algebraic_levels());
+        HELPER_TEST_CALL(test_large());
+    }
+};
+
+int main() {
+    TestAssignment().test();
+    return HELPER_TEST_FAILURES;
+}
@@ -0,0 +1,158 @@
+/***************************************************************************
+ *            test_codegen.cpp
+ *
+ *  Copyright  2023  Luca Geretti
+ *
+ ****************************************************************************/
+
+/*
+ * This file is part of SymboliCore, under the MIT license.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <chrono>
+#include <filesystem>
+#include <thread>
+
+#include "helper/test.hpp"
+#include "helper/container.hpp"
+#include "helper/string.hpp"
+#include "real.hpp"
+#include "vector.hpp"
+#include "expression.hpp"
+#include "valuation.hpp"
+#include "space.hpp"
+#include "codegen.hpp"
+
+using namespace SymboliCore;
+using namespace Helper;
+
+class TestCodegen {
+    RealVariable x,y;
+    RealSpace spc;
+  public:
+    TestCodegen() : x("x"), y("y"), spc({x,y}) { }
+
+    void test_source() {
+        String src=c_source(x*y+sin(x),spc,"g");
+        HELPER_TEST_PRINT(src);
+        HELPER_TEST_ASSERT(src.find("void g(const double* x, double* y)")!=String::npos);
+        HELPER_TEST_ASSERT(src.find("x[0]*x[1]")!=String::npos);
+        HELPER_TEST_ASSERT(src.find("sin(x[0])")!=String::npos);
+        HELPER_TEST_ASSERT(src.find("y[0] = ")!=String::npos);
+    }
+
+    void test_common_subexpressions() {
+        RealExpression e1=sqr(x*y)+x*y;
+        RealExpression e2=exp(x*y);
+        String src=c_source(Vector<RealExpression>({e1,e2}),spc);
+        HELPER_TEST_PRINT(src);
+        size_t count=0;
+        for (size_t pos=src.find("x[0]*x[1]"); pos!=String::npos; pos=src.find("x[0]*x[1]",pos+1)) { ++count; }
+        HELPER_TEST_EQUALS(count,1);
+        HELPER_TEST_ASSERT(src.find("y[1] = ")!=String::npos);
+    }
+
+    void test_compile() {
+        Vector<RealExpression> e({x*y+sin(x),pow(x+y,3)-max(x,y)/2,exp(-sqr(y))*atan(x),RealExpression(y)});
+        CompiledFunction f=compile(e,spc);
+        HELPER_TEST_EQUALS(f.argument_size(),2);
+        HELPER_TEST_EQUALS(f.result_size(),4);
+
+        Valuation<Real> v({x|Real(0.75),y|Real(-1.25)});
+        Vector<Real> r=evaluate(f,v);
+        for (size_t i=0; i!=e.size(); ++i) {
+            HELPER_TEST_EQUALS(r[i],evaluate(e[i],v));
+        }
+
+        double xa[2]={0.75,-1.25}; double ya[4];
+        f(xa,ya);
+        HELPER_TEST_EQUALS(ya[3],-1.25);
+
+        CompiledFunction g=compile(e,spc);
+        HELPER_TEST_EQUALS(g(Vector<Real>({0.75,-1.25}))[0],r[0]);
+    }
+
+    void test_cache() {
+        namespace fs = std::filesystem;
+        CompilerSettings settings=CompilerSettings::default_settings();
+        fs::path directory=fs::temp_directory_path()/("symbolicore-codegen-test-"+to_string(std::chrono::system_clock::now().time_since_epoch().count()));
+        fs::remove_all(directory);
+        settings.cache_directory=directory.string();
+
+        RealExpression e=x*y+2, g=x-y;
+        CompiledFunction fe=compile(e,spc,settings);
+        List<fs::path> entries;
+        for (auto const& entry : fs::directory_iterator(directory)) { entries.push_back(entry.path()); }
+        HELPER_TEST_EQUALS(entries.size(),1u);
+        CompiledFunction fg=compile(g,spc,settings);
+        fs::path entry_e=entries[0], entry_g;
+        for (auto const& entry : fs::directory_iterator(directory)) { if (entry.path()!=entry_e) { entry_g=entry.path(); } }
+
+        // Replace the entry of e with the one of g, as if their hashes collided
+        fs::remove_all(entry_e);
+        fs::copy(entry_g,entry_e);
+        Vector<Real> v({3.0,5.0});
+        HELPER_TEST_EQUALS(compile(e,spc,settings)(v)[0],Real(17.0));
+        HELPER_TEST_EQUALS(compile(g,spc,settings)(v)[0],Real(-2.0));
+
+        // Concurrent compilations of the same source in one process
+        RealExpression h=x/y+1;
+        List<Real> results(4u,Real(0.0));
+        List<std::thread> threads;
+        for (size_t i=0; i!=results.size(); ++i) {
+            threads.push_back(std::thread([&,i](){ results[i]=compile(h,spc,settings)(v)[0]; }));
+        }
+        for (auto& t : threads) { t.join(); }
+        for (auto const& r : results) { HELPER_TEST_EQUALS(r,Real(1.6)); }
+
+        // Entries that other users can write are not trusted, even with the expected source;
+        // the source and the entry name of k are obtained from a compilation in another directory
+        RealExpression k=x*x-y;
+        CompilerSettings other_settings=settings;
+        other_settings.cache_directory=(directory/"other").string();
+        HELPER_TEST_EQUALS(compile(k,spc,other_settings)(v)[0],Real(4.0));
+        fs::path entry_k=fs::directory_iterator(other_settings.cache_directory)->path();
+        fs::path planted=directory/entry_k.filename();
+        fs::copy(entry_g,planted);
+        fs::copy_file(entry_k/"kernel.c",planted/"kernel.c",fs::copy_options::overwrite_existing);
+        fs::permissions(planted/"kernel.so",fs::perms::others_write,fs::perm_options::add);
+        HELPER_TEST_EQUALS(compile(k,spc,settings)(v)[0],Real(4.0));
+
+        fs::permissions(directory,fs::perms::others_write,fs::perm_options::add);
+        try {
+            compile(e,spc,settings);
+            HELPER_TEST_FAIL("Expected an exception for a cache directory writable by others");
+        } catch (std::runtime_error const&) { }
+
+        fs::remove_all(directory);
+    }
+
+    void test() {
+        HELPER_TEST_CALL(test_source());
+        HELPER_TEST_CALL(test_common_subexpressions());
+        HELPER_TEST_CALL(test_compile());
+        HELPER_TEST_CALL(test_cache());
+    }
+};
+
+int main() {
+    TestCodegen().test();
+    return HELPER_TEST_FAILURES;
+}
@@ -0,0 +1,127 @@
+/***************************************************************************
+ *            test_contractor.cpp
+ *
+ *  Copyright  2023  Luca Geretti
+ *
+ ****************************************************************************/
+
+/*
+ * This file is part of SymboliCore, under the MIT license.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <cmath>
+
+#include "helper/test.hpp"
+#include "helper/container.hpp"
+#include "real.hpp"
+#include "expression.hpp"
+#include "interval.hpp"
+#include "variables_box.hpp"
+#include "contractor.hpp"
+
+using namespace SymboliCore;
+using namespace Helper;
+
+class TestContractor {
+    RealVariable x,y,z;
+    RealVariablesBox bx;
+  public:
+    TestContractor() : x("x"), y("y"), z("z"),
+        bx({RealVariableInterval(-10.0,x,10.0),RealVariableInterval(-10.0,y,10.0),RealVariableInterval(-10.0,z,10.0)}) { }
+
+    void test_linear() {
+        Contractor c(x+y<=1 && x>=2 && y>=-3);
+        HELPER_TEST_EQUALS(c.number_of_constraints(),3);
+        RealVariablesBox r=c(bx);
+        HELPER_TEST_PRINT(r);
+        HELPER_TEST_EQUALS(r[x],RealInterval(Real(2.0),Real(4.0)));
+        HELPER_TEST_EQUALS(r[y],RealInterval(Real(-3.0),Real(-1.0)));
+        HELPER_TEST_EQUALS(r[z],bx[z]);
+    }
+
+    void test_nonlinear() {
+        RealVariablesBox r=contract(sqr(x)+sqr(y)<=1 && y>=x*2,bx);
+        HELPER_TEST_PRINT(r);
+        HELPER_TEST_ASSERT(subset(r[x],RealInterval(Real(-1.0),Real(1.0))));
+        HELPER_TEST_ASSERT(subset(r[y],RealInterval(Real(-2.0),Real(1.0))));
+        HELPER_TEST_ASSERT(r[x].contains(Real(0.0)) && r[y].contains(Real(0.5)));
+
+        RealVariablesBox s=contract(exp(x)<=1 && log(y)>=0 && sqrt(z)<=2,bx);
+        HELPER_TEST_PRINT(s);
+        HELPER_TEST_ASSERT(s[x].upper_bound().value()<=1e-12);
+        HELPER_TEST_ASSERT(s[y].lower_bound().value()>=1-1e-12);
+        HELPER_TEST_ASSERT(subset(s[z],RealInterval(Real(0.0),Real(4.0+1e-12))));
+
+        RealVariablesBox t=contract(x*y==6 && y/x>=1 && x>=1,bx);
+        HELPER_TEST_PRINT(t);
+        HELPER_TEST_ASSERT(t[y].lower_bound().value()>=0.6-1e-12);
+        HELPER_TEST_ASSERT(t[x].upper_bound().value()<=6+1e-12);
+    }
+
+    void test_trigonometric() {
+        RealVariablesBox b({RealVariableInterval(0.0,x,6.0),RealVariableInterval(-1.0,y,3.0)});
+        RealVariablesBox r=contract(sin(x)>=0.5 && cos(y)>=0.9,b);
+        HELPER_TEST_PRINT(r);
+        HELPER_TEST_ASSERT(subset(r[x],RealInterval(Real(0.52),Real(2.62))));
+        HELPER_TEST_ASSERT(r[x].contains(Real(std::asin(0.5)+1e-9)) && r[x].contains(Real(M_PI-std::asin(0.5)-1e-9)));
+        HELPER_TEST_ASSERT(subset(r[y],RealInterval(Real(-0.46),Real(0.46))));
+        RealVariablesBox s=contract(tan(x)>=10,b);
+        HELPER_TEST_PRINT(s);
+        HELPER_TEST_ASSERT(s[x].lower_bound().value()>=1.47);
+    }
+
+    void test_sharing_and_fixpoint() {
+        RealExpression w=x+y;
+        RealVariablesBox r=contract(w<=1 && w>=1 && x==y*2+z && z==0,bx);
+        HELPER_TEST_PRINT(r);
+        HELPER_TEST_ASSERT(width(r[x]).value()<1e-6);
+        HELPER_TEST_ASSERT(r[x].contains(Real(2.0/3)) || width(r[x]).value()<1e-6);
+        HELPER_TEST_ASSERT(subset(r[z],RealInterval(Real(0.0))));
+    }
+
+    void test_negation_and_sign() {
+        RealVariablesBox r=contract(!(x>1) && sgn(x+5) && !(y<=2) && !sgn(y-3),bx);
+        HELPER_TEST_PRINT(r);
+        HELPER_TEST_EQUALS(r[x],RealInterval(Real(-5.0),Real(1.0)));
+        HELPER_TEST_EQUALS(r[y],RealInterval(Real(2.0),Real(3.0)));
+    }
+
+    void test_infeasible() {
+        RealVariablesBox r=contract(sqr(x)<=-1,bx);
+        HELPER_TEST_PRINT(r);
+        HELPER_TEST_ASSERT(r.is_empty());
+        HELPER_TEST_ASSERT(contract(x+y>=30 || x<=0,bx)[x]==bx[x]);
+        HELPER_TEST_ASSERT(not contract(x+y<=1,bx).is_empty());
+    }
+
+    void test() {
+        HELPER_TEST_CALL(test_linear());
+        HELPER_TEST_CALL(test_nonlinear());
+        HELPER_TEST_CALL(test_trigonometric());
+        HELPER_TEST_CALL(test_sharing_and_fixpoint());
+        HELPER_TEST_CALL(test_negation_and_sign());
+        HELPER_TEST_CALL(test_infeasible());
+    }
+};
+
+int main() {
+    TestContractor().test();
+    return HELPER_TEST_FAILURES;
+}
@@ -0,0 +1,136 @@
+/***************************************************************************
+ *            test_dependency.cpp
+ *
+ *  Copyright  2023  Luca Geretti
+ *
+ ****************************************************************************/
+
+/*
+ * This file is part of SymboliCore, under the MIT license.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "helper/test.hpp"
+#include "real.hpp"
+#include "vector.hpp"
+#include "expression.hpp"
+#include "assignment.hpp"
+#include "space.hpp"
+#include "dependency.hpp"
+#include "indexed_name.hpp"
+
+using namespace SymboliCore;
+using namespace Helper;
+
+class TestDependency {
+    RealVariable x,y,z;
+    RealSpace spc;
+  public:
+    TestDependency() : x("x"), y("y"), z("z"), spc({x,y,z}) { }
+
+    void test_pattern() {
+        DependencyPattern p(4,{0,2,2,3},{1,3,0});
+        HELPER_TEST_PRINT(p);
+        HELPER_TEST_EQUALS(p.row_size(),3);
+        HELPER_TEST_EQUALS(p.column_size(),4);
+        HELPER_TEST_EQUALS(p.number_of_nonzeros(),3);
+        HELPER_TEST_ASSERT(p.get(0,3));
+        HELPER_TEST_ASSERT(not p.get(0,2));
+        HELPER_TEST_EQUALS(p.row(1).size(),0);
+        DependencyPattern pt=p.transpose();
+        HELPER_TEST_EQUALS(pt.row_size(),4);
+        HELPER_TEST_ASSERT(pt.get(3,0));
+        HELPER_TEST_ASSERT(pt.get(0,2));
+        HELPER_TEST_ASSERT(pt.transpose()==p);
+        try {
+            DependencyPattern q(2,{0,2},{1,0});
+            HELPER_TEST_FAIL("Unsorted columns should be rejected.");
+        } catch (std::exception const&) { }
+    }
+
+    void test_expressions() {
+        RealVariable w("w");
+        Vector<RealExpression> f({x*y,sin(z)+w,RealExpression(Real(2)),z*x-y});
+        DependencyPattern p=dependency_pattern(f,spc);
+        HELPER_TEST_PRINT(p);
+        HELPER_TEST_EQUALS(p,DependencyPattern(3,{0,2,3,3,6},{0,1,2,0,1,2}));
+    }
+
+    void test_assignments() {
+        RealVariable u("u"), v("v"), s("s");
+        // Deliberately not sorted
+        List<RealAssignment> asg={let(v)=u*z, let(u)=x+1, let(s)=Real(3)};
+        DependencyPattern p=dependency_pattern(asg,spc);
+        HELPER_TEST_PRINT(p);
+        HELPER_TEST_EQUALS(p,DependencyPattern(3,{0,2,3,3},{0,2,0}));
+
+        Vector<RealExpression> f({v+y,s*u});
+        DependencyPattern q=dependency_pattern(f,asg,spc);
+        HELPER_TEST_PRINT(q);
+        HELPER_TEST_EQUALS(q,DependencyPattern(3,{0,3,4},{0,1,2,0}));
+
+        List<RealAssignment> loop={let(u)=v+x, let(v)=u*2};
+        try {
+            dependency_pattern(loop,spc);
+            HELPER_TEST_FAIL("An algebraic loop should be detected.");
+        } catch (std::runtime_error const& e) {
+            HELPER_TEST_PRINT(e.what());
+        }
+    }
+
+    void test_large() {
+        // A tree of assignments u[k]=u[k/2]*x[k] over a large space, and outputs sampling the space
+        size_t n=100000;
+        List<RealVariable> xs, us;
+        for(size_t k=0; k!=n; ++k) { xs.push_back(RealVariable(indexed_name("x",k))); us.push_back(RealVariable(indexed_name("u",k))); }
+        RealSpace big(xs);
+        List<RealAssignment> asg;
+        asg.push_back(let(us[0])=RealExpression(xs[0]));
+        for(size_t k=n-1; k!=0; --k) { asg.push_back(let(us[k])=us[k/2]*xs[k]); }
+        Vector<RealExpression> f(n,[&](size_t k){return xs[k]+xs[(k*7919u)%n];});
+        DependencyPattern pf=dependency_pattern(f,big);
+        HELPER_TEST_EQUALS(pf.row_size(),n);
+        HELPER_TEST_EQUALS(pf.column_size(),n);
+        HELPER_TEST_ASSERT(pf.get(1,7919u));
+        HELPER_TEST_EQUALS(pf.transpose().number_of_nonzeros(),pf.number_of_nonzeros());
+
+        List<RealAssignment> chain;
+        chain.push_back(let(us[0])=RealExpression(xs[0]));
+        for(size_t k=1; k!=100; ++k) { chain.push_back(let(us[k])=us[k-1]+xs[k]); }
+        DependencyPattern pc=dependency_pattern(chain,big);
+        HELPER_TEST_EQUALS(pc.row(99).size(),100);
+        DependencyPattern pa=dependency_pattern(asg,big);
+        HELPER_TEST_EQUALS(pa.row_size(),n);
+        // u[6] depends on x[6], x[3], x[1] and x[0]
+        HELPER_TEST_EQUALS(pa.row(n-6).size(),4);
+        HELPER_TEST_ASSERT(pa.get(n-6,3));
+    }
+
+    void test() {
+        HELPER_TEST_CALL(test_pattern());
+        HELPER_TEST_CALL(test_expressions());
+        HELPER_TEST_CALL(test_assignments());
+        HELPER_TEST_CALL(test_large());
+    }
+};
+
+int main() {
+    TestDependency().test();
+    return HELPER_TEST_FAILURES;
+}
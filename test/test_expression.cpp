@@ -26,6 +26,8 @@
  * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
 
+#include <thread>
+
 #include "helper/test.hpp"
 #include "helper/container.hpp"
 #include "helper/string.hpp"
@@ -35,6 +37,8 @@
 #include "assignment.hpp"
 #include "valuation.hpp"
 #include "space.hpp"
+#include "allocation_counter.hpp"
+#include "indexed_name.hpp"
 
 using namespace SymboliCore;
 using namespace Helper;
@@ -291,6 +295,100 @@ class TestExpression {
         HELPER_TEST_ASSERT(identical(substitution,-(u1+1)*x*y+2*pow(x+u1*x,2)));
     }
 
+    void test_check() {
+        Valuation<Real> v({x|Real(0.5),y|Real(-2.0),z|Real(0.0)});
+        RealSpace spc({x,y,z});
+        Vector<Real> vx({0.5,-2.0,0.0});
+        List<KleeneanExpression> ps={x<=y, x>y && sqr(x)+y<0, !(x==0.5) || y>=-2, sgn(z), sgn(x*y), sgn(x),
+                                     (x<1) && (y<1) && !(z!=0), KleeneanExpression(Kleenean(true)) && pow(x,3)/y>=max(x,z)};
+        for (auto const& p : ps) {
+            LogicalValue lv=check(p,v);
+            LogicalValue elv=static_cast<LogicalValue>(evaluate(p,v).check(Effort::get_default()));
+            HELPER_TEST_EQUALS(static_cast<int>(lv),static_cast<int>(elv));
+            HELPER_TEST_EQUALS(static_cast<int>(check(p,vx,spc)),static_cast<int>(lv));
+        }
+
+        size_t count=allocation_count();
+        for (auto const& p : ps) { check(p,v); check(p,vx,spc); }
+        HELPER_TEST_EQUALS(allocation_count(),count);
+    }
+
+    void test_valuation_view() {
+        RealSpace spc({x,y,z});
+        Valuation<Real> v({x|Real(0.5),y|Real(-2.0),z|Real(0.25)});
+        double raw[3]={0.5,-2.0,0.25};
+        Vector<Real> vx({0.5,-2.0,0.25});
+        ValuationView<Real,double> rview(raw,3,spc);
+        ValuationView<Real> view(std::span<const Real>(vx.data(),vx.size()),spc);
+        HELPER_TEST_PRINT(view);
+        HELPER_TEST_EQUALS(view[y],Real(-2.0));
+        HELPER_TEST_EQUALS(rview.get(z),0.25);
+        HELPER_TEST_ASSERT(not view.has_key(RealVariable("w")));
+
+        List<RealExpression> es={x*y+sin(z),pow(x+y,3)-max(x,z)/2,exp(-sqr(y))*atan(x)+1,RealExpression(z)};
+        for (auto const& e : es) {
+            Real r=evaluate(e,v);
+            HELPER_TEST_EQUALS(evaluate(e,view),r);
+            HELPER_TEST_EQUALS(evaluate(e,rview),r);
+        }
+        KleeneanExpression p=x>y && sqr(x)+y<0;
+        HELPER_TEST_EQUALS(static_cast<int>(check(p,view)),static_cast<int>(check(p,v)));
+
+        // The buffer is viewed, not copied
+        raw[0]=1.5;
+        HELPER_TEST_EQUALS(evaluate(x*y,rview),Real(-3.0));
+
+        size_t count=allocation_count();
+        for (auto const& e : es) { evaluate(e,view); evaluate(e,rview); }
+        HELPER_TEST_EQUALS(allocation_count(),count);
+
+        try {
+            ValuationView<Real,double> bad(raw,2,spc);
+            HELPER_TEST_FAIL("Viewing a buffer of the wrong size should fail.");
+        } catch (std::exception const&) { }
+    }
+
+    void test_arguments() {
+        RealExpression e=x*y+sin(x);
+        HELPER_TEST_EQUALS(e.argument_set().size(),2);
+        HELPER_TEST_EQUALS(arguments(e),(Set<Identifier>{"x","y"}));
+        HELPER_TEST_ASSERT(depends_on(e,x));
+        HELPER_TEST_ASSERT(not depends_on(e,z));
+        HELPER_TEST_ASSERT(not depends_on(e,RealVariable("w")));
+        HELPER_TEST_ASSERT(not depends_on(RealExpression(x),Variable<Integer>("x")));
+        HELPER_TEST_ASSERT(depends_on(e,Set<RealVariable>{z,y}));
+        HELPER_TEST_ASSERT(not depends_on(RealExpression(Real(2)),Set<RealVariable>{x}));
+
+        KleeneanExpression p=x<=z;
+        HELPER_TEST_EQUALS(p.arguments().size(),2);
+
+        // A node with the same arguments as a child shares them
+        RealExpression f=e*2;
+        HELPER_TEST_ASSERT(f.argument_set().begin()==e.argument_set().begin());
+
+        // Arguments are cached in the nodes, so queries on a deep shared DAG take no time
+        RealExpression g=x+z;
+        for (size_t i=0; i!=200; ++i) { g=g*g+y; }
+        HELPER_TEST_EQUALS(g.arguments().size(),3);
+        HELPER_TEST_ASSERT(not is_constant_in(g,{x}));
+        HELPER_TEST_ASSERT(is_constant_in(g,{RealVariable("w")}));
+        HELPER_TEST_ASSERT(identical(substitute(g,RealVariable("w"),Real(1)),g));
+
+        // Queries and the interning of new variables may run concurrently
+        List<size_t> failures(4u,0u);
+        List<std::thread> threads;
+        for (size_t t=0; t!=failures.size(); ++t) {
+            threads.push_back(std::thread([&,t](){
+                for (size_t i=0; i!=1000; ++i) {
+                    RealVariable v(indexed_name("v",t,i%50));
+                    if (not depends_on(g,x) or depends_on(g,v) or not depends_on(g+v,v)) { ++failures[t]; }
+                }
+            }));
+        }
+        for (auto& thread : threads) { thread.join(); }
+        for (auto count : failures) { HELPER_TEST_EQUALS(count,0u); }
+    }
+
     void test_is_constant_in() {
         Real c(3);
         HELPER_TEST_ASSERT(is_constant_in(3*y,{x}));
@@ -399,6 +497,9 @@ class TestExpression {
         HELPER_TEST_CALL(test_count_distinct_node_pointers());
         HELPER_TEST_CALL(test_eliminate_common_subexpressions());
         HELPER_TEST_CALL(test_substitute());
+        HELPER_TEST_CALL(test_check());
+        HELPER_TEST_CALL(test_valuation_view());
+        HELPER_TEST_CALL(test_arguments());
         HELPER_TEST_CALL(test_is_constant_in());
         HELPER_TEST_CALL(test_is_additive_in());
         HELPER_TEST_CALL(test_is_affine_in());
@@ -26,6 +26,8 @@
  * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
 
+#include <limits>
+
 #include "helper/test.hpp"
 #include "helper/string.hpp"
 #include "integer.hpp"
@@ -45,6 +47,7 @@ class TestInteger
     void test_constructors();
     void test_arithmetic();
     void test_comparisons();
+    void test_arbitrary_precision();
 };
 
 void TestInteger::test()
@@ -53,6 +56,7 @@ void TestInteger::test()
     HELPER_TEST_CALL(test_comparisons());
     HELPER_TEST_CALL(test_literal());
     HELPER_TEST_CALL(test_arithmetic());
+    HELPER_TEST_CALL(test_arbitrary_precision());
 }
 
 
@@ -146,6 +150,72 @@ void TestInteger::test_comparisons() {
     HELPER_TEST_COMPARE(Integer(2),> ,Integer(-3));
 }
 
+void TestInteger::test_arbitrary_precision() {
+    Integer lmax(std::numeric_limits<long int>::max());
+    Integer lmin(std::numeric_limits<long int>::min());
+    HELPER_TEST_EQUALS((lmax+1).literal(),"9223372036854775808");
+    HELPER_TEST_EQUALS((lmin-1).literal(),"-9223372036854775809");
+    HELPER_TEST_EQUALS(neg(lmin).literal(),"9223372036854775808");
+    HELPER_TEST_EQUALS(abs(lmin),lmax+1);
+    HELPER_TEST_EQUALS(lmax+1-1,lmax);
+    HELPER_TEST_EQUALS((lmax+1).get<unsigned long int>(),9223372036854775808ul);
+    bool not_representable=false;
+    try { (lmax+1).get<long int>(); } catch (std::runtime_error const&) { not_representable=true; }
+    HELPER_TEST_ASSERT(not_representable);
+    HELPER_TEST_EQUALS(Integer(18446744073709551615ul).get<unsigned long long int>(),18446744073709551615ull);
+    try {
+        pow(Integer(2),64u).get<unsigned long int>();
+        HELPER_TEST_FAIL("Expected an exception for a value with more than one limb");
+    } catch (std::runtime_error const&) { }
+    try {
+        (lmax+1).value();
+        HELPER_TEST_FAIL("Expected an exception for a value not fitting in a long int");
+    } catch (std::runtime_error const&) { }
+    HELPER_TEST_EQUALS(Integer(18446744073709551615ul).literal(),"18446744073709551615");
+    HELPER_TEST_EQUALS(lmax.value(),std::numeric_limits<long int>::max());
+
+    HELPER_TEST_EQUALS(pow(Integer(2),64u).literal(),"18446744073709551616");
+    HELPER_TEST_EQUALS(pow(Integer(-3),41u).literal(),"-36472996377170786403");
+    HELPER_TEST_EQUALS(pow(Integer(10),40u),Integer("10000000000000000000000000000000000000000"));
+    HELPER_TEST_EQUALS(pow(Integer(7),0u),1);
+    HELPER_TEST_EQUALS(pow(Integer(-2),63u),lmin);
+
+    Integer z("-123456789012345678901234567890");
+    HELPER_TEST_EQUALS(z.literal(),"-123456789012345678901234567890");
+    HELPER_TEST_EQUALS(z*z,Integer("15241578753238836750495351562536198787501905199875019052100"));
+    HELPER_TEST_EQUALS(z*z/z,z);
+    HELPER_TEST_EQUALS(quot(z,Integer(1000000007)),Integer("-123456788148148161864"));
+    HELPER_TEST_EQUALS(rem(z,Integer(1000000007)),Integer(-197434842));
+    HELPER_TEST_EQUALS(quot(z*z+1,z),z);
+    HELPER_TEST_EQUALS(rem(z*z+1,z),1);
+    HELPER_TEST_EQUALS(quot(lmin,Integer(-1)),lmax+1);
+    HELPER_TEST_EQUALS(rem(lmin,Integer(-1)),0);
+    HELPER_TEST_EQUALS(z-z,0);
+    HELPER_TEST_ASSERT(is_zero(z+neg(z)));
+    HELPER_TEST_EQUALS(sgn(z),Sign::NEGATIVE);
+    HELPER_TEST_EQUALS(sgn(z*z),Sign::POSITIVE);
+    HELPER_TEST_WITHIN(z.get_d(),-1.2345678901234568e29,1e14);
+
+    HELPER_TEST_COMPARE(z,<,lmin);
+    HELPER_TEST_COMPARE(lmax,<,z*z);
+    HELPER_TEST_COMPARE(z*z,>,z*z-1);
+    HELPER_TEST_COMPARE(z,<=,z);
+    HELPER_TEST_EQUALS(max(z,lmin),lmin);
+    HELPER_TEST_EQUALS(min(z*z,lmax),lmax);
+
+    Integer a(lmax), b(a);
+    a*=a; b=a; ++b; --b;
+    HELPER_TEST_EQUALS(b,a);
+    HELPER_TEST_EQUALS(sqr(lmax),a);
+    b+=lmin; b-=lmin;
+    HELPER_TEST_EQUALS(b,a);
+    Integer moved(std::move(b));
+    HELPER_TEST_EQUALS(moved,a);
+    bool thrown=false;
+    try { a.value(); } catch (std::runtime_error const&) { thrown=true; }
+    HELPER_TEST_ASSERT(thrown);
+}
+
 int main() {
     HELPER_TEST_CLASS(Integer,TestInteger());
 
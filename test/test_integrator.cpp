@@ -0,0 +1,172 @@
+/***************************************************************************
+ *            test_integrator.cpp
+ *
+ *  Copyright  2023  Luca Geretti
+ *
+ ****************************************************************************/
+
+/*
+ * This file is part of SymboliCore, under the MIT license.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <cmath>
+
+#include "helper/test.hpp"
+#include "real.hpp"
+#include "vector.hpp"
+#include "expression.hpp"
+#include "assignment.hpp"
+#include "space.hpp"
+#include "integrator.hpp"
+
+using namespace SymboliCore;
+using namespace Helper;
+
+class TestIntegrator {
+    RealVariable x,y;
+    RealSpace spc;
+    DottedRealAssignments harmonic;
+  public:
+    TestIntegrator() : x("x"), y("y"), spc({x,y}), harmonic({dot(x)=y, dot(y)=-x}) { }
+
+    void test_runge_kutta_4() {
+        RungeKutta4Integrator rk4(harmonic,spc);
+        double xa[2]={1.0,0.0};
+        rk4.integrate(xa,0.0,1.0,0.01);
+        HELPER_TEST_PRINT(rk4.statistics());
+        HELPER_TEST_ASSERT(std::abs(xa[0]-std::cos(1.0))<1e-9);
+        HELPER_TEST_ASSERT(std::abs(xa[1]+std::sin(1.0))<1e-9);
+        HELPER_TEST_EQUALS(rk4.statistics().accepted_steps,100);
+        HELPER_TEST_EQUALS(rk4.statistics().function_evaluations,400);
+
+        // The order of the method is four
+        RungeKutta4Integrator coarse(harmonic,spc);
+        Vector<Real> r1=coarse.integrate(Vector<Real>({Real(1.0),Real(0.0)}),0.0,1.0,0.1);
+        Vector<Real> r2=coarse.integrate(Vector<Real>({Real(1.0),Real(0.0)}),0.0,1.0,0.05);
+        double const ratio=std::abs(r1[0].value()-std::cos(1.0))/std::abs(r2[0].value()-std::cos(1.0));
+        HELPER_TEST_PRINT(ratio);
+        HELPER_TEST_ASSERT(ratio>12 && ratio<20);
+    }
+
+    void test_runge_kutta_4_batch() {
+        RungeKutta4Integrator rk4(harmonic,spc);
+        size_t const n=100;
+        std::vector<double> xs(2*n), expected(2*n);
+        for (size_t i=0; i!=n; ++i) { xs[2*i]=0.1*static_cast<double>(i); xs[2*i+1]=1.0; }
+        for (size_t i=0; i!=n; ++i) {
+            expected[2*i]=xs[2*i]; expected[2*i+1]=xs[2*i+1];
+            rk4.integrate(expected.data()+2*i,0.0,2.0,0.05);
+        }
+        rk4.reset_statistics();
+        rk4.integrate(n,xs.data(),0.0,2.0,0.05);
+        HELPER_TEST_ASSERT(xs==expected);
+        HELPER_TEST_EQUALS(rk4.statistics().function_evaluations,160);
+    }
+
+    void test_dormand_prince() {
+        IntegratorSettings settings=IntegratorSettings::default_settings();
+        settings.relative_tolerance=1e-10;
+        settings.absolute_tolerance=1e-12;
+        DormandPrinceIntegrator dp(harmonic,spc,settings);
+        size_t observed=0;
+        double xa[2]={1.0,0.0};
+        dp.integrate(xa,0.0,10.0,[&observed](StepStatistics const& s){ ++observed; HELPER_TEST_ASSERT(s.step_size>0.0); });
+        HELPER_TEST_PRINT(dp.statistics());
+        HELPER_TEST_ASSERT(std::abs(xa[0]-std::cos(10.0))<1e-8);
+        HELPER_TEST_ASSERT(std::abs(xa[1]+std::sin(10.0))<1e-8);
+        IntegrationStatistics const& stats=dp.statistics();
+        HELPER_TEST_EQUALS(observed,stats.accepted_steps+stats.rejected_steps);
+        // Six evaluations per step thanks to the reuse of the last stage, and two for the initial step size
+        HELPER_TEST_EQUALS(stats.function_evaluations,6*(stats.accepted_steps+stats.rejected_steps)+2);
+
+        Vector<Real> r=dp.integrate(Vector<Real>({Real(0.0),Real(1.0)}),0.0,1.0);
+        HELPER_TEST_ASSERT(std::abs(r[0].value()-std::sin(1.0))<1e-8);
+    }
+
+    void test_dense_output() {
+        DormandPrinceIntegrator dp(harmonic,spc);
+        double xa[2]={1.0,0.0};
+        List<double> times={0.0,0.25,0.5,1.0,1.75,3.0};
+        std::vector<double> ya(2*times.size());
+        dp.integrate(xa,0.0,times,ya.data());
+        for (size_t k=0; k!=times.size(); ++k) {
+            HELPER_TEST_ASSERT(std::abs(ya[2*k]-std::cos(times[k]))<1e-5);
+            HELPER_TEST_ASSERT(std::abs(ya[2*k+1]+std::sin(times[k]))<1e-5);
+        }
+        HELPER_TEST_EQUALS(xa[0],ya[2*times.size()-2]);
+
+        double t=dp.dense_output_begin()/2+dp.dense_output_end()/2;
+        double yd[2];
+        dp.dense_output(t,yd);
+        HELPER_TEST_ASSERT(std::abs(yd[0]-std::cos(t))<1e-5);
+    }
+
+    void test_dormand_prince_batch() {
+        DormandPrinceIntegrator dp(harmonic,spc);
+        size_t const n=70;
+        std::vector<double> xs(2*n);
+        for (size_t i=0; i!=n; ++i) { xs[2*i]=std::cos(0.1*static_cast<double>(i)); xs[2*i+1]=-std::sin(0.1*static_cast<double>(i)); }
+        dp.integrate(n,xs.data(),0.0,2.0);
+        HELPER_TEST_PRINT(dp.statistics());
+        for (size_t i=0; i!=n; ++i) {
+            double const s=0.1*static_cast<double>(i)+2.0;
+            HELPER_TEST_ASSERT(std::abs(xs[2*i]-std::cos(s))<1e-5);
+            HELPER_TEST_ASSERT(std::abs(xs[2*i+1]+std::sin(s))<1e-5);
+        }
+    }
+
+    void test_step_control() {
+        // A stiff-ish component forces rejections when starting from a large step
+        IntegratorSettings settings=IntegratorSettings::default_settings();
+        settings.initial_step_size=1.0;
+        DormandPrinceIntegrator dp({dot(x)=-Real(50.0)*(x-cos(y)), dot(y)=Real(1.0)},spc,settings);
+        double xa[2]={0.0,0.0};
+        double t=0.0, h=1.0;
+        StepStatistics s=dp.step(t,xa,h);
+        HELPER_TEST_PRINT(s);
+        HELPER_TEST_ASSERT(not s.accepted);
+        HELPER_TEST_EQUALS(t,0.0);
+        HELPER_TEST_ASSERT(h<1.0);
+        dp.integrate(xa,0.0,1.0);
+        HELPER_TEST_ASSERT(dp.statistics().rejected_steps>=1);
+
+        settings.maximum_steps=3;
+        DormandPrinceIntegrator limited(harmonic,spc,settings);
+        try {
+            double xb[2]={1.0,0.0};
+            limited.integrate(xb,0.0,100.0);
+            HELPER_TEST_FAIL("Exceeding the maximum number of steps should fail.");
+        } catch (std::runtime_error const&) { }
+    }
+
+    void test() {
+        HELPER_TEST_CALL(test_runge_kutta_4());
+        HELPER_TEST_CALL(test_runge_kutta_4_batch());
+        HELPER_TEST_CALL(test_dormand_prince());
+        HELPER_TEST_CALL(test_dense_output());
+        HELPER_TEST_CALL(test_dormand_prince_batch());
+        HELPER_TEST_CALL(test_step_control());
+    }
+};
+
+int main() {
+    TestIntegrator().test();
+    return HELPER_TEST_FAILURES;
+}
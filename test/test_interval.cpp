@@ -0,0 +1,191 @@
+/***************************************************************************
+ *            test_interval.cpp
+ *
+ *  Copyright  2023  Luca Geretti
+ *
+ ****************************************************************************/
+
+/*
+ * This file is part of SymboliCore, under the MIT license.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <cmath>
+#include <limits>
+
+#include "helper/test.hpp"
+#include "helper/container.hpp"
+#include "real.hpp"
+#include "expression.hpp"
+#include "valuation.hpp"
+#include "interval.hpp"
+#include "variables_box.hpp"
+
+using namespace SymboliCore;
+using namespace Helper;
+
+class TestInterval {
+    RealVariable x,y;
+  public:
+    TestInterval() : x("x"), y("y") { }
+
+    void test_construction() {
+        RealInterval ivl(Real(-1.0),Real(2.0));
+        HELPER_TEST_PRINT(ivl);
+        HELPER_TEST_EQUALS(ivl.lower_bound(),-1.0);
+        HELPER_TEST_EQUALS(ivl.upper_bound(),2.0);
+        HELPER_TEST_ASSERT(ivl.contains(Real(0.5)));
+        HELPER_TEST_ASSERT(not ivl.contains(Real(2.5)));
+        HELPER_TEST_ASSERT(not ivl.is_empty());
+        HELPER_TEST_ASSERT(RealInterval(Real(1.0),Real(0.0)).is_empty());
+        HELPER_TEST_ASSERT(RealInterval(Real(3.0)).is_singleton());
+        HELPER_TEST_EQUALS(width(ivl),3.0);
+        HELPER_TEST_EQUALS(midpoint(ivl),0.5);
+        HELPER_TEST_EQUALS(hull(ivl,RealInterval(Real(4.0))),RealInterval(Real(-1.0),Real(4.0)));
+        HELPER_TEST_ASSERT(intersection(ivl,RealInterval(Real(3.0),Real(4.0))).is_empty());
+        HELPER_TEST_ASSERT(subset(RealInterval(Real(0.0),Real(1.0)),ivl));
+    }
+
+    void test_exact_arithmetic() {
+        RealInterval a(Real(1.0),Real(2.0)), b(Real(-3.0),Real(0.5));
+        HELPER_TEST_EQUALS(a+b,RealInterval(Real(-2.0),Real(2.5)));
+        HELPER_TEST_EQUALS(a-b,RealInterval(Real(0.5),Real(5.0)));
+        HELPER_TEST_EQUALS(a*b,RealInterval(Real(-6.0),Real(1.0)));
+        HELPER_TEST_EQUALS(b/a,RealInterval(Real(-3.0),Real(0.5)));
+        HELPER_TEST_EQUALS(sqr(b),RealInterval(Real(0.0),Real(9.0)));
+        HELPER_TEST_EQUALS(pow(b,3),RealInterval(Real(-27.0),Real(0.125)));
+        HELPER_TEST_EQUALS(pow(b,2),sqr(b));
+        HELPER_TEST_EQUALS(abs(b),RealInterval(Real(0.0),Real(3.0)));
+        HELPER_TEST_EQUALS(max(a,b),RealInterval(Real(1.0),Real(2.0)));
+        HELPER_TEST_EQUALS(sqrt(RealInterval(Real(4.0),Real(9.0))),RealInterval(Real(2.0),Real(3.0)));
+        HELPER_TEST_EQUALS(rec(b).lower_bound(),-std::numeric_limits<double>::infinity());
+        HELPER_TEST_ASSERT(sqrt(RealInterval(Real(-2.0),Real(-1.0))).is_empty());
+    }
+
+    void test_outward_rounding() {
+        RealInterval tenth=RealInterval(Real(1.0))/RealInterval(Real(10.0));
+        HELPER_TEST_PRINT(tenth);
+        HELPER_TEST_ASSERT(tenth.lower_bound().value()<tenth.upper_bound().value());
+        HELPER_TEST_ASSERT(tenth.contains(Real(0.1)));
+        RealInterval third=RealInterval(Real(1.0))/RealInterval(Real(3.0));
+        RealInterval one=third*RealInterval(Real(3.0));
+        HELPER_TEST_ASSERT(one.contains(Real(1.0)));
+        RealInterval s=RealInterval(Real(0.1))+RealInterval(Real(0.2));
+        HELPER_TEST_ASSERT(s.lower_bound().value()<=0.1+0.2 && 0.1+0.2<=s.upper_bound().value());
+        RealInterval r=sqrt(RealInterval(Real(2.0)));
+        HELPER_TEST_ASSERT(r.lower_bound().value()<r.upper_bound().value());
+        HELPER_TEST_ASSERT(sqr(r).contains(Real(2.0)));
+    }
+
+    void test_transcendental() {
+        RealInterval e=exp(RealInterval(Real(1.0)));
+        HELPER_TEST_ASSERT(e.contains(Real(std::exp(1.0))));
+        HELPER_TEST_EQUALS(exp(RealInterval(Real(0.0))),RealInterval(Real(1.0)));
+        HELPER_TEST_ASSERT(log(e).contains(Real(1.0)));
+        RealInterval s=sin(RealInterval(Real(0.0),Real(3.0)));
+        HELPER_TEST_PRINT(s);
+        HELPER_TEST_EQUALS(s.upper_bound(),1.0);
+        HELPER_TEST_ASSERT(s.lower_bound().value()<=0.0);
+        RealInterval c=cos(RealInterval(Real(1.0),Real(2.0)));
+        HELPER_TEST_ASSERT(c.contains(Real(std::cos(1.5))));
+        HELPER_TEST_ASSERT(c.upper_bound().value()<1.0 && c.lower_bound().value()>-1.0);
+        HELPER_TEST_EQUALS(cos(RealInterval(Real(3.0),Real(3.5))).lower_bound(),-1.0);
+        RealInterval t=tan(RealInterval(Real(1.0),Real(2.0)));
+        HELPER_TEST_EQUALS(t.upper_bound(),std::numeric_limits<double>::infinity());
+        HELPER_TEST_ASSERT(atan(RealInterval(Real(1.0))).contains(Real(std::atan(1.0))));
+        HELPER_TEST_ASSERT(acos(RealInterval(Real(-2.0),Real(2.0))).lower_bound().value()>=0.0);
+    }
+
+    void test_comparison() {
+        RealInterval a(Real(1.0),Real(2.0)), b(Real(2.0),Real(3.0)), c(Real(2.5),Real(4.0));
+        HELPER_TEST_ASSERT(definitely(leq(a,b)));
+        HELPER_TEST_ASSERT(not definitely(lt(a,b)) and possibly(lt(a,b)));
+        HELPER_TEST_ASSERT(definitely(lt(a,c)));
+        HELPER_TEST_ASSERT(definitely(not eq(a,c)));
+        HELPER_TEST_ASSERT(definitely(eq(RealInterval(Real(2.0)),RealInterval(Real(2.0)))));
+        HELPER_TEST_ASSERT(definitely(sgn(a)));
+        HELPER_TEST_ASSERT(is_indeterminate(sgn(RealInterval(Real(0.0)))));
+    }
+
+    void test_variables_box() {
+        RealVariablesBox bx({RealVariableInterval(-1.0,x,2.0),RealVariableLowerInterval(0.5,y)<=Real(1.5)});
+        HELPER_TEST_PRINT(bx);
+        HELPER_TEST_EQUALS(bx.dimension(),2);
+        HELPER_TEST_ASSERT(bx.has_variable(x));
+        HELPER_TEST_EQUALS(bx[y],RealInterval(Real(0.5),Real(1.5)));
+        HELPER_TEST_EQUALS(bx.variables().size(),2);
+    }
+
+    void test_evaluate() {
+        RealVariablesBox bx({RealVariableInterval(-1.0,x,2.0),RealVariableInterval(0.5,y,1.5)});
+        RealInterval r=evaluate(x*y+sqr(x),bx);
+        HELPER_TEST_PRINT(r);
+        HELPER_TEST_EQUALS(r,RealInterval(Real(-1.5),Real(7.0)));
+
+        RealExpression e=exp(-sqr(x))*sin(y)+pow(x-y,3)/2;
+        RealInterval re=evaluate(e,bx);
+        HELPER_TEST_PRINT(re);
+        for (double xv : {-1.0,-0.25,0.5,2.0}) {
+            for (double yv : {0.5,1.0,1.5}) {
+                Valuation<Real> v({x|Real(xv),y|Real(yv)});
+                HELPER_TEST_ASSERT(re.contains(evaluate(e,v)));
+            }
+        }
+
+        HELPER_TEST_ASSERT(definitely(evaluate(y>0,bx)));
+        HELPER_TEST_ASSERT(definitely(not evaluate(x>=3,bx)));
+        HELPER_TEST_ASSERT(is_indeterminate(evaluate(x<=0,bx)));
+        HELPER_TEST_ASSERT(definitely(evaluate(y>0 && x<=y*3+1,bx)));
+        HELPER_TEST_ASSERT(definitely(evaluate(sgn(y+x*0+1),bx)));
+        HELPER_TEST_ASSERT(definitely(evaluate(!(x>y+1) || y<=2,bx)));
+    }
+
+    void test_evaluate_batch() {
+        RealExpression e=x*x-y;
+        List<RealVariablesBox> bxs;
+        for (size_t i=0; i!=8; ++i) {
+            double l=-1.0+0.25*static_cast<double>(i);
+            bxs.push_back(RealVariablesBox({RealVariableInterval(l,x,l+0.25),RealVariableInterval(0.0,y,0.125)}));
+        }
+        List<RealInterval> rs=evaluate(e,bxs);
+        HELPER_TEST_EQUALS(rs.size(),bxs.size());
+        for (size_t i=0; i!=bxs.size(); ++i) {
+            HELPER_TEST_EQUALS(rs[i],evaluate(e,bxs[i]));
+        }
+        List<ValidatedKleenean> ps=evaluate(e>=0,bxs);
+        HELPER_TEST_ASSERT(definitely(ps[0]));
+        HELPER_TEST_ASSERT(is_indeterminate(ps[4]));
+    }
+
+    void test() {
+        HELPER_TEST_CALL(test_construction());
+        HELPER_TEST_CALL(test_exact_arithmetic());
+        HELPER_TEST_CALL(test_outward_rounding());
+        HELPER_TEST_CALL(test_transcendental());
+        HELPER_TEST_CALL(test_comparison());
+        HELPER_TEST_CALL(test_variables_box());
+        HELPER_TEST_CALL(test_evaluate());
+        HELPER_TEST_CALL(test_evaluate_batch());
+    }
+};
+
+int main() {
+    TestInterval().test();
+    return HELPER_TEST_FAILURES;
+}
@@ -26,14 +26,41 @@
  * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
 
+#include <chrono>
+
 #include "helper/test.hpp"
 #include "helper/macros.hpp"
 #include "logical.hpp"
 #include "sequence.hpp"
+#include "allocation_counter.hpp"
 
 using namespace SymboliCore;
 using namespace Helper;
 
+//! \brief A lazy logical value becoming true at effort 3, counting how often it is checked.
+class CountingLogical : public LogicalInterface {
+    size_t& _count;
+  public:
+    CountingLogical(size_t& count) : _count(count) { }
+    LogicalInterface* clone() const { return new CountingLogical(*this); }
+    LogicalValue _check(Effort eff) const { ++_count; return eff.work()>=3u ? LogicalValue::TRUE : LogicalValue::INDETERMINATE; }
+    ostream& _write(ostream& os) const { return os << "counting"; }
+};
+
+//! \brief A lazy logical value taking the value \a v from effort \a n onwards.
+class ThresholdLogical : public LogicalInterface {
+    unsigned int _n; LogicalValue _v;
+  public:
+    ThresholdLogical(unsigned int n, LogicalValue v) : _n(n), _v(v) { }
+    LogicalInterface* clone() const { return new ThresholdLogical(*this); }
+    LogicalValue _check(Effort eff) const { return eff.work()>=_n ? _v : LogicalValue::INDETERMINATE; }
+    ostream& _write(ostream& os) const { return os << "threshold(" << _n << "," << _v << ")"; }
+};
+
+LowerKleenean threshold(unsigned int n, LogicalValue v) {
+    return LowerKleenean(LogicalHandle(std::shared_ptr<LogicalInterface>(new ThresholdLogical(n,v))));
+}
+
 class TestLogical
 {
   public:
@@ -43,6 +70,11 @@ class TestLogical
     void test_conversion_to_bool();
     void test_conversion();
     void test_disjunction();
+    void test_constant_folding();
+    void test_memoisation();
+    void test_stepper();
+    void test_parallel_choose();
+    void test_deadline();
 };
 
 int main() {
@@ -56,6 +88,11 @@ TestLogical::test()
     HELPER_TEST_CALL(test_conversion_to_bool());
     HELPER_TEST_CALL(test_conversion());
     HELPER_TEST_CALL(test_disjunction());
+    HELPER_TEST_CALL(test_constant_folding());
+    HELPER_TEST_CALL(test_memoisation());
+    HELPER_TEST_CALL(test_stepper());
+    HELPER_TEST_CALL(test_parallel_choose());
+    HELPER_TEST_CALL(test_deadline());
 }
 
 void
@@ -152,3 +189,168 @@ TestLogical::test_disjunction()
 
 }
 
+void
+TestLogical::test_constant_folding()
+{
+    Effort eff(0);
+    size_t count=allocation_count();
+    Kleenean kt(true), kf(false), ki(indeterminate), ks(Sign::NEGATIVE);
+    Sierpinskian st(true);
+    Kleenean k1=kt && ki;
+    Kleenean k2=kf || !ks;
+    Kleenean k3=(kt ^ kf) && (ki || kf) && st;
+    HELPER_TEST_EQUALS(allocation_count(),count);
+
+    HELPER_TEST_ASSERT(k1.repr().is_constant());
+    HELPER_TEST_EQUALS(static_cast<int>(k1.repr().value()),static_cast<int>(LogicalValue::INDETERMINATE));
+    HELPER_TEST_ASSERT(definitely(k2.check(eff)));
+    HELPER_TEST_ASSERT(is_indeterminate(k3.check(eff)));
+    HELPER_TEST_ASSERT(not possibly(ks.check(eff)));
+    HELPER_TEST_EQUALS(static_cast<int>(Detail::logical_value_from_handle(k2.repr())),static_cast<int>(LogicalValue::TRUE));
+    HELPER_TEST_EQUALS(static_cast<int>(Detail::logical_type_from_handle<EffectiveTag>(k2.repr()).repr().value()),static_cast<int>(LogicalValue::TRUE));
+
+    Sequence<LowerKleenean> seq([](unsigned int n){return n==1 ? LowerKleenean(true) : LowerKleenean(indeterminate);});
+    LowerKleenean lazy=disjunction(seq);
+    HELPER_TEST_ASSERT(not lazy.repr().is_constant());
+    LowerKleenean mixed=lazy && LowerKleenean(true);
+    HELPER_TEST_ASSERT(not mixed.repr().is_constant());
+    HELPER_TEST_ASSERT(definitely(mixed.check(2_eff)));
+    HELPER_TEST_PRINT(mixed);
+    HELPER_TEST_PRINT(k1);
+
+    bool thrown=false;
+    try { Detail::logical_value_from_handle(lazy.repr()); } catch (std::runtime_error const&) { thrown=true; }
+    HELPER_TEST_ASSERT(thrown);
+    thrown=false;
+    try { k1.repr().reference(); } catch (std::runtime_error const&) { thrown=true; }
+    HELPER_TEST_ASSERT(thrown);
+}
+
+void
+TestLogical::test_memoisation()
+{
+    size_t count=0u;
+    LowerKleenean leaf(LogicalHandle(std::shared_ptr<LogicalInterface>(new CountingLogical(count))));
+    LowerKleenean shared=leaf && leaf;
+    LowerKleenean top=(shared || shared) && (shared || !(!shared));
+
+    HELPER_TEST_ASSERT(is_indeterminate(top.check(1_eff)));
+    HELPER_TEST_EQUALS(count,2u);
+    HELPER_TEST_ASSERT(is_indeterminate(top.check(1_eff)));
+    HELPER_TEST_EQUALS(count,2u);
+    HELPER_TEST_ASSERT(is_indeterminate(top.check(2_eff)));
+    HELPER_TEST_EQUALS(count,4u);
+    HELPER_TEST_ASSERT(definitely(top.check(3_eff)));
+    HELPER_TEST_EQUALS(count,6u);
+    HELPER_TEST_ASSERT(definitely(top.check(8_eff)));
+    HELPER_TEST_EQUALS(count,6u);
+    HELPER_TEST_ASSERT(is_indeterminate(top.check(2_eff)));
+
+    LogicalHandle::set_memoisation(false);
+    count=0u;
+    LowerKleenean unmemoised=(leaf && leaf) || (leaf && leaf);
+    HELPER_TEST_ASSERT(is_indeterminate(unmemoised.check(1_eff)));
+    HELPER_TEST_ASSERT(is_indeterminate(unmemoised.check(1_eff)));
+    HELPER_TEST_EQUALS(count,8u);
+    LogicalHandle::set_memoisation(true);
+}
+
+void
+TestLogical::test_stepper()
+{
+    size_t count=0u;
+    LowerKleenean leaf(LogicalHandle(std::shared_ptr<LogicalInterface>(new CountingLogical(count))));
+    Kleenean k=Kleenean(true) && Kleenean(leaf.repr());
+    LogicalStepper stepper(k.repr());
+    HELPER_TEST_EQUALS(stepper.effort().work(),0u);
+    for (unsigned int e=0u; e!=6u; ++e) {
+        HELPER_TEST_EQUALS(static_cast<int>(stepper.step_to(Effort(e))),static_cast<int>(k.repr().check(Effort(e))));
+    }
+    count=0u;
+    LogicalStepper determinate(k.repr());
+    determinate.step_to(Effort(10u));
+    HELPER_TEST_EQUALS(count,4u);
+
+    size_t terms=0u;
+    Sequence<LowerKleenean> seq([&terms](unsigned int n){ ++terms; return n==20u ? LowerKleenean(true) : LowerKleenean(indeterminate); });
+    LowerKleenean some=disjunction(seq);
+    Effort eff(0u);
+    while (not definitely(some.check(eff))) { ++eff; }
+    HELPER_TEST_EQUALS(eff.work(),21u);
+    HELPER_TEST_EQUALS(terms,21u);
+
+    terms=0u;
+    LogicalStepper sequence_stepper(some.repr());
+    while (not Detail::definitely(sequence_stepper.value())) { sequence_stepper.step(); }
+    HELPER_TEST_EQUALS(sequence_stepper.effort().work(),21u);
+    HELPER_TEST_EQUALS(terms,0u);
+    HELPER_TEST_ASSERT(is_indeterminate(some.check(20_eff)));
+
+    Array<LowerKleenean> choices({LowerKleenean(indeterminate),some,leaf});
+    HELPER_TEST_EQUALS(nondeterministic_choose_index(choices),2u);
+}
+
+void
+TestLogical::test_parallel_choose()
+{
+    Array<LowerKleenean> p({threshold(400u,LogicalValue::TRUE),threshold(30u,LogicalValue::TRUE),
+                            threshold(2u,LogicalValue::FALSE),threshold(30u,LogicalValue::TRUE)});
+    HELPER_TEST_EQUALS(nondeterministic_choose_index(p),1u);
+    HELPER_TEST_EQUALS(nondeterministic_choose_index(p,1u),1u);
+    for (unsigned int concurrency=2u; concurrency!=6u; ++concurrency) {
+        size_t i=nondeterministic_choose_index(p,concurrency);
+        HELPER_TEST_ASSERT(i==0u or i==1u or i==3u);
+        HELPER_TEST_ASSERT(definitely(p[i].check(Effort(400u))));
+    }
+    HELPER_TEST_ASSERT(nondeterministic_choose_index(p,0u)!=2u);
+
+    HELPER_TEST_ASSERT(choose(threshold(5u,LogicalValue::TRUE),threshold(50u,LogicalValue::TRUE),1u));
+    HELPER_TEST_ASSERT(not choose(threshold(2u,LogicalValue::FALSE),threshold(50u,LogicalValue::TRUE),2u));
+
+    Array<LowerKleenean> none({threshold(1u,LogicalValue::FALSE),LowerKleenean(false)});
+    for (unsigned int concurrency=0u; concurrency!=4u; ++concurrency) {
+        bool thrown=false;
+        try { nondeterministic_choose_index(none,concurrency); }
+        catch (std::runtime_error const&) { thrown=true; }
+        HELPER_TEST_ASSERT(thrown);
+    }
+    try {
+        choose(LowerKleenean(false),threshold(3u,LogicalValue::FALSE),2u);
+        HELPER_TEST_FAIL("Expected an exception when both predicates are definitely false");
+    } catch (std::runtime_error const&) { }
+}
+
+void
+TestLogical::test_deadline()
+{
+    using namespace std::chrono_literals;
+    Deadline later=Deadline::after(10s);
+    HELPER_TEST_ASSERT(not later.expired());
+    HELPER_TEST_PRINT(later);
+
+    auto result=check(threshold(25u,LogicalValue::TRUE),later);
+    HELPER_TEST_ASSERT(definitely(result.value));
+    HELPER_TEST_EQUALS(result.effort.work(),25u);
+    HELPER_TEST_ASSERT(definitely(threshold(5u,LogicalValue::TRUE),later));
+
+    UpperKleenean uk(threshold(3u,LogicalValue::FALSE).repr());
+    HELPER_TEST_ASSERT(not possibly(uk,later));
+    HELPER_TEST_EQUALS(check(uk,later).effort.work(),3u);
+    HELPER_TEST_EQUALS(check(Kleenean(true),later).effort.work(),0u);
+    HELPER_TEST_ASSERT(is_indeterminate(check(Kleenean(indeterminate),later).value));
+
+    Deadline passed=Deadline::after(0ms);
+    HELPER_TEST_ASSERT(passed.expired());
+    auto expired=check(threshold(25u,LogicalValue::TRUE),passed);
+    HELPER_TEST_ASSERT(is_indeterminate(expired.value));
+    HELPER_TEST_EQUALS(expired.effort.work(),0u);
+
+    Kleenean never(threshold(1000000u,LogicalValue::TRUE).repr());
+    auto start=Deadline::ClockType::now();
+    auto bounded=check(never,Deadline::after(20ms));
+    auto elapsed=Deadline::ClockType::now()-start;
+    HELPER_TEST_ASSERT(is_indeterminate(bounded.value));
+    HELPER_TEST_COMPARE(bounded.effort.work(),>,0u);
+    HELPER_TEST_ASSERT(elapsed<1s);
+    HELPER_TEST_ASSERT(not decide(never,Deadline::after(1ms)));
+}
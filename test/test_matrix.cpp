@@ -0,0 +1,271 @@
+/***************************************************************************
+ *            test_matrix.cpp
+ *
+ *  Copyright  2023  Luca Geretti
+ *
+ ****************************************************************************/
+
+/*
+ * This file is part of SymboliCore, under the MIT license.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <cmath>
+#include <limits>
+
+#include "helper/test.hpp"
+#include "real.hpp"
+#include "matrix.hpp"
+#include "expression.hpp"
+#include "valuation.hpp"
+#include "space.hpp"
+
+using namespace SymboliCore;
+using namespace Helper;
+
+namespace {
+
+// A deterministic, well-scaled test value
+double element(size_t i, size_t j) { return std::sin(static_cast<double>(3*i+7*j+1)); }
+
+Matrix<Real> test_matrix(size_t rs, size_t cs) {
+    return Matrix<Real>(rs,cs,[](size_t i, size_t j){return Real(element(i,j));});
+}
+
+double max_difference(Matrix<Real> const& A1, Matrix<Real> const& A2) {
+    double r=0.0;
+    for (size_t i=0; i!=A1.row_size(); ++i)
+        for (size_t j=0; j!=A1.column_size(); ++j)
+            r=std::max(r,std::abs(A1.get(i,j).value()-A2.get(i,j).value()));
+    return r;
+}
+
+} // namespace
+
+class TestMatrix
+{
+  public:
+    void test();
+  private:
+    void test_construction();
+    void test_access();
+    void test_arithmetic();
+    void test_matrix_vector_product();
+    void test_matrix_matrix_product();
+    void test_lu_solve();
+    void test_singular();
+    void test_symbolic();
+};
+
+int main() {
+    HELPER_TEST_CLASS(TestMatrix,TestMatrix());
+    return HELPER_TEST_FAILURES;
+}
+
+void TestMatrix::test() {
+    HELPER_TEST_CALL(test_construction());
+    HELPER_TEST_CALL(test_access());
+    HELPER_TEST_CALL(test_arithmetic());
+    HELPER_TEST_CALL(test_matrix_vector_product());
+    HELPER_TEST_CALL(test_matrix_matrix_product());
+    HELPER_TEST_CALL(test_lu_solve());
+    HELPER_TEST_CALL(test_singular());
+    HELPER_TEST_CALL(test_symbolic());
+}
+
+void TestMatrix::test_construction() {
+    Matrix<Real> A({{Real(1.0),Real(2.0),Real(3.0)},{Real(4.0),Real(5.0),Real(6.0)}});
+    HELPER_TEST_PRINT(A);
+    HELPER_TEST_EQUALS(A.row_size(),2);
+    HELPER_TEST_EQUALS(A.column_size(),3);
+    HELPER_TEST_EQUALS(A.get(1,0),Real(4.0));
+
+    Matrix<Real> Z=Matrix<Real>::zero(2,3);
+    HELPER_TEST_EQUALS(Z.get(1,2),Real(0.0));
+    Matrix<Real> I=Matrix<Real>::identity(3);
+    HELPER_TEST_EQUALS(I.get(1,1),Real(1.0));
+    HELPER_TEST_EQUALS(I.get(1,2),Real(0.0));
+
+    Matrix<Real> G(2,2,[](size_t i, size_t j){return Real(static_cast<double>(10*i+j));});
+    HELPER_TEST_EQUALS(G.get(1,0),Real(10.0));
+
+    try {
+        Matrix<Real> R({{Real(1.0),Real(2.0)},{Real(3.0)}});
+        HELPER_TEST_FAIL("Constructing a matrix from rows of different sizes should fail.");
+    } catch (std::exception const&) { }
+
+    Covector<Real> u({Real(1.0),Real(2.0)});
+    HELPER_TEST_PRINT(u);
+    HELPER_TEST_EQUALS(u.size(),2);
+    HELPER_TEST_EQUALS(transpose(u)[1],Real(2.0));
+}
+
+void TestMatrix::test_access() {
+    Matrix<Real> A({{Real(1.0),Real(2.0),Real(3.0)},{Real(4.0),Real(5.0),Real(6.0)}});
+    HELPER_TEST_EQUALS(A[1][2],Real(6.0));
+    A[1][2]=Real(7.0);
+    HELPER_TEST_EQUALS(A.at(1,2),Real(7.0));
+    A.set(0,0,Real(-1.0));
+    HELPER_TEST_EQUALS(A[0][0],Real(-1.0));
+
+    Covector<Real> r=A.row(1);
+    HELPER_TEST_EQUALS(r.size(),3);
+    HELPER_TEST_EQUALS(r[2],Real(7.0));
+    Vector<Real> c=A.column(1);
+    HELPER_TEST_EQUALS(c.size(),2);
+    HELPER_TEST_EQUALS(c[1],Real(5.0));
+
+    Matrix<Real> T=transpose(A);
+    HELPER_TEST_EQUALS(T.row_size(),3);
+    HELPER_TEST_EQUALS(T.get(2,1),Real(7.0));
+}
+
+void TestMatrix::test_arithmetic() {
+    Matrix<Real> A({{Real(1.0),Real(2.0)},{Real(3.0),Real(4.0)}});
+    Matrix<Real> B({{Real(0.5),Real(0.0)},{Real(-1.0),Real(2.0)}});
+    HELPER_TEST_EQUALS(A+B,Matrix<Real>({{Real(1.5),Real(2.0)},{Real(2.0),Real(6.0)}}));
+    HELPER_TEST_EQUALS(A-B,Matrix<Real>({{Real(0.5),Real(2.0)},{Real(4.0),Real(2.0)}}));
+    HELPER_TEST_EQUALS(-A,Matrix<Real>({{Real(-1.0),Real(-2.0)},{Real(-3.0),Real(-4.0)}}));
+    HELPER_TEST_EQUALS(Real(2.0)*A,Matrix<Real>({{Real(2.0),Real(4.0)},{Real(6.0),Real(8.0)}}));
+    HELPER_TEST_EQUALS(A/Real(2.0),Matrix<Real>({{Real(0.5),Real(1.0)},{Real(1.5),Real(2.0)}}));
+
+    Covector<Real> u({Real(1.0),Real(-1.0)});
+    Vector<Real> v({Real(2.0),Real(3.0)});
+    HELPER_TEST_EQUALS(u*v,Real(-1.0));
+    Covector<Real> uA=u*A;
+    HELPER_TEST_EQUALS(uA[0],Real(-2.0));
+    HELPER_TEST_EQUALS(uA[1],Real(-2.0));
+}
+
+void TestMatrix::test_matrix_vector_product() {
+    for (size_t n : {0u,1u,7u,9u,300u,2100u}) {
+        size_t m=n/3+2;
+        Matrix<Real> A=test_matrix(m,n);
+        Vector<Real> v(n,[](size_t j){return Real(std::cos(static_cast<double>(j)));});
+        Vector<Real> Av=A*v;
+        HELPER_TEST_EQUALS(Av.size(),m);
+        double err=0.0;
+        for (size_t i=0; i!=m; ++i) {
+            double r=0.0;
+            for (size_t j=0; j!=n; ++j) { r+=element(i,j)*std::cos(static_cast<double>(j)); }
+            err=std::max(err,std::abs(Av[i].value()-r));
+        }
+        HELPER_TEST_ASSERT(err<1e-10);
+
+        Covector<Real> u(m,[](size_t i){return Real(1.0/static_cast<double>(i+1));});
+        Covector<Real> uA=u*A;
+        err=0.0;
+        for (size_t j=0; j!=n; ++j) {
+            double r=0.0;
+            for (size_t i=0; i!=m; ++i) { r+=element(i,j)/static_cast<double>(i+1); }
+            err=std::max(err,std::abs(uA[j].value()-r));
+        }
+        HELPER_TEST_ASSERT(err<1e-10);
+    }
+}
+
+void TestMatrix::test_matrix_matrix_product() {
+    // Sizes straddling the block boundaries of the kernel
+    Matrix<Real> A=test_matrix(70,150);
+    Matrix<Real> B=transpose(test_matrix(300,150));
+    Matrix<Real> AB=A*B;
+    HELPER_TEST_EQUALS(AB.row_size(),70);
+    HELPER_TEST_EQUALS(AB.column_size(),300);
+    Matrix<Real> R(70,300,[&A,&B](size_t i, size_t j){
+        double r=0.0;
+        for (size_t k=0; k!=150; ++k) { r+=A.get(i,k).value()*B.get(k,j).value(); }
+        return Real(r); });
+    HELPER_TEST_ASSERT(max_difference(AB,R)<1e-10);
+
+    Matrix<Real> I=Matrix<Real>::identity(150);
+    HELPER_TEST_EQUALS(A*I,A);
+    Matrix<Real> E=Matrix<Real>(3,0,Real(0.0))*Matrix<Real>(0,2,Real(0.0));
+    HELPER_TEST_EQUALS(E,Matrix<Real>::zero(3,2));
+}
+
+void TestMatrix::test_lu_solve() {
+    Matrix<Real> A({{Real(0.0),Real(2.0),Real(1.0)},{Real(1.0),Real(1.0),Real(0.0)},{Real(3.0),Real(0.0),Real(1.0)}});
+    LUDecomposition lu(A);
+    HELPER_TEST_PRINT(lu.factors());
+    HELPER_TEST_EQUALS(lu.permutation()[0],2u);
+    HELPER_TEST_ASSERT(std::abs(lu.determinant().value()-(-5.0))<1e-14);
+    HELPER_TEST_ASSERT(std::abs(determinant(A).value()-(-5.0))<1e-14);
+
+    Vector<Real> b({Real(3.0),Real(2.0),Real(4.0)});
+    Vector<Real> x=solve(A,b);
+    HELPER_TEST_PRINT(x);
+    HELPER_TEST_ASSERT(two_norm(Vector<Real>(A*x-b)).value()<1e-14);
+
+    size_t n=120;
+    Matrix<Real> M=test_matrix(n,n)+Real(static_cast<double>(n))*Matrix<Real>::identity(n);
+    Matrix<Real> Minv=inverse(M);
+    HELPER_TEST_ASSERT(max_difference(M*Minv,Matrix<Real>::identity(n))<1e-12);
+    Matrix<Real> B=test_matrix(n,5);
+    HELPER_TEST_ASSERT(max_difference(M*solve(M,B),B)<1e-12);
+
+    try {
+        solve(A,Vector<Real>({Real(1.0),Real(2.0)}));
+        HELPER_TEST_FAIL("Solving with a right-hand side of the wrong size should fail.");
+    } catch (std::exception const&) { }
+}
+
+void TestMatrix::test_singular() {
+    Matrix<Real> S({{Real(1.0),Real(2.0)},{Real(2.0),Real(4.0)}});
+    try {
+        LUDecomposition lu(S);
+        HELPER_TEST_FAIL("Decomposing a singular matrix should fail.");
+    } catch (std::runtime_error const& e) {
+        HELPER_TEST_PRINT(e.what());
+    }
+    HELPER_TEST_EQUALS(determinant(S),Real(0.0));
+    Matrix<Real> N({{Real(std::numeric_limits<double>::quiet_NaN()),Real(2.0)},{Real(1.0),Real(4.0)}});
+    HELPER_TEST_ASSERT(std::isnan(determinant(N).value()));
+    try {
+        LUDecomposition lu(Matrix<Real>(2,3,Real(1.0)));
+        HELPER_TEST_FAIL("Decomposing a non-square matrix should fail.");
+    } catch (std::exception const&) { }
+}
+
+void TestMatrix::test_symbolic() {
+    RealVariable x("x"), y("y");
+    RealSpace spc({x,y});
+    Vector<RealExpression> f({x*y,sin(x)+y});
+    Matrix<RealExpression> J=jacobian(f,spc);
+    HELPER_TEST_PRINT(J);
+    HELPER_TEST_EQUALS(J.row_size(),2);
+    HELPER_TEST_EQUALS(J.column_size(),2);
+
+    Valuation<Real> v({x|Real(0.5),y|Real(-2.0)});
+    Matrix<Real> Jv=evaluate(J,v);
+    HELPER_TEST_EQUALS(Jv.get(0,0),Real(-2.0));
+    HELPER_TEST_EQUALS(Jv.get(0,1),Real(0.5));
+    HELPER_TEST_EQUALS(Jv.get(1,0),cos(Real(0.5)));
+    HELPER_TEST_EQUALS(Jv.get(1,1),Real(1.0));
+
+    Vector<RealExpression> d({RealExpression(x),RealExpression(y)});
+    Vector<RealExpression> Jd=J*d;
+    HELPER_TEST_PRINT(Jd);
+    HELPER_TEST_EQUALS(evaluate(Jd[0],v),Real(-2.0));
+
+    Matrix<Real> A({{Real(1.0),Real(2.0)},{Real(0.0),Real(-1.0)}});
+    Vector<RealExpression> Ad=A*d;
+    HELPER_TEST_PRINT(Ad);
+    HELPER_TEST_EQUALS(evaluate(Ad[0],v),Real(-3.5));
+    HELPER_TEST_EQUALS(evaluate(Ad[1],v),Real(2.0));
+}
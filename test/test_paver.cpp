@@ -0,0 +1,121 @@
+/***************************************************************************
+ *            test_paver.cpp
+ *
+ *  Copyright  2023  Luca Geretti
+ *
+ ****************************************************************************/
+
+/*
+ * This file is part of SymboliCore, under the MIT license.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <algorithm>
+#include <sstream>
+
+#include "helper/test.hpp"
+#include "helper/container.hpp"
+#include "real.hpp"
+#include "expression.hpp"
+#include "valuation.hpp"
+#include "interval.hpp"
+#include "variables_box.hpp"
+#include "paver.hpp"
+
+using namespace SymboliCore;
+using namespace Helper;
+
+class TestPaver {
+    RealVariable x,y;
+    RealVariablesBox bx;
+  public:
+    TestPaver() : x("x"), y("y"), bx({RealVariableInterval(-2.0,x,2.0),RealVariableInterval(-2.0,y,2.0)}) { }
+
+    double area(List<RealVariablesBox> const& bxs) {
+        double r=0.0;
+        for (auto const& b : bxs) { r+=width(b[x]).value()*width(b[y]).value(); }
+        return r;
+    }
+
+    List<String> sorted_strings(List<RealVariablesBox> const& bxs) {
+        List<String> r;
+        for (auto const& b : bxs) { std::ostringstream ss; ss << b; r.push_back(ss.str()); }
+        std::sort(r.begin(),r.end());
+        return r;
+    }
+
+    void test_disk() {
+        PaverSettings settings=PaverSettings::default_settings();
+        settings.minimum_width=0.05; settings.concurrency=1;
+        Paving p=Paver(sqr(x)+sqr(y)<=1,settings).pave(bx);
+        HELPER_TEST_PRINT(p.inside.size());
+        HELPER_TEST_PRINT(p.outside.size());
+        HELPER_TEST_PRINT(p.undecided.size());
+        double ai=area(p.inside), ao=area(p.outside), au=area(p.undecided);
+        HELPER_TEST_PRINT(ai);
+        HELPER_TEST_ASSERT(ai<=3.1416 && 3.1415<=ai+au);
+        HELPER_TEST_ASSERT(ai>2.5);
+        HELPER_TEST_ASSERT(std::abs(ai+ao+au-16.0)<1e-9);
+        for (auto const& b : p.outside) {
+            Valuation<Real> v({x|midpoint(b[x]),y|midpoint(b[y])});
+            HELPER_TEST_ASSERT(not definitely(evaluate(sqr(x)+sqr(y)<=1,v)));
+        }
+        for (auto const& b : p.inside) {
+            Valuation<Real> v({x|b[x].upper_bound(),y|b[y].lower_bound()});
+            HELPER_TEST_ASSERT(definitely(evaluate(sqr(x)+sqr(y)<=1,v)));
+        }
+    }
+
+    void test_limits() {
+        PaverSettings settings=PaverSettings::default_settings();
+        settings.maximum_depth=4; settings.concurrency=1; settings.contract=false;
+        Paving p=Paver(List<KleeneanExpression>({x*y>=1,x<=y}),settings).pave(bx);
+        HELPER_TEST_ASSERT(p.inside.size()+p.outside.size()+p.undecided.size()<=16);
+        HELPER_TEST_ASSERT(not p.undecided.empty());
+    }
+
+    void test_concurrency() {
+        PaverSettings settings=PaverSettings::default_settings();
+        settings.minimum_width=0.02;
+        KleeneanExpression p=sin(x*y)>=0.2 || sqr(x)-y<=0;
+        settings.concurrency=1;
+        Paving p1=Paver(p,settings).pave(bx);
+        settings.concurrency=4;
+        Paving p4=Paver(p,settings).pave(bx);
+        HELPER_TEST_PRINT(p4.inside.size());
+        HELPER_TEST_ASSERT(sorted_strings(p1.inside)==sorted_strings(p4.inside));
+        HELPER_TEST_ASSERT(sorted_strings(p1.outside)==sorted_strings(p4.outside));
+        HELPER_TEST_ASSERT(sorted_strings(p1.undecided)==sorted_strings(p4.undecided));
+
+        size_t count=0;
+        Paver(p,settings).pave(bx,[&count](RealVariablesBox const&, PavingClass) { ++count; });
+        HELPER_TEST_EQUALS(count,p1.inside.size()+p1.outside.size()+p1.undecided.size());
+    }
+
+    void test() {
+        HELPER_TEST_CALL(test_disk());
+        HELPER_TEST_CALL(test_limits());
+        HELPER_TEST_CALL(test_concurrency());
+    }
+};
+
+int main() {
+    TestPaver().test();
+    return HELPER_TEST_FAILURES;
+}
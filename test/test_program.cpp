@@ -0,0 +1,201 @@
+/***************************************************************************
+ *            test_program.cpp
+ *
+ *  Copyright  2023  Luca Geretti
+ *
+ ****************************************************************************/
+
+/*
+ * This file is part of SymboliCore, under the MIT license.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "helper/test.hpp"
+#include "real.hpp"
+#include "vector.hpp"
+#include "expression.hpp"
+#include "assignment.hpp"
+#include "valuation.hpp"
+#include "space.hpp"
+#include "program.hpp"
+
+using namespace SymboliCore;
+using namespace Helper;
+
+class TestProgram {
+    RealVariable x,y,u,v,w,z;
+    RealSpace spc;
+  public:
+    TestProgram() : x("x"), y("y"), u("u"), v("v"), w("w"), z("z"), spc({x,y}) { }
+
+    // Evaluates the assignments in order, inserting each result into the valuation
+    Vector<Real> reference(List<RealAssignment> const& asg, List<RealVariable> const& outputs, Valuation<Real> val) {
+        for (auto const& a : asg) { val.insert(a.lhs,evaluate(a.rhs,val)); }
+        return Vector<Real>(outputs.size(),[&](size_t i){return val[outputs[i]];});
+    }
+
+    void test_evaluate() {
+        List<RealAssignment> asg={let(u)=x*y+sin(x), let(v)=pow(u-y,3)-max(u,x)/2, let(w)=exp(-sqr(v))*atan(u)+hlf(rec(y)), let(z)=sqrt(abs(w))+min(v,w)};
+        RegisterProgram p(asg,spc);
+        HELPER_TEST_PRINT(p);
+        HELPER_TEST_EQUALS(p.argument_size(),2);
+        HELPER_TEST_EQUALS(p.result_size(),4);
+
+        Valuation<Real> val({x|Real(0.75),y|Real(-1.25)});
+        Vector<Real> r=evaluate(p,val);
+        Vector<Real> e=reference(asg,{u,v,w,z},val);
+        for (size_t i=0; i!=e.size(); ++i) { HELPER_TEST_EQUALS(r[i],e[i]); }
+        HELPER_TEST_EQUALS(p(Vector<Real>({Real(0.75),Real(-1.25)})),r);
+
+        double xa[2]={0.75,-1.25}; double ya[4]; std::vector<double> wa(p.register_size());
+        p(xa,ya,wa.data());
+        for (size_t i=0; i!=e.size(); ++i) { HELPER_TEST_EQUALS(ya[i],e[i].value()); }
+    }
+
+    void test_outputs() {
+        List<RealAssignment> asg={let(u)=x+y, let(v)=u*u};
+        RegisterProgram p(asg,spc,{v,x});
+        HELPER_TEST_EQUALS(p.result_size(),2);
+        Vector<Real> r=p(Vector<Real>({Real(2.0),Real(1.0)}));
+        HELPER_TEST_EQUALS(r[0],Real(9.0));
+        HELPER_TEST_EQUALS(r[1],Real(2.0));
+    }
+
+    void test_common_subexpressions() {
+        // The product x*y is built twice as separate nodes, but computed once
+        List<RealAssignment> asg={let(u)=x*y+1, let(v)=exp(y*x)};
+        RegisterProgram p(asg,spc);
+        HELPER_TEST_PRINT(p);
+        HELPER_TEST_EQUALS(p.number_of_instructions(),3);
+    }
+
+    void test_dead_code_elimination() {
+        List<RealAssignment> asg={let(u)=x+y, let(v)=sin(u)*cos(u), let(w)=u*2};
+        RegisterProgram all(asg,spc);
+        RegisterProgram only_w(asg,spc,{w});
+        HELPER_TEST_PRINT(only_w);
+        HELPER_TEST_EQUALS(all.number_of_instructions(),5);
+        HELPER_TEST_EQUALS(only_w.number_of_instructions(),2);
+        HELPER_TEST_EQUALS(only_w(Vector<Real>({Real(1.0),Real(2.0)}))[0],Real(6.0));
+    }
+
+    void test_register_reuse() {
+        // A long chain only needs a couple of temporaries
+        RealExpression e=x;
+        for (size_t i=0; i!=100; ++i) { e=sin(e)+y; }
+        RegisterProgram p({let(u)=e},spc);
+        HELPER_TEST_EQUALS(p.number_of_instructions(),200);
+        HELPER_TEST_ASSERT(p.register_size()<=5);
+        Valuation<Real> val({x|Real(0.5),y|Real(0.25)});
+        HELPER_TEST_EQUALS(evaluate(p,val)[0],evaluate(e,val));
+    }
+
+    void test_batch() {
+        List<RealAssignment> asg={let(u)=x*y+sin(x), let(v)=pow(u-y,2)-max(u,x)/2, let(w)=exp(-sqr(v))+u};
+        RegisterProgram p(asg,spc);
+        size_t const n=1000;
+        std::vector<double> xs(2*n);
+        for (size_t i=0; i!=n; ++i) { xs[2*i]=0.01*static_cast<double>(i); xs[2*i+1]=1.0-0.003*static_cast<double>(i); }
+        std::vector<double> expected(3*n), serial(3*n), parallel(3*n);
+        for (size_t i=0; i!=n; ++i) { p(xs.data()+2*i,expected.data()+3*i); }
+        p.batch(n,xs.data(),serial.data());
+        p.batch(n,xs.data(),parallel.data(),4u);
+        HELPER_TEST_ASSERT(serial==expected);
+        HELPER_TEST_ASSERT(parallel==expected);
+        p.batch(n,xs.data(),parallel.data(),0u);
+        HELPER_TEST_ASSERT(parallel==expected);
+    }
+
+    void test_reset() {
+        RealSpace state({x,y,z});
+        // A swap with a shared subexpression, leaving z unchanged
+        PrimedRealAssignments resets={prime(x)=y*sin(x*y), prime(y)=x+cos(x*y)};
+        ResetMap r(resets,state);
+        HELPER_TEST_PRINT(r);
+        HELPER_TEST_EQUALS(r.dimension(),3);
+        HELPER_TEST_EQUALS(r.program().number_of_instructions(),5);
+
+        Valuation<Real> old({x|Real(0.5),y|Real(2.0),z|Real(-3.0),u|Real(7.0)});
+        Valuation<Real> val=evaluate(r,old);
+        HELPER_TEST_EQUALS(val[x],evaluate(resets[0].rhs,old));
+        HELPER_TEST_EQUALS(val[y],evaluate(resets[1].rhs,old));
+        HELPER_TEST_EQUALS(val[z],Real(-3.0));
+        HELPER_TEST_EQUALS(val[u],Real(7.0));
+
+        double xa[3]={0.5,2.0,-3.0}; double ya[3]; std::vector<double> wa(r.workspace_size());
+        r(xa,ya,wa.data());
+        r(xa,wa.data());
+        for (size_t i=0; i!=3; ++i) { HELPER_TEST_EQUALS(xa[i],ya[i]); }
+        HELPER_TEST_EQUALS(ya[0],val[x].value());
+        HELPER_TEST_EQUALS(ya[2],-3.0);
+
+        size_t const n=300;
+        std::vector<double> xs(3*n), expected(3*n), ys(3*n);
+        for (size_t i=0; i!=3*n; ++i) { xs[i]=0.01*static_cast<double>(i); }
+        for (size_t i=0; i!=n; ++i) { r(xs.data()+3*i,expected.data()+3*i,wa.data()); }
+        r.batch(n,xs.data(),ys.data());
+        HELPER_TEST_ASSERT(ys==expected);
+        r.batch(n,xs.data(),3u);
+        HELPER_TEST_ASSERT(xs==expected);
+
+        // Resets may use auxiliary variables
+        ResetMap ra({let(u)=x*y},{prime(z)=u+z},state);
+        HELPER_TEST_EQUALS(ra(Vector<Real>({Real(2.0),Real(3.0),Real(1.0)}))[2],Real(7.0));
+
+        try {
+            ResetMap({prime(u)=x},state);
+            HELPER_TEST_FAIL("Resetting a variable not in the state space should fail.");
+        } catch (std::runtime_error const&) { }
+        try {
+            ResetMap({prime(x)=y, prime(x)=z},state);
+            HELPER_TEST_FAIL("Resetting a variable twice should fail.");
+        } catch (std::runtime_error const&) { }
+    }
+
+    void test_errors() {
+        try {
+            RegisterProgram({let(v)=u+x, let(u)=y},spc);
+            HELPER_TEST_FAIL("Using a variable before it is assigned should fail.");
+        } catch (std::runtime_error const&) { }
+        try {
+            RegisterProgram({let(u)=x, let(u)=y},spc);
+            HELPER_TEST_FAIL("Assigning a variable twice should fail.");
+        } catch (std::runtime_error const&) { }
+        try {
+            RegisterProgram({let(u)=x},spc,{z});
+            HELPER_TEST_FAIL("An output which is not assigned should fail.");
+        } catch (std::runtime_error const&) { }
+    }
+
+    void test() {
+        HELPER_TEST_CALL(test_evaluate());
+        HELPER_TEST_CALL(test_outputs());
+        HELPER_TEST_CALL(test_common_subexpressions());
+        HELPER_TEST_CALL(test_dead_code_elimination());
+        HELPER_TEST_CALL(test_register_reuse());
+        HELPER_TEST_CALL(test_batch());
+        HELPER_TEST_CALL(test_reset());
+        HELPER_TEST_CALL(test_errors());
+    }
+};
+
+int main() {
+    TestProgram().test();
+    return HELPER_TEST_FAILURES;
+}
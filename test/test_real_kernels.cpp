@@ -0,0 +1,206 @@
+/***************************************************************************
+ *            test_real_kernels.cpp
+ *
+ *  Copyright  2023  Luca Geretti
+ *
+ ****************************************************************************/
+
+/*
+ * This file is part of SymboliCore, under the MIT license.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "helper/test.hpp"
+#include "real_kernels.hpp"
+
+using namespace std;
+using namespace SymboliCore;
+
+using BatchFunction = void(*)(span<const Real>, span<Real>, KernelAccuracy);
+using ScalarFunction = double(*)(double);
+
+namespace {
+
+//! \brief Distance between two doubles in units in the last place
+uint64_t ulp_distance(double x, double y) {
+    if (std::isnan(x) && std::isnan(y)) return 0;
+    if (std::isnan(x) || std::isnan(y)) return numeric_limits<uint64_t>::max();
+    auto ordered = [](double v) { auto i = bit_cast<int64_t>(v); return i < 0 ? numeric_limits<int64_t>::min() - i : i; };
+    auto i = ordered(x), j = ordered(y);
+    return i < j ? static_cast<uint64_t>(j) - static_cast<uint64_t>(i) : static_cast<uint64_t>(i) - static_cast<uint64_t>(j);
+}
+
+//! \brief Sample points spread both uniformly and logarithmically in \a [lower,upper]
+//! \details Even samples are uniform in value; odd samples have a uniform binary exponent
+//! between the smallest and largest magnitudes in the interval, or 60 binades below the largest
+//! if the interval contains zero, and a random sign if it straddles zero.
+vector<Real> samples(double lower, double upper, size_t n) {
+    vector<Real> result;
+    uint64_t state = 0x9E3779B97F4A7C15ull;
+    auto uniform = [&state]() {
+        state = state*6364136223846793005ull + 1442695040888963407ull;
+        return static_cast<double>(state>>11)*0x1p-53; };
+    double const largest = std::max(std::abs(lower),std::abs(upper));
+    double const smallest = (lower<=0.0 && upper>=0.0) ? std::ldexp(largest,-60) : std::min(std::abs(lower),std::abs(upper));
+    double const emin = std::log2(smallest), emax = std::log2(largest);
+    for (size_t i=0; i!=n; ++i) {
+        if (i%2==0) {
+            result.push_back(Real(lower + (upper-lower)*uniform()));
+        } else {
+            double e = emin + (emax-emin)*uniform();
+            double m = std::exp2(e-std::floor(e));
+            double v = std::ldexp(m,static_cast<int>(std::floor(e)));
+            bool negative = upper<=0.0 || (lower<0.0 && uniform()<0.5);
+            result.push_back(Real(std::clamp(negative ? -v : v,lower,upper)));
+        }
+    }
+    return result;
+}
+
+uint64_t max_ulp_error(BatchFunction bf, ScalarFunction sf, vector<Real> const& x, KernelAccuracy acc) {
+    vector<Real> r(x.size());
+    bf(x,r,acc);
+    uint64_t result = 0;
+    for (size_t i=0; i!=x.size(); ++i) result = std::max(result,ulp_distance(r[i].value(),sf(x[i].value())));
+    return result;
+}
+
+}
+
+class TestRealKernels
+{
+  public:
+    void test();
+  private:
+    void test_arithmetic();
+    void test_libm();
+    void test_accuracy();
+    void test_special_values();
+    void test_in_place();
+    void test_size_mismatch();
+};
+
+int main() {
+    HELPER_TEST_CLASS(TestRealKernels,TestRealKernels());
+    return HELPER_TEST_FAILURES;
+}
+
+void TestRealKernels::test() {
+    HELPER_TEST_CALL(test_arithmetic());
+    HELPER_TEST_CALL(test_libm());
+    HELPER_TEST_CALL(test_accuracy());
+    HELPER_TEST_CALL(test_special_values());
+    HELPER_TEST_CALL(test_in_place());
+    HELPER_TEST_CALL(test_size_mismatch());
+}
+
+void TestRealKernels::test_arithmetic() {
+    auto x = samples(-4.0,4.0,1000);
+    auto y = samples(0.5,3.0,1000);
+    vector<Real> r(x.size());
+    add(x,y,r); for (size_t i=0; i!=x.size(); ++i) HELPER_TEST_ASSERT(same(r[i],add(x[i],y[i])));
+    sub(x,y,r); for (size_t i=0; i!=x.size(); ++i) HELPER_TEST_ASSERT(same(r[i],sub(x[i],y[i])));
+    mul(x,y,r); for (size_t i=0; i!=x.size(); ++i) HELPER_TEST_ASSERT(same(r[i],mul(x[i],y[i])));
+    div(x,y,r); for (size_t i=0; i!=x.size(); ++i) HELPER_TEST_ASSERT(same(r[i],div(x[i],y[i])));
+    SymboliCore::min(x,y,r); for (size_t i=0; i!=x.size(); ++i) HELPER_TEST_ASSERT(same(r[i],min(x[i],y[i])));
+    SymboliCore::max(x,y,r); for (size_t i=0; i!=x.size(); ++i) HELPER_TEST_ASSERT(same(r[i],max(x[i],y[i])));
+    neg(x,r); for (size_t i=0; i!=x.size(); ++i) HELPER_TEST_ASSERT(same(r[i],neg(x[i])));
+    hlf(x,r); for (size_t i=0; i!=x.size(); ++i) HELPER_TEST_ASSERT(same(r[i],hlf(x[i])));
+    sqr(x,r); for (size_t i=0; i!=x.size(); ++i) HELPER_TEST_ASSERT(same(r[i],sqr(x[i])));
+    rec(y,r); for (size_t i=0; i!=x.size(); ++i) HELPER_TEST_ASSERT(same(r[i],rec(y[i])));
+    abs(x,r); for (size_t i=0; i!=x.size(); ++i) HELPER_TEST_ASSERT(same(r[i],abs(x[i])));
+    sqrt(y,r); for (size_t i=0; i!=x.size(); ++i) HELPER_TEST_ASSERT(same(r[i],sqrt(y[i])));
+    pow(x,3,r); for (size_t i=0; i!=x.size(); ++i) HELPER_TEST_ASSERT(same(r[i],pow(x[i],3)));
+    nul(x,r); for (size_t i=0; i!=x.size(); ++i) HELPER_TEST_ASSERT(is_zero(r[i]));
+}
+
+void TestRealKernels::test_libm() {
+    auto x = samples(-0.99,0.99,1000);
+    vector<Real> r(x.size());
+    exp(x,r,KernelAccuracy::LIBM); for (size_t i=0; i!=x.size(); ++i) HELPER_TEST_ASSERT(same(r[i],exp(x[i])));
+    sin(x,r,KernelAccuracy::LIBM); for (size_t i=0; i!=x.size(); ++i) HELPER_TEST_ASSERT(same(r[i],sin(x[i])));
+    asin(x,r,KernelAccuracy::LIBM); for (size_t i=0; i!=x.size(); ++i) HELPER_TEST_ASSERT(same(r[i],asin(x[i])));
+}
+
+void TestRealKernels::test_accuracy() {
+    struct Case { const char* name; BatchFunction bf; ScalarFunction sf; double lower; double upper; uint64_t accurate; uint64_t fast; };
+    vector<Case> cases = {
+        {"exp",exp,std::exp,-700.0,700.0,1,2},
+        {"exp",exp,std::exp,-1.0,1.0,1,2},
+        {"log",log,std::log,1e-300,1e300,1,1},
+        {"log",log,std::log,0.5,2.0,1,1},
+        {"sin",sin,std::sin,-10.0,10.0,1,2},
+        {"sin",sin,std::sin,-1e5,1e5,1,2},
+        {"cos",cos,std::cos,-10.0,10.0,1,2},
+        {"cos",cos,std::cos,-1e5,1e5,1,2},
+        {"tan",tan,std::tan,-1.5,1.5,2,3},
+        {"tan",tan,std::tan,-1e3,1e3,2,3},
+        {"asin",asin,std::asin,-1.0,1.0,2,2},
+        {"acos",acos,std::acos,-1.0,1.0,2,2},
+        {"atan",atan,std::atan,-4.0,4.0,1,1},
+        {"atan",atan,std::atan,-1e10,1e10,1,1},
+    };
+    for (auto const& c : cases) {
+        auto x = samples(c.lower,c.upper,100000);
+        auto accurate = max_ulp_error(c.bf,c.sf,x,KernelAccuracy::ACCURATE);
+        auto fast = max_ulp_error(c.bf,c.sf,x,KernelAccuracy::FAST);
+        HELPER_TEST_ASSERT(accurate <= c.accurate);
+        HELPER_TEST_ASSERT(fast <= c.fast);
+    }
+}
+
+void TestRealKernels::test_special_values() {
+    double inf = numeric_limits<double>::infinity();
+    double nan = numeric_limits<double>::quiet_NaN();
+    vector<Real> x = {Real(inf),Real(-inf),Real(nan),Real(0.0),Real(-0.0),Real(1000.0),Real(-1000.0),Real(-1.0),Real(2.0),Real(1e-310),Real(1e20)};
+    vector<Real> r(x.size());
+    vector<pair<BatchFunction,ScalarFunction>> fs = {
+        {exp,std::exp},{log,std::log},{sin,std::sin},{cos,std::cos},{tan,std::tan},{asin,std::asin},{acos,std::acos},{atan,std::atan}};
+    for (auto const& f : fs) {
+        f.first(x,r,KernelAccuracy::ACCURATE);
+        for (size_t i=0; i!=x.size(); ++i) {
+            auto expected = f.second(x[i].value());
+            HELPER_TEST_ASSERT(ulp_distance(r[i].value(),expected) <= 2);
+        }
+    }
+    exp(x,r,KernelAccuracy::FAST);
+    for (size_t i=0; i!=x.size(); ++i) HELPER_TEST_ASSERT(ulp_distance(r[i].value(),std::exp(x[i].value())) <= 2);
+}
+
+void TestRealKernels::test_in_place() {
+    auto x = samples(-2.0,2.0,1000);
+    auto y = x;
+    exp(y,y);
+    for (size_t i=0; i!=x.size(); ++i) HELPER_TEST_ASSERT(ulp_distance(y[i].value(),std::exp(x[i].value())) <= 1);
+}
+
+void TestRealKernels::test_size_mismatch() {
+    vector<Real> x(3), r(2);
+    try {
+        exp(x,r);
+        HELPER_TEST_FAIL("Expected an exception for mismatched sizes");
+    } catch (std::exception&) { }
+}
@@ -0,0 +1,146 @@
+/***************************************************************************
+ *            test_sequence.cpp
+ *
+ *  Copyright  2023  Luca Geretti
+ *
+ ****************************************************************************/
+
+/*
+ * This file is part of SymboliCore, under the MIT license.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "helper/test.hpp"
+#include "sequence.hpp"
+#include "logical.hpp"
+
+using namespace SymboliCore;
+
+class TestSequence
+{
+  public:
+    void test();
+  private:
+    void test_cached();
+    void test_window();
+    void test_recursive();
+    void test_concurrent();
+    void test_disjunction();
+};
+
+int main() {
+    HELPER_TEST_CLASS(TestSequence,TestSequence());
+    return HELPER_TEST_FAILURES;
+}
+
+void
+TestSequence::test()
+{
+    HELPER_TEST_CALL(test_cached());
+    HELPER_TEST_CALL(test_window());
+    HELPER_TEST_CALL(test_recursive());
+    HELPER_TEST_CALL(test_concurrent());
+    HELPER_TEST_CALL(test_disjunction());
+}
+
+void
+TestSequence::test_cached()
+{
+    unsigned int calls=0u;
+    CachedSequence<double> seq([&calls](unsigned int n){ ++calls; return 1.0/(n+1u); });
+    HELPER_TEST_EQUALS(seq.window(),0u);
+    HELPER_TEST_EQUALS(seq[3u],0.25);
+    HELPER_TEST_EQUALS(seq[3u],0.25);
+    HELPER_TEST_EQUALS(calls,1u);
+    HELPER_TEST_EQUALS(seq.number_of_cached_terms(),1u);
+
+    FastCauchySequence<double> fast(seq);
+    Sequence<double> sliced=seq;
+    HELPER_TEST_EQUALS(fast[3u],0.25);
+    HELPER_TEST_EQUALS(sliced[0u],1.0);
+    HELPER_TEST_EQUALS(sliced[0u],1.0);
+    HELPER_TEST_EQUALS(calls,2u);
+    HELPER_TEST_EQUALS(seq.number_of_cached_terms(),2u);
+
+    CachedSequence<double> from_sequence(Sequence<double>([](unsigned int n){ return 2.0*n; }));
+    HELPER_TEST_EQUALS(from_sequence[5u],10.0);
+    HELPER_TEST_EQUALS(from_sequence.number_of_cached_terms(),1u);
+}
+
+void
+TestSequence::test_window()
+{
+    unsigned int calls=0u;
+    CachedSequence<unsigned int> seq([&calls](unsigned int n){ ++calls; return n*n; },4u);
+    HELPER_TEST_EQUALS(seq.window(),4u);
+    for (unsigned int n=0u; n!=10u; ++n) { HELPER_TEST_EQUALS(seq[n],n*n); }
+    HELPER_TEST_EQUALS(calls,10u);
+    HELPER_TEST_EQUALS(seq.number_of_cached_terms(),4u);
+    for (unsigned int n=6u; n!=10u; ++n) { HELPER_TEST_EQUALS(seq[n],n*n); }
+    HELPER_TEST_EQUALS(calls,10u);
+    HELPER_TEST_EQUALS(seq[1u],1u);
+    HELPER_TEST_EQUALS(calls,11u);
+    HELPER_TEST_EQUALS(seq.number_of_cached_terms(),4u);
+}
+
+void
+TestSequence::test_recursive()
+{
+    unsigned int calls=0u;
+    std::shared_ptr<Sequence<unsigned long>> fibonacci;
+    fibonacci=std::make_shared<Sequence<unsigned long>>(CachedSequence<unsigned long>(
+        [&fibonacci,&calls](unsigned int n){ ++calls; return n<2u ? static_cast<unsigned long>(n) : (*fibonacci)[n-1u]+(*fibonacci)[n-2u]; }));
+    HELPER_TEST_EQUALS((*fibonacci)[60u],1548008755920ul);
+    HELPER_TEST_EQUALS(calls,61u);
+}
+
+void
+TestSequence::test_concurrent()
+{
+    std::atomic<unsigned int> calls(0u);
+    CachedSequence<unsigned int> seq([&calls](unsigned int n){ ++calls; return 3u*n+1u; });
+    std::atomic<unsigned int> errors(0u);
+    std::vector<std::thread> threads;
+    for (unsigned int t=0u; t!=4u; ++t) {
+        threads.emplace_back([&seq,&errors](){
+            for (unsigned int k=0u; k!=3u; ++k) {
+                for (unsigned int n=0u; n!=200u; ++n) { if (seq[n]!=3u*n+1u) { ++errors; } } } });
+    }
+    for (auto& thread : threads) { thread.join(); }
+    HELPER_TEST_EQUALS(errors.load(),0u);
+    HELPER_TEST_EQUALS(seq.number_of_cached_terms(),200u);
+    HELPER_TEST_COMPARE(calls.load(),<=,800u);
+}
+
+void
+TestSequence::test_disjunction()
+{
+    unsigned int calls=0u;
+    Sequence<LowerKleenean> seq([&calls](unsigned int n){ ++calls; return n==5u ? LowerKleenean(true) : LowerKleenean(indeterminate); });
+    LowerKleenean some=disjunction(seq);
+    HELPER_TEST_ASSERT(definitely(some.check(Effort(8u))));
+    HELPER_TEST_ASSERT(not definitely(some.check(Effort(3u))));
+    HELPER_TEST_ASSERT(definitely(some.check(Effort(6u))));
+    HELPER_TEST_PRINT(some);
+    HELPER_TEST_EQUALS(calls,6u);
+}
@@ -30,6 +30,7 @@
 #include "helper/container.hpp"
 #include "real.hpp"
 #include "space.hpp"
+#include "indexed_name.hpp"
 
 using namespace SymboliCore;
 
@@ -48,10 +49,79 @@ class TestSpace {
         }
     }
 
+    void test_indexing() {
+        RealVariable x("x"), y("y"), z("z");
+        Space<Real> spc({x,y});
+        HELPER_TEST_EQUAL(spc.index(y),1);
+        HELPER_TEST_EQUAL(spc[Identifier("x")],0);
+        HELPER_TEST_ASSERT(spc.contains(x));
+        HELPER_TEST_ASSERT(not spc.contains(z));
+        spc.insert(x);
+        HELPER_TEST_EQUAL(spc.dimension(),2);
+        spc.insert(z);
+        HELPER_TEST_EQUAL(spc.index(z),2);
+        try {
+            spc.append(y);
+            HELPER_TEST_FAIL("Appending a variable already in the space should fail.");
+        } catch (std::exception const&) { }
+        HELPER_TEST_EQUAL(spc.dimension(),3);
+        try {
+            spc.index(RealVariable("w"));
+            HELPER_TEST_FAIL("Indexing a variable not in the space should fail.");
+        } catch (std::exception const&) { }
+    }
+
+    void test_join() {
+        RealVariable x("x"), y("y"), z("z");
+        Space<Real> spc=join(Space<Real>({x,y}),Space<Real>({z,y}));
+        HELPER_TEST_EQUAL(spc.dimension(),3);
+        HELPER_TEST_EQUAL(spc.index(z),2);
+        HELPER_TEST_ASSERT(spc==Space<Real>({x,y,z}));
+
+        // Joining spaces with many variables takes linear time
+        size_t n=50000;
+        auto name=[](size_t i){ return Identifier(indexed_name("u",i)); };
+        List<Identifier> names1, names2;
+        for(size_t i=0; i!=n; ++i) {
+            names1.push_back(name(i));
+            names2.push_back(name(i+n/2));
+        }
+        Space<Real> spc1(names1), spc2(names2);
+        Space<Real> big=join(spc1,spc2);
+        HELPER_TEST_EQUAL(big.dimension(),n+n/2);
+        HELPER_TEST_EQUAL(big.index(name(n+n/2-1)),n+n/2-1);
+        HELPER_TEST_EQUAL(big.indices().size(),n+n/2);
+    }
+
+    void test_indices() {
+        RealVariable x("x"), y("y"), z("z");
+        Space<Real> spc({x,y});
+        HELPER_TEST_ASSERT(Space<Real>().indices().empty());
+        Map<RealVariable,size_t> indices=spc.indices();
+        HELPER_TEST_EQUAL(indices.size(),2);
+        HELPER_TEST_EQUAL(indices[y],1);
+        HELPER_TEST_EQUAL(spc.indices_from_names()[Identifier("x")],0);
 
+        // The maps are built once and shared by copies, but a modified copy builds its own
+        Space<Real> other(spc);
+        HELPER_TEST_EQUAL(other.indices().size(),2);
+        other.append(z);
+        HELPER_TEST_EQUAL(other.indices().size(),3);
+        HELPER_TEST_EQUAL(other.indices_from_names()[Identifier("z")],2);
+        HELPER_TEST_EQUAL(spc.indices().size(),2);
+        HELPER_TEST_EQUAL(indices.size(),2);
+
+        // The result is a value, so it outlives a temporary space
+        size_t count=0u;
+        for(auto const& entry : Space<Real>({x,y,z}).indices()) { count+=entry.second; }
+        HELPER_TEST_EQUAL(count,3);
+    }
 
     void test() {
         HELPER_TEST_CALL(test_construction());
+        HELPER_TEST_CALL(test_indexing());
+        HELPER_TEST_CALL(test_join());
+        HELPER_TEST_CALL(test_indices());
     }
 };
 
@@ -0,0 +1,173 @@
+/***************************************************************************
+ *            test_vector.cpp
+ *
+ *  Copyright  2023  Luca Geretti
+ *
+ ****************************************************************************/
+
+/*
+ * This file is part of SymboliCore, under the MIT license.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include <cstdint>
+
+#include "helper/test.hpp"
+#include "real.hpp"
+#include "vector.hpp"
+#include "allocation_counter.hpp"
+
+using namespace SymboliCore;
+
+class TestVector
+{
+  public:
+    void test();
+  private:
+    void test_construction();
+    void test_uninitialised();
+    void test_fused_arithmetic();
+    void test_inplace();
+    void test_aliasing();
+    void test_reductions();
+    void test_join();
+};
+
+int main() {
+    HELPER_TEST_CLASS(TestVector,TestVector());
+    return HELPER_TEST_FAILURES;
+}
+
+void TestVector::test() {
+    HELPER_TEST_CALL(test_construction());
+    HELPER_TEST_CALL(test_uninitialised());
+    HELPER_TEST_CALL(test_fused_arithmetic());
+    HELPER_TEST_CALL(test_inplace());
+    HELPER_TEST_CALL(test_aliasing());
+    HELPER_TEST_CALL(test_reductions());
+    HELPER_TEST_CALL(test_join());
+}
+
+void TestVector::test_construction() {
+    Vector<Real> v({1.0,-2.0,3.0});
+    HELPER_TEST_EQUALS(v.size(),3u);
+    HELPER_TEST_EQUALS(v[1],-2.0);
+    HELPER_TEST_EQUALS(Vector<Real>(3).size(),3u);
+    HELPER_TEST_EQUALS(Vector<Real>(3)[2],0.0);
+    HELPER_TEST_EQUALS(Vector<Real>::unit(3,1)[1],1.0);
+    HELPER_TEST_EQUALS(Vector<Real>::one(2)[0],1.0);
+    HELPER_TEST_EQUALS(Vector<Real>::basis(2).size(),2u);
+    HELPER_TEST_EQUALS(Vector<Real>(v.array())[2],3.0);
+    Vector<Real> w(4u,[](size_t i){return Real(static_cast<double>(i));});
+    HELPER_TEST_EQUALS(w[3],3.0);
+    Vector<Real> c(w);
+    HELPER_TEST_EQUALS(c[3],3.0);
+    Vector<Real> m(std::move(c));
+    HELPER_TEST_EQUALS(m.size(),4u);
+    HELPER_TEST_EQUALS(c.size(),0u);
+    m.resize(6);
+    HELPER_TEST_EQUALS(m[3],3.0);
+    HELPER_TEST_EQUALS(m[5],0.0);
+    HELPER_TEST_PRINT(v);
+    HELPER_TEST_ASSERT(static_cast<bool>(v==Vector<Real>({1.0,-2.0,3.0})));
+}
+
+void TestVector::test_uninitialised() {
+    Vector<Real> v(17u,Uninitialised());
+    HELPER_TEST_EQUALS(reinterpret_cast<std::uintptr_t>(v.data())%Vector<Real>::ALIGNMENT,0u);
+    for (size_t i=0; i!=v.size(); ++i) { v[i]=Real(2.0*static_cast<double>(i)); }
+    HELPER_TEST_EQUALS(v[16],32.0);
+}
+
+void TestVector::test_fused_arithmetic() {
+    size_t n=1000;
+    Vector<Real> x(n,[](size_t i){return Real(0.5*static_cast<double>(i));});
+    Vector<Real> y(n,[](size_t i){return Real(1.0-static_cast<double>(i));});
+    Real a(2.0);
+
+    size_t count=allocation_count();
+    Vector<Real> r=a*x+y-x/4.0;
+    HELPER_TEST_EQUALS(allocation_count(),count+1u);
+    for (size_t i=0; i!=n; ++i) {
+        HELPER_TEST_ASSERT(same(r[i],Real(2.0*x[i].value()+y[i].value()-x[i].value()/4.0)));
+    }
+
+    count=allocation_count();
+    r=-(x-y)*3.0+(+y);
+    HELPER_TEST_EQUALS(allocation_count(),count);
+    for (size_t i=0; i!=n; ++i) {
+        HELPER_TEST_ASSERT(same(r[i],Real(-(x[i].value()-y[i].value())*3.0+y[i].value())));
+    }
+
+    auto e=x+y;
+    HELPER_TEST_EQUALS(e.size(),n);
+    HELPER_TEST_EQUALS(e[1],x[1]+y[1]);
+
+    try {
+        Vector<Real> s=x+Vector<Real>(3);
+        HELPER_TEST_FAIL("Expected an exception for mismatched sizes");
+    } catch (std::exception&) { }
+}
+
+void TestVector::test_inplace() {
+    Vector<Real> x({1.0,2.0,3.0});
+    Vector<Real> y({0.5,0.5,0.5});
+    size_t count=allocation_count();
+    x+=y;
+    x-=2.0*y;
+    x*=Real(4.0);
+    x/=Real(2.0);
+    x+=x+y;
+    HELPER_TEST_EQUALS(allocation_count(),count);
+    HELPER_TEST_EQUALS(x[0],2.5);
+    HELPER_TEST_EQUALS(x[2],10.5);
+}
+
+void TestVector::test_aliasing() {
+    Vector<Real> x({1.0,2.0,3.0});
+    x=x*2.0+x;
+    HELPER_TEST_EQUALS(x[2],9.0);
+    x=Vector<Real>({1.0,3.5})*2.0;
+    HELPER_TEST_EQUALS(x.size(),2u);
+    HELPER_TEST_EQUALS(x[1],7.0);
+}
+
+void TestVector::test_reductions() {
+    size_t n=1003;
+    Vector<Real> x(n,[](size_t i){return Real(static_cast<double>(i%7)-3.0);});
+    Vector<Real> y(n,[](size_t i){return Real(static_cast<double>(i%5)*0.25);});
+    double d=0.0, s=0.0, m=0.0;
+    for (size_t i=0; i!=n; ++i) {
+        d+=x[i].value()*y[i].value();
+        s+=x[i].value()*x[i].value();
+        m=std::max(m,std::abs(x[i].value()));
+    }
+    HELPER_TEST_EQUALS(dot(x,y),d);
+    HELPER_TEST_EQUALS(norm(x),m);
+    HELPER_TEST_EQUALS(sup_norm(x),m);
+    HELPER_TEST_EQUALS(two_norm(x),std::sqrt(s));
+    HELPER_TEST_EQUALS(dot(x+y,y),dot(Vector<Real>(x+y),y));
+    HELPER_TEST_EQUALS(norm(Vector<Real>()),0.0);
+}
+
+void TestVector::test_join() {
+    Vector<Real> v=join(Vector<Real>({1.0,2.0}),Vector<Real>({3.0}));
+    HELPER_TEST_EQUALS(v.size(),3u);
+    HELPER_TEST_EQUALS(v[2],3.0);
+}
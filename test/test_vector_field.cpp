@@ -0,0 +1,135 @@
+/***************************************************************************
+ *            test_vector_field.cpp
+ *
+ *  Copyright  2023  Luca Geretti
+ *
+ ****************************************************************************/
+
+/*
+ * This file is part of SymboliCore, under the MIT license.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is furnished
+ * to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+ * WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "helper/test.hpp"
+#include "real.hpp"
+#include "vector.hpp"
+#include "matrix.hpp"
+#include "expression.hpp"
+#include "assignment.hpp"
+#include "valuation.hpp"
+#include "space.hpp"
+#include "vector_field.hpp"
+
+using namespace SymboliCore;
+using namespace Helper;
+
+class TestVectorField {
+    RealVariable x,y,z,u;
+    RealSpace spc;
+  public:
+    TestVectorField() : x("x"), y("y"), z("z"), u("u"), spc({x,y,z}) { }
+
+    void test_evaluate() {
+        // The dynamics may be given in any order
+        VectorField vf({dot(z)=Real(2.0)*z, dot(x)=y*sin(x*y), dot(y)=-x+cos(x*y)},spc);
+        HELPER_TEST_PRINT(vf);
+        HELPER_TEST_EQUALS(vf.dimension(),3);
+
+        Valuation<Real> val({x|Real(0.5),y|Real(2.0),z|Real(-1.5)});
+        Vector<Real> f=evaluate(vf,val);
+        HELPER_TEST_EQUALS(f[0],evaluate(y*sin(x*y),val));
+        HELPER_TEST_EQUALS(f[1],evaluate(-x+cos(x*y),val));
+        HELPER_TEST_EQUALS(f[2],Real(-3.0));
+        HELPER_TEST_EQUALS(vf(Vector<Real>({Real(0.5),Real(2.0),Real(-1.5)})),f);
+    }
+
+    void test_jacobian() {
+        VectorField vf({dot(x)=x*y, dot(y)=sin(x)+z, dot(z)=Real(1.0)},spc);
+        HELPER_TEST_PRINT(vf.jacobian_program());
+        HELPER_TEST_EQUALS(vf.jacobian_pattern().number_of_nonzeros(),4);
+
+        Matrix<Real> df=vf.jacobian(Vector<Real>({Real(0.5),Real(2.0),Real(3.0)}));
+        HELPER_TEST_PRINT(df);
+        HELPER_TEST_EQUALS(df[0][0],Real(2.0));
+        HELPER_TEST_EQUALS(df[0][1],Real(0.5));
+        HELPER_TEST_EQUALS(df[0][2],Real(0.0));
+        HELPER_TEST_EQUALS(df[1][0],cos(Real(0.5)));
+        HELPER_TEST_EQUALS(df[1][2],Real(1.0));
+        HELPER_TEST_EQUALS(df[2][0],Real(0.0));
+
+        double xa[3]={0.5,2.0,3.0}; double fa[3]; double va[4]; std::vector<double> wa(vf.workspace_size());
+        vf.sparse_jacobian(xa,fa,va,wa.data());
+        HELPER_TEST_EQUALS(fa[0],1.0);
+        HELPER_TEST_EQUALS(va[0],2.0);
+        HELPER_TEST_EQUALS(va[1],0.5);
+        HELPER_TEST_EQUALS(va[3],1.0);
+    }
+
+    void test_auxiliary() {
+        // The Jacobian follows the chain rule through the auxiliary variables
+        VectorField vf({let(u)=x*y},{dot(x)=sqr(u), dot(y)=u+z, dot(z)=-z},spc);
+        Matrix<Real> df=vf.jacobian(Vector<Real>({Real(3.0),Real(2.0),Real(1.0)}));
+        HELPER_TEST_PRINT(df);
+        HELPER_TEST_EQUALS(df[0][0],Real(24.0));
+        HELPER_TEST_EQUALS(df[0][1],Real(36.0));
+        HELPER_TEST_EQUALS(df[1][0],Real(2.0));
+        HELPER_TEST_EQUALS(df[1][1],Real(3.0));
+        HELPER_TEST_EQUALS(df[1][2],Real(1.0));
+        HELPER_TEST_EQUALS(df[2][2],Real(-1.0));
+        HELPER_TEST_EQUALS(vf(Vector<Real>({Real(3.0),Real(2.0),Real(1.0)}))[0],Real(36.0));
+    }
+
+    void test_batch() {
+        VectorField vf({dot(x)=y, dot(y)=-sin(x)-y/4, dot(z)=x*y*z},spc);
+        size_t const n=500;
+        std::vector<double> xs(3*n), expected(3*n), fs(3*n), wa(vf.workspace_size());
+        for (size_t i=0; i!=3*n; ++i) { xs[i]=0.01*static_cast<double>(i); }
+        for (size_t i=0; i!=n; ++i) { vf(xs.data()+3*i,expected.data()+3*i,wa.data()); }
+        vf.batch(n,xs.data(),fs.data(),2u);
+        HELPER_TEST_ASSERT(fs==expected);
+    }
+
+    void test_errors() {
+        try {
+            VectorField({dot(x)=y, dot(y)=x},spc);
+            HELPER_TEST_FAIL("A state variable without dynamics should fail.");
+        } catch (std::runtime_error const&) { }
+        try {
+            VectorField({dot(x)=y, dot(y)=x, dot(z)=x, dot(x)=z},spc);
+            HELPER_TEST_FAIL("Giving a derivative twice should fail.");
+        } catch (std::runtime_error const&) { }
+        try {
+            VectorField({dot(x)=y, dot(y)=x, dot(z)=x, dot(u)=z},spc);
+            HELPER_TEST_FAIL("A derivative of a variable not in the space should fail.");
+        } catch (std::runtime_error const&) { }
+    }
+
+    void test() {
+        HELPER_TEST_CALL(test_evaluate());
+        HELPER_TEST_CALL(test_jacobian());
+        HELPER_TEST_CALL(test_auxiliary());
+        HELPER_TEST_CALL(test_batch());
+        HELPER_TEST_CALL(test_errors());
+    }
+};
+
+int main() {
+    TestVectorField().test();
+    return HELPER_TEST_FAILURES;
+}